@@ -109,6 +109,8 @@ extern const char *TXT_UNITS_DIST_MILES;
 extern const char *TXT_UNITS_PRECIP_MILLIMETERS;
 extern const char *TXT_UNITS_PRECIP_CENTIMETERS;
 extern const char *TXT_UNITS_PRECIP_INCHES;
+// UNIT SYMBOLS - TIME
+extern const char *TXT_UNITS_TIME_DAYS;
 
 // MISCELLANEOUS MESSAGES
 // Title Case
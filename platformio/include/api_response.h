@@ -22,10 +22,13 @@
 #define __API_RESPONSE_H__
 
 #include <cstdint>
-#include <Arduino.h>
-#include <ArduinoJson.h>
-#include <HTTPClient.h>
-#include <WiFi.h>
+// the forecast structs are also used by host unit tests, without Arduino
+#ifdef ARDUINO
+  #include <Arduino.h>
+  #include <ArduinoJson.h>
+  #include <HTTPClient.h>
+  #include <WiFi.h>
+#endif
 
 #define OM_NUM_HOURLY  48
 #define OM_NUM_DAILY    8
@@ -77,6 +80,7 @@ typedef struct om_daily
   float   uvi;            // uv_index_max
 } om_daily_t;
 
+#ifdef ARDUINO
 // Combined forecast response
 typedef struct om_resp_forecast
 {
@@ -88,6 +92,7 @@ typedef struct om_resp_forecast
   om_hourly_t   hourly[OM_NUM_HOURLY];
   om_daily_t    daily[OM_NUM_DAILY];
 } om_resp_forecast_t;
+#endif
 
 // Cache-friendly forecast struct for RTC memory storage.
 // Identical to om_resp_forecast_t but omits String timezone (heap-allocated,
@@ -108,11 +113,13 @@ typedef struct om_resp_air_quality
   int     aqi;            // US AQI value (0-500)
 } om_resp_air_quality_t;
 
+#ifdef ARDUINO
 // Deserialization functions
 DeserializationError deserializeForecast(const String &json,
                                          om_resp_forecast_t &r);
 DeserializationError deserializeAirQuality(const String &json,
                                            om_resp_air_quality_t &r);
+#endif
 
 // Helper to parse ISO8601 datetime to Unix timestamp
 int64_t parseISO8601(const char *datetime);
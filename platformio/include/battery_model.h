@@ -0,0 +1,69 @@
+/* Battery discharge model declarations for esp32-weather-epd.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __BATTERY_MODEL_H__
+#define __BATTERY_MODEL_H__
+
+#include <cstddef>
+#include <cstdint>
+
+#define BAT_HISTORY_SIZE 48
+
+// Ordered from healthiest to most depleted.
+typedef enum battery_level
+{
+  BATTERY_OK,
+  BATTERY_LOW,
+  BATTERY_VERY_LOW,
+  BATTERY_CRIT_LOW
+} battery_level_t;
+
+// One point of the discharge history.
+// Note: charge is the charge consumed since the previous sample, not a running
+//       total, so that merging samples during compaction is lossless.
+typedef struct bat_sample
+{
+  uint32_t dt;            // Unix timestamp
+  uint16_t mv;            // battery voltage (millivolts)
+  uint16_t charge;        // charge consumed since previous sample (10μAh)
+} bat_sample_t;
+
+// Discharge history, stored as a single blob in NVS. (~390 bytes)
+typedef struct bat_history
+{
+  uint16_t     count;
+  bat_sample_t samples[BAT_HISTORY_SIZE];
+} bat_history_t;
+
+typedef struct bat_estimate
+{
+  float mv_per_mah;       // discharge slope (millivolts per mAh, negative)
+  float mah_per_day;      // recent consumption rate (mAh per day)
+  float mah_left;         // charge remaining until the critical voltage (mAh)
+  float days_left;        // predicted time until the critical voltage (days)
+} bat_estimate_t;
+
+void batHistoryAppend(bat_history_t &h, uint32_t dt, uint16_t mv,
+                      float chargeMah);
+void batHistoryCompact(bat_history_t &h);
+bool batEstimate(const bat_history_t &h, uint32_t critMv, bat_estimate_t &e);
+uint32_t filterAdcSamples(uint16_t *samples, size_t n);
+battery_level_t batLevel(uint32_t v, battery_level_t prevLevel,
+                         const uint32_t thresholds[BATTERY_CRIT_LOW + 1],
+                         uint32_t hysteresis);
+
+#endif
@@ -0,0 +1,40 @@
+/* Battery sensing utility declarations for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __BATTERY_UTILS_H__
+#define __BATTERY_UTILS_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <time.h>
+#include <Preferences.h>
+#include "battery_model.h"
+#include "energy_model.h"
+
+uint32_t readBatteryVoltage();
+battery_level_t getBatteryLevel(uint32_t v, battery_level_t prevLevel,
+                                uint32_t hysteresis);
+void updateBatteryModel(Preferences &prefs, uint32_t v, time_t now);
+bool getBatteryEstimate(bat_estimate_t &e);
+void beginEnergyPhase(energy_phase_t phase);
+void endEnergyPhase(energy_phase_t phase);
+void accumulateBatteryCharge(unsigned long awakeMs, uint64_t sleepSeconds,
+                             bool interimWake);
+int getSleepInterval();
+
+#endif
@@ -0,0 +1,38 @@
+/* Glyph and bitmap blitting declarations for esp32-weather-epd.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __BLIT_H__
+#define __BLIT_H__
+
+#include <cstdint>
+#include <gfxfont.h>
+
+uint8_t blitGlyph(uint8_t *plane, int16_t w, int16_t h, const GFXfont *font,
+                  uint8_t c, int16_t x, int16_t y, bool value);
+void blitInvertedBitmap(uint8_t *plane, int16_t w, int16_t h,
+                        const uint8_t *bitmap, int16_t x, int16_t y,
+                        int16_t bw, int16_t bh, bool value);
+void fillPattern(uint8_t *plane, int16_t w, int16_t h,
+                 int16_t x, int16_t y, int16_t pw, int16_t ph,
+                 const uint8_t pattern[8], bool value);
+void fillVLine(uint8_t *plane, int16_t w, int16_t h,
+               int16_t x, int16_t y, int16_t len, bool value);
+void drawDottedHLine(uint8_t *plane, int16_t w, int16_t h,
+                     int16_t x0, int16_t x1, int16_t y, uint8_t step,
+                     bool value);
+
+#endif
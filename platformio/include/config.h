@@ -51,6 +51,13 @@
 // add a small delay before reading it's value. 300ms seems to work for most people
 // #define SENSOR_INIT_DELAY_MS 300
 
+// INDOOR HISTORY
+//   Every indoor reading is appended to a ring buffer in RTC memory so the
+//   indoor min/max and trend are available without extra sensor time. History
+//   survives deep sleep, but is lost on power-off/reset. Each sample uses 8
+//   bytes of RTC memory. Set to 0 to disable.
+#define INDOOR_HISTORY_SIZE 48
+
 // 3 COLOR E-INK ACCENT COLOR
 // Defines the 3rd color to be used when a 3+ color display is selected.
 #if defined(DISP_3C_B) || defined(DISP_7C_F)
@@ -184,7 +191,7 @@
 //  4   5
 //  6   7
 //  8   9
-// if DISP_BW_V1 is used, 6,7,8,9 are not available
+// if DISP_BW_V1 is used, 6,7,8,9 are not available (see layout.h)
 #define POS_SUNRISE     0
 #define POS_SUNSET      1
 #define POS_WIND        2
@@ -260,8 +267,12 @@
 // STATUS BAR EXTRAS
 //   Extra information that can be displayed on the status bar. Set to 1 to
 //   enable.
+//   BAT_DAYS_LEFT shows the predicted days until the battery reaches
+//   CRIT_LOW_BATTERY_VOLTAGE. It appears once about a day of discharge history
+//   has been collected.
 #define STATUS_BAR_EXTRAS_BAT_PERCENTAGE 1
 #define STATUS_BAR_EXTRAS_BAT_VOLTAGE    0
+#define STATUS_BAR_EXTRAS_BAT_DAYS_LEFT  1
 #define STATUS_BAR_EXTRAS_WIFI_STRENGTH  1
 #define STATUS_BAR_EXTRAS_WIFI_RSSI      0
 
@@ -271,6 +282,96 @@
 //   If you wish to disable battery monitoring set this macro to 0.
 #define BATTERY_MONITORING 1
 
+// ADAPTIVE SLEEP
+//   The charge used by each wake is estimated from how long WiFi and the
+//   display were powered. When enabled, the sleep interval is lengthened or
+//   shortened to meet BATTERY_LIFE_TARGET, within SLEEP_DURATION_MIN and
+//   SLEEP_DURATION_MAX. Bed time is still honoured. Requires BATTERY_MONITORING.
+//   Targets and currents can be configured in config.cpp.
+//   Set to 1 to enable, 0 to disable.
+#define ADAPTIVE_SLEEP 0
+
+// WAKE PLANNER
+//   When enabled, the next wake is planned from the displayed forecast instead
+//   of waking every sleep interval. The display is updated when precipitation
+//   starts, the weather icon changes, at sunrise and sunset, or when the
+//   temperature drifts. Otherwise it is updated on the hour, once the sleep
+//   interval (SLEEP_DURATION, or the adaptive interval) has passed. Wakes are
+//   never closer than SLEEP_DURATION_MIN. Bed time is still honoured.
+//   Set to 1 to enable, 0 to disable.
+#define WAKE_PLANNER 0
+
+// INTERIM WAKES
+//   When enabled, the display also wakes every INTERIM_WAKE_INTERVAL between
+//   full updates. These wakes skip WiFi and only redraw the indoor temperature,
+//   indoor humidity and status bar using partial refresh. Every
+//   INTERIM_FULL_REFRESH_CYCLES partial refreshes the wake is a full update
+//   instead, which clears ghosting. Only panels with fast partial refresh
+//   (DISP_BW_V2, DISP_BW_V1) redraw, others only record the indoor history.
+//   Set to 1 to enable, 0 to disable.
+#define INTERIM_WAKES 0
+
+// DIFFERENTIAL REFRESH
+//   When enabled, each update is compared with the frame already on the panel
+//   and only the changed parts are refreshed, using partial refresh. A full
+//   refresh is still done periodically to clear ghosting, and when much of the
+//   display changed (see config.cpp). Only black/white panels (DISP_BW_V2,
+//   DISP_BW_V1) support this, it is ignored otherwise. Uses ~1.5KB of RTC
+//   memory, and the frame on the panel is kept compressed in flash (LittleFS),
+//   as the panel loses its copy when powered off.
+//   Set to 1 to enable, 0 to disable.
+#define FRAME_DIFF 0
+
+// DISPLAY LIST
+//   Panels that don't fit a whole frame in memory (DISP_3C_B, DISP_7C_F) are
+//   drawn in pages, 2 and 4 respectively. When enabled, the frame is drawn once
+//   into a list of draw commands, and each page only replays the commands
+//   that intersect it, instead of the whole frame being drawn for every page.
+//   Uses ~14KB of heap while drawing. Ignored for other panels.
+//   Set to 1 to enable, 0 to disable.
+#define DISPLAY_LIST 0
+
+// PSRAM FRAME
+//   When enabled and the board has PSRAM, panels that are otherwise drawn in
+//   pages (DISP_3C_B, DISP_7C_F) are drawn once into a full frame in PSRAM
+//   (96KB and 192KB respectively), which is written to the panel at once.
+//   Without PSRAM, found at runtime, they are drawn in pages (see
+//   DISPLAY_LIST). PSRAM is only used when the board is built with it enabled
+//   (-DBOARD_HAS_PSRAM). Ignored for other panels.
+//   Set to 1 to enable, 0 to disable.
+#define PSRAM_FRAME 0
+
+// WIDGET CACHE
+//   When enabled, widgets that change only a few times a day (the current
+//   weather icon with the temperature, and the five day forecast) are stored
+//   in flash as rendered pixels, together with the values they show. While
+//   those values stay the same the stored pixels are copied into the frame
+//   instead of drawing the widget again. Uses the flash file system
+//   (LittleFS), which is formatted on first use. Requires FRAME_DIFF, ignored
+//   for panels that don't support it.
+//   Set to 1 to enable, 0 to disable.
+#define WIDGET_CACHE 0
+
+// BACKGROUND CACHE
+//   The parts of the dashboard that are the same on every update (icons and
+//   labels of the current conditions, graph axes and gridlines) are drawn
+//   first, as a background. When enabled, the background is rendered once and
+//   stored compressed in flash (LittleFS), then copied into later frames. It is
+//   rendered again after a firmware update. Requires FRAME_DIFF, ignored for
+//   panels that don't support it.
+//   Set to 1 to enable, 0 to disable.
+#define BACKGROUND_CACHE 0
+
+// SKIP UNCHANGED UPDATES
+//   When enabled, everything an update would display is first reduced to the
+//   precision it is shown at (rounded temperatures, icons, graph coordinates,
+//   strings) and compared with what the panel already shows. If nothing
+//   visible changed, the display is neither drawn nor powered. The last refresh
+//   time in the status bar keeps showing when the display last changed. A
+//   refresh is still forced after UNCHANGED_DISPLAY_MAX_AGE (see config.cpp).
+//   Set to 1 to enable, 0 to disable.
+#define SKIP_UNCHANGED_DISPLAY 0
+
 // STALE DATA FALLBACK
 //   When enabled, if an API call fails after all retries are exhausted, the
 //   display will show the last successfully fetched weather data instead of a
@@ -332,8 +433,23 @@ extern const uint32_t VERY_LOW_BATTERY_VOLTAGE;
 extern const uint32_t CRIT_LOW_BATTERY_VOLTAGE;
 extern const unsigned long LOW_BATTERY_SLEEP_INTERVAL;
 extern const unsigned long VERY_LOW_BATTERY_SLEEP_INTERVAL;
+extern const uint32_t BATTERY_VOLTAGE_HYSTERESIS;
+extern const float BATTERY_ACTIVE_CURRENT;
+extern const float BATTERY_WIFI_CURRENT;
+extern const float BATTERY_DISPLAY_CURRENT;
+extern const float BATTERY_SLEEP_CURRENT;
 extern const uint32_t MAX_BATTERY_VOLTAGE;
 extern const uint32_t MIN_BATTERY_VOLTAGE;
+extern const float BATTERY_CAPACITY;
+extern const int BATTERY_LIFE_TARGET;
+extern const int SLEEP_DURATION_MIN;
+extern const int SLEEP_DURATION_MAX;
+extern const int SLEEP_DURATION_STEP;
+extern const int INTERIM_WAKE_INTERVAL;
+extern const int INTERIM_FULL_REFRESH_CYCLES;
+extern const float FRAME_DIFF_MAX_AREA;
+extern const int FRAME_DIFF_FULL_REFRESH_CYCLES;
+extern const int UNCHANGED_DISPLAY_MAX_AGE;
 
 // CONFIG VALIDATION - DO NOT MODIFY
 #if !(  defined(DISP_BW_V2)  \
@@ -350,6 +466,9 @@ extern const uint32_t MIN_BATTERY_VOLTAGE;
       ^ defined(SENSOR_BME680))
   #error Invalid configuration. Exactly one sensor must be selected.
 #endif
+#if !(defined(INDOOR_HISTORY_SIZE)) || INDOOR_HISTORY_SIZE < 0
+  #error Invalid configuration. INDOOR_HISTORY_SIZE must be 0 or greater.
+#endif
 #if !(defined(LOCALE))
   #error Invalid configuration. Locale not selected.
 #endif
@@ -430,6 +549,42 @@ extern const uint32_t MIN_BATTERY_VOLTAGE;
 #if !(defined(BATTERY_MONITORING))
   #error Invalid configuration. BATTERY_MONITORING not defined.
 #endif
+#if !(defined(ADAPTIVE_SLEEP))
+  #error Invalid configuration. ADAPTIVE_SLEEP not defined.
+#endif
+#if ADAPTIVE_SLEEP && !BATTERY_MONITORING
+  #error Invalid configuration. ADAPTIVE_SLEEP requires BATTERY_MONITORING.
+#endif
+#if !(defined(WAKE_PLANNER))
+  #error Invalid configuration. WAKE_PLANNER not defined.
+#endif
+#if !(defined(INTERIM_WAKES))
+  #error Invalid configuration. INTERIM_WAKES not defined.
+#endif
+#if !(defined(FRAME_DIFF))
+  #error Invalid configuration. FRAME_DIFF not defined.
+#endif
+#if !(defined(DISPLAY_LIST))
+  #error Invalid configuration. DISPLAY_LIST not defined.
+#endif
+#if !(defined(PSRAM_FRAME))
+  #error Invalid configuration. PSRAM_FRAME not defined.
+#endif
+#if !(defined(WIDGET_CACHE))
+  #error Invalid configuration. WIDGET_CACHE not defined.
+#endif
+#if WIDGET_CACHE && !FRAME_DIFF
+  #error Invalid configuration. WIDGET_CACHE requires FRAME_DIFF.
+#endif
+#if !(defined(BACKGROUND_CACHE))
+  #error Invalid configuration. BACKGROUND_CACHE not defined.
+#endif
+#if BACKGROUND_CACHE && !FRAME_DIFF
+  #error Invalid configuration. BACKGROUND_CACHE requires FRAME_DIFF.
+#endif
+#if !(defined(SKIP_UNCHANGED_DISPLAY))
+  #error Invalid configuration. SKIP_UNCHANGED_DISPLAY not defined.
+#endif
 #if !(defined(DEBUG_LEVEL))
   #error Invalid configuration. DEBUG_LEVEL not defined.
 #endif
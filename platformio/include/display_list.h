@@ -0,0 +1,73 @@
+/* Display list declarations for esp32-weather-epd.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __DISPLAY_LIST_H__
+#define __DISPLAY_LIST_H__
+
+#include <cstddef>
+#include <cstdint>
+
+// Capacity of a display list. A typical dashboard needs ~350 commands and
+// ~1KB of text.
+#define DL_MAX_CMDS 512
+#define DL_MAX_TEXT 2048
+
+typedef enum dl_op
+{
+  DL_OP_PIXELS,           // lattice of pixels, rows x cols
+  DL_OP_LINE,
+  DL_OP_BITMAP,           // inverted 1bpp bitmap
+  DL_OP_TEXT              // run of characters in one font
+} dl_op_t;
+
+typedef struct dl_cmd
+{
+  uint8_t     op;
+  uint16_t    color;
+  int16_t     y0;         // vertical extent (inclusive), pages are full width
+  int16_t     y1;
+  // PIXELS: x, y, x step, columns, y step, rows
+  // LINE  : x0, y0, x1, y1
+  // BITMAP: x, y, w, h
+  // TEXT  : cursor x, cursor y, text offset, text length
+  int16_t     a, b, c, d, e, f;
+  const void *ptr;        // BITMAP: bitmap, TEXT: font
+} dl_cmd_t;
+
+typedef struct display_list
+{
+  dl_cmd_t *cmds;
+  char     *text;
+  uint16_t  num_cmds;
+  uint16_t  text_len;
+  bool      overflow;     // something did not fit, the list is incomplete
+} display_list_t;
+
+size_t dlMemSize();
+void dlInit(display_list_t &dl, void *mem);
+void dlPixel(display_list_t &dl, int16_t x, int16_t y, uint16_t color);
+void dlLine(display_list_t &dl, int16_t x0, int16_t y0,
+            int16_t x1, int16_t y1, uint16_t color);
+void dlBitmap(display_list_t &dl, const uint8_t *bitmap,
+              int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+void dlText(display_list_t &dl, const void *font, int16_t x, int16_t y,
+            const char *text, uint16_t len, int16_t y0, int16_t y1,
+            uint16_t color);
+void dlFinish(display_list_t &dl);
+bool dlIntersects(const dl_cmd_t &cmd, int16_t y0, int16_t y1);
+
+#endif
@@ -0,0 +1,47 @@
+/* Displayed state declarations for esp32-weather-epd.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __DISPLAY_STATE_H__
+#define __DISPLAY_STATE_H__
+
+#include <cstdint>
+#include <time.h>
+#include <Arduino.h>
+#include "api_response.h"
+#include "render_model.h"
+#include "units.h"
+
+uint32_t hashDisplayState(const render_model_t &model,
+                          const om_current_t &current,
+                          const om_hourly_t *hourly, const om_daily_t *daily,
+                          const om_resp_air_quality_t &air_quality,
+                          float inTemp, float inHumidity,
+                          const String &city, const String &date,
+                          const String &statusStr, int rssi,
+                          uint32_t batVoltage, float batDaysLeft,
+                          const tm &timeInfo);
+template<class Temp = TempUnits>
+uint32_t hashCurrentHeaderState(const render_model_t &model,
+                                const om_current_t &current);
+template<class Temp = TempUnits, class Precip = DailyPrecipUnits>
+uint32_t hashForecastState(const render_model_t &model,
+                           const om_daily_t *daily, int wday);
+bool isDisplayCurrent(uint32_t hash, int64_t now);
+void setDisplayState(uint32_t hash, int64_t now);
+void invalidateDisplayState();
+
+#endif
@@ -0,0 +1,71 @@
+/* Energy accounting declarations for esp32-weather-epd.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __ENERGY_MODEL_H__
+#define __ENERGY_MODEL_H__
+
+#include <cstdint>
+
+// Phases of a wake with a distinct current draw. Time awake outside of any
+// phase is charged at the active (CPU only) current.
+typedef enum energy_phase
+{
+  ENERGY_PHASE_WIFI,
+  ENERGY_PHASE_DISPLAY,
+  ENERGY_PHASE_COUNT
+} energy_phase_t;
+
+// Measured durations of a single wake.
+typedef struct energy_trace
+{
+  uint32_t awake_ms;
+  uint32_t phase_ms[ENERGY_PHASE_COUNT];
+} energy_trace_t;
+
+typedef struct energy_currents
+{
+  float active;                    // CPU awake, outside of any phase (mA)
+  float phase[ENERGY_PHASE_COUNT]; // (mA)
+  float sleep;                     // deep sleep (mA)
+} energy_currents_t;
+
+typedef struct energy_policy
+{
+  float daily_mah;      // charge that may be used per day to meet the target
+  float sleep_ma;       // deep sleep current (mA)
+  int   active_minutes; // minutes per day outside of bed time
+  int   min_interval;   // (minutes)
+  int   max_interval;   // (minutes)
+  int   step;           // intervals are rounded up to a multiple of this
+} energy_policy_t;
+
+// Rolling energy budget, kept in RTC memory. (8 bytes)
+typedef struct energy_budget
+{
+  float wake_mah;       // smoothed charge per wake (mAh), 0 if unknown
+  float balance_mah;    // charge saved (+) or overspent (-) against the target
+} energy_budget_t;
+
+float energyWakeCharge(const energy_trace_t &t, const energy_currents_t &c);
+void energyBudgetBalance(energy_budget_t &b, const energy_policy_t &p,
+                         float mah, uint32_t cycleSeconds);
+void energyBudgetUpdate(energy_budget_t &b, const energy_policy_t &p,
+                        float wakeMah, float sleepMah, uint32_t cycleSeconds);
+int energySleepInterval(const energy_budget_t &b, const energy_policy_t &p,
+                        int fallback);
+
+#endif
@@ -0,0 +1,26 @@
+/* Single precision math helpers for esp32-weather-epd.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __FLOAT_MATH_H__
+#define __FLOAT_MATH_H__
+
+float powerOfTen(int exponent);
+float roundDecimals(float value, int decimals);
+int ceilDiv(int numerator, int denominator);
+int roundDiv(int numerator, int denominator);
+
+#endif
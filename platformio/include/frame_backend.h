@@ -0,0 +1,588 @@
+/* Compile-time frame buffer drawing backends for esp32-weather-epd.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __FRAME_BACKEND_H__
+#define __FRAME_BACKEND_H__
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <gfxfont.h>
+#include <GxEPD2.h>
+#include "blit.h"
+
+/* Adafruit_GFX primitives drawn straight into a frame buffer of a W x H panel
+ * at rotation R, without a virtual call per pixel.
+ *
+ * The panel size and rotation are template parameters, so clipping and the
+ * rotation compile down to constants. Derived (CRTP) stores the pixels in the
+ * format of its panel and provides:
+ *   setPixel(x, y, color)     one pixel, in panel coordinates and in range
+ *   fillSpan(x0, x1, y, color) pixels x0 to x1 of row y, in panel coordinates
+ *   fillColumn(x, y0, y1, color) pixels y0 to y1 of column x, likewise
+ * and may hide drawInvertedBitmap(), drawGlyph(), fillPattern() and
+ * drawDottedHLine() with faster versions for its format.
+ *
+ * Each primitive sets the same pixels as its Adafruit_GFX counterpart (size 1
+ * text, transparent background).
+ */
+template<class Derived, int16_t W, int16_t H, uint8_t R = 0>
+class FrameBackend
+{
+public:
+  static_assert(R < 4, "rotation must be 0 to 3");
+  static constexpr int16_t width  = (R & 1) ? H : W;
+  static constexpr int16_t height = (R & 1) ? W : H;
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color)
+  {
+    if (x < 0 || y < 0 || x >= width || y >= height)
+    {
+      return;
+    }
+    toPanel(x, y);
+    self().setPixel(x, y, color);
+  }
+
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+  {
+    if (y < 0 || y >= height)
+    {
+      return;
+    }
+    const int16_t x0 = std::max<int16_t>(x, 0);
+    const int16_t x1 = std::min<int16_t>(x + w, width) - 1;
+    if (x0 <= x1)
+    {
+      rowSpan(x0, x1, y, color);
+    }
+  }
+
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+  {
+    if (x < 0 || x >= width)
+    {
+      return;
+    }
+    const int16_t y0 = std::max<int16_t>(y, 0);
+    const int16_t y1 = std::min<int16_t>(y + h, height) - 1;
+    if (y0 <= y1)
+    {
+      columnSpan(x, y0, y1, color);
+    }
+  }
+
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+  {
+    const int16_t x0 = std::max<int16_t>(x, 0);
+    const int16_t x1 = std::min<int16_t>(x + w, width) - 1;
+    const int16_t y0 = std::max<int16_t>(y, 0);
+    const int16_t y1 = std::min<int16_t>(y + h, height) - 1;
+    if (x0 > x1)
+    {
+      return;
+    }
+    for (int16_t r = y0; r <= y1; ++r)
+    {
+      rowSpan(x0, x1, r, color);
+    }
+  }
+
+  void fillScreen(uint16_t color)
+  {
+    fillRect(0, 0, width, height, color);
+  }
+
+  // Bresenham as in Adafruit_GFX::writeLine(), horizontal and vertical lines
+  // as spans.
+  void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color)
+  {
+    if (x0 == x1)
+    {
+      drawFastVLine(x0, std::min(y0, y1), std::abs(y1 - y0) + 1, color);
+      return;
+    }
+    if (y0 == y1)
+    {
+      drawFastHLine(std::min(x0, x1), y0, std::abs(x1 - x0) + 1, color);
+      return;
+    }
+    const bool steep = std::abs(y1 - y0) > std::abs(x1 - x0);
+    if (steep)
+    {
+      std::swap(x0, y0);
+      std::swap(x1, y1);
+    }
+    if (x0 > x1)
+    {
+      std::swap(x0, x1);
+      std::swap(y0, y1);
+    }
+    const int16_t dx = x1 - x0;
+    const int16_t dy = std::abs(y1 - y0);
+    const int16_t ystep = (y0 < y1) ? 1 : -1;
+    int16_t err = dx / 2;
+    for (; x0 <= x1; ++x0)
+    {
+      if (steep)
+      {
+        drawPixel(y0, x0, color);
+      }
+      else
+      {
+        drawPixel(x0, y0, color);
+      }
+      err -= dy;
+      if (err < 0)
+      {
+        y0 += ystep;
+        err += dx;
+      }
+    }
+  }
+
+  // Sets the pixels of a w x h bitmap that are 0 (rows padded to whole bytes,
+  // MSB first) to color, as GxEPD2 drawInvertedBitmap().
+  void drawInvertedBitmap(int16_t x, int16_t y, const uint8_t *bitmap,
+                          int16_t w, int16_t h, uint16_t color)
+  {
+    const int16_t stride = (w + 7) / 8;
+    for (int16_t r = 0; r < h; ++r)
+    {
+      for (int16_t c = 0; c < w; ++c)
+      {
+        if (!(bitmap[r * stride + c / 8] & (0x80 >> (c & 7))))
+        {
+          drawPixel(x + c, y + r, color);
+        }
+      }
+    }
+  }
+
+  // Draws glyph c of font with the cursor at (x, y), as drawChar(). Returns
+  // its advance, 0 if font doesn't have c.
+  uint8_t drawGlyph(const GFXfont *font, uint8_t c, int16_t x, int16_t y,
+                    uint16_t color)
+  {
+    if (c < font->first || c > font->last)
+    {
+      return 0;
+    }
+    const GFXglyph &g = font->glyph[c - font->first];
+    const uint8_t *bitmap = font->bitmap + g.bitmapOffset;
+    uint8_t bits = 0;
+    uint16_t bit = 0;
+    for (int16_t r = 0; r < g.height; ++r)
+    {
+      for (int16_t col = 0; col < g.width; ++col, ++bit)
+      {
+        if (!(bit & 7))
+        {
+          bits = *bitmap++;
+        }
+        if (bits & 0x80)
+        {
+          drawPixel(x + g.xOffset + col, y + g.yOffset + r, color);
+        }
+        bits <<= 1;
+      }
+    }
+    return g.xAdvance;
+  }
+
+  // Sets the pixels of the rectangle that are 1 in the 8x8 pattern to color
+  // (see blit.h).
+  void fillPattern(int16_t x, int16_t y, int16_t w, int16_t h,
+                   const uint8_t pattern[8], uint16_t color)
+  {
+    for (int16_t py = y; py < y + h; ++py)
+    {
+      const uint8_t bits = pattern[py & 7];
+      for (int16_t px = x; bits != 0 && px < x + w; ++px)
+      {
+        if (bits & (0x80 >> (px & 7)))
+        {
+          drawPixel(px, py, color);
+        }
+      }
+    }
+  }
+
+  // Draws every step-th pixel from x0 to x1 of row y.
+  void drawDottedHLine(int16_t x0, int16_t x1, int16_t y, uint8_t step,
+                       uint16_t color)
+  {
+    for (int16_t x = x0; x <= x1; x += step)
+    {
+      drawPixel(x, y, color);
+    }
+  }
+
+protected:
+  Derived &self()
+  {
+    return static_cast<Derived &>(*this);
+  }
+
+  // Maps (x, y) to panel coordinates, as Adafruit_GFX rotates them.
+  static void toPanel(int16_t &x, int16_t &y)
+  {
+    const int16_t t = x;
+    switch (R)
+    {
+    case 1: x = W - 1 - y; y = t;         break;
+    case 2: x = W - 1 - x; y = H - 1 - y; break;
+    case 3: x = y;         y = H - 1 - t; break;
+    default:                              break;
+    }
+  }
+
+  // Pixels x0 to x1 of row y, clipped already. A row is a row or a column of
+  // the panel, depending on the rotation.
+  void rowSpan(int16_t x0, int16_t x1, int16_t y, uint16_t color)
+  {
+    switch (R)
+    {
+    case 1: self().fillColumn(W - 1 - y, x0, x1, color);                 break;
+    case 2: self().fillSpan(W - 1 - x1, W - 1 - x0, H - 1 - y, color);   break;
+    case 3: self().fillColumn(y, H - 1 - x1, H - 1 - x0, color);         break;
+    default: self().fillSpan(x0, x1, y, color);                          break;
+    }
+  }
+
+  // Pixels y0 to y1 of column x, clipped already.
+  void columnSpan(int16_t x, int16_t y0, int16_t y1, uint16_t color)
+  {
+    switch (R)
+    {
+    case 1: self().fillSpan(W - 1 - y1, W - 1 - y0, x, color);           break;
+    case 2: self().fillColumn(W - 1 - x, H - 1 - y1, H - 1 - y0, color); break;
+    case 3: self().fillSpan(y0, y1, H - 1 - x, color);                   break;
+    default: self().fillColumn(x, y0, y1, color);                        break;
+    }
+  }
+};
+
+/* Pixels x0 to x1 of row y set to value in a 1bpp plane of W pixels wide (W a
+ * multiple of 8, MSB first), whole bytes at once.
+ */
+template<int16_t W>
+inline void fillPlaneSpan(uint8_t *plane, int16_t x0, int16_t x1, int16_t y,
+                          bool value)
+{
+  uint8_t *row = plane + y * (W / 8);
+  const int16_t b0 = x0 >> 3;
+  const int16_t b1 = x1 >> 3;
+  uint8_t first = 0xFF >> (x0 & 7);
+  const uint8_t last = 0xFF << (7 - (x1 & 7));
+  if (b0 == b1)
+  {
+    first &= last;
+  }
+  row[b0] = value ? (row[b0] | first) : (row[b0] & ~first);
+  if (b0 == b1)
+  {
+    return;
+  }
+  if (b1 - b0 > 1)
+  {
+    memset(row + b0 + 1, value ? 0xFF : 0x00, b1 - b0 - 1);
+  }
+  row[b1] = value ? (row[b1] | last) : (row[b1] & ~last);
+}
+
+/* Pixels y0 to y1 of column x set to value in a 1bpp plane (see above).
+ */
+template<int16_t W>
+inline void fillPlaneColumn(uint8_t *plane, int16_t x, int16_t y0, int16_t y1,
+                            bool value)
+{
+  const uint8_t mask = 0x80 >> (x & 7);
+  uint8_t *dst = plane + y0 * (W / 8) + (x >> 3);
+  for (int16_t r = y0; r <= y1; ++r, dst += W / 8)
+  {
+    *dst = value ? (*dst | mask) : (*dst & ~mask);
+  }
+}
+
+/* Black and white frame, 1bpp, white = 1. The layout of the GxEPD2_BW buffer.
+ */
+template<int16_t W, int16_t H, uint8_t R = 0>
+class MonoFrame : public FrameBackend<MonoFrame<W, H, R>, W, H, R>
+{
+  using Base = FrameBackend<MonoFrame<W, H, R>, W, H, R>;
+  friend Base;
+
+public:
+  static constexpr size_t size = (W / 8) * H;
+
+  explicit MonoFrame(uint8_t *plane) : plane(plane) {}
+
+  void fillScreen(uint16_t color)
+  {
+    memset(plane, ink(color) ? 0xFF : 0x00, size);
+  }
+
+  void drawInvertedBitmap(int16_t x, int16_t y, const uint8_t *bitmap,
+                          int16_t w, int16_t h, uint16_t color)
+  {
+    if (R != 0)
+    {
+      Base::drawInvertedBitmap(x, y, bitmap, w, h, color);
+      return;
+    }
+    blitInvertedBitmap(plane, W, H, bitmap, x, y, w, h, ink(color));
+  }
+
+  uint8_t drawGlyph(const GFXfont *font, uint8_t c, int16_t x, int16_t y,
+                    uint16_t color)
+  {
+    if (R != 0)
+    {
+      return Base::drawGlyph(font, c, x, y, color);
+    }
+    return blitGlyph(plane, W, H, font, c, x, y, ink(color));
+  }
+
+  void fillPattern(int16_t x, int16_t y, int16_t w, int16_t h,
+                   const uint8_t pattern[8], uint16_t color)
+  {
+    if (R != 0)
+    {
+      Base::fillPattern(x, y, w, h, pattern, color);
+      return;
+    }
+    ::fillPattern(plane, W, H, x, y, w, h, pattern, ink(color));
+  }
+
+  void drawDottedHLine(int16_t x0, int16_t x1, int16_t y, uint8_t step,
+                       uint16_t color)
+  {
+    if (R != 0)
+    {
+      Base::drawDottedHLine(x0, x1, y, step, color);
+      return;
+    }
+    ::drawDottedHLine(plane, W, H, x0, x1, y, step, ink(color));
+  }
+
+private:
+  uint8_t *plane;
+
+  // GxEPD2_BW draws every color but white as black
+  static bool ink(uint16_t color)
+  {
+    return color == GxEPD_WHITE;
+  }
+
+  void setPixel(int16_t x, int16_t y, uint16_t color)
+  {
+    uint8_t &b = plane[y * (W / 8) + x / 8];
+    const uint8_t mask = 0x80 >> (x & 7);
+    b = ink(color) ? (b | mask) : (b & ~mask);
+  }
+
+  void fillSpan(int16_t x0, int16_t x1, int16_t y, uint16_t color)
+  {
+    fillPlaneSpan<W>(plane, x0, x1, y, ink(color));
+  }
+
+  void fillColumn(int16_t x, int16_t y0, int16_t y1, uint16_t color)
+  {
+    fillPlaneColumn<W>(plane, x, y0, y1, ink(color));
+  }
+};
+
+/* Black, white and red (or yellow) frame: a black plane followed by a color
+ * plane, 1bpp each, 1 = white. The layout GxEPD2_3C writes to the panel.
+ */
+template<int16_t W, int16_t H, uint8_t R = 0>
+class Color3Frame : public FrameBackend<Color3Frame<W, H, R>, W, H, R>
+{
+  using Base = FrameBackend<Color3Frame<W, H, R>, W, H, R>;
+  friend Base;
+
+public:
+  static constexpr size_t size = 2 * (W / 8) * H;
+
+  explicit Color3Frame(uint8_t *frame) : black(frame), color(frame + size / 2)
+  {}
+
+  void fillScreen(uint16_t c)
+  {
+    memset(black, blackInk(c) ? 0xFF : 0x00, size / 2);
+    memset(color, colorInk(c) ? 0xFF : 0x00, size / 2);
+  }
+
+  void drawInvertedBitmap(int16_t x, int16_t y, const uint8_t *bitmap,
+                          int16_t w, int16_t h, uint16_t c)
+  {
+    if (R != 0)
+    {
+      Base::drawInvertedBitmap(x, y, bitmap, w, h, c);
+      return;
+    }
+    blitInvertedBitmap(black, W, H, bitmap, x, y, w, h, blackInk(c));
+    blitInvertedBitmap(color, W, H, bitmap, x, y, w, h, colorInk(c));
+  }
+
+  uint8_t drawGlyph(const GFXfont *font, uint8_t ch, int16_t x, int16_t y,
+                    uint16_t c)
+  {
+    if (R != 0)
+    {
+      return Base::drawGlyph(font, ch, x, y, c);
+    }
+    blitGlyph(black, W, H, font, ch, x, y, blackInk(c));
+    return blitGlyph(color, W, H, font, ch, x, y, colorInk(c));
+  }
+
+  void fillPattern(int16_t x, int16_t y, int16_t w, int16_t h,
+                   const uint8_t pattern[8], uint16_t c)
+  {
+    if (R != 0)
+    {
+      Base::fillPattern(x, y, w, h, pattern, c);
+      return;
+    }
+    ::fillPattern(black, W, H, x, y, w, h, pattern, blackInk(c));
+    ::fillPattern(color, W, H, x, y, w, h, pattern, colorInk(c));
+  }
+
+  void drawDottedHLine(int16_t x0, int16_t x1, int16_t y, uint8_t step,
+                       uint16_t c)
+  {
+    if (R != 0)
+    {
+      Base::drawDottedHLine(x0, x1, y, step, c);
+      return;
+    }
+    ::drawDottedHLine(black, W, H, x0, x1, y, step, blackInk(c));
+    ::drawDottedHLine(color, W, H, x0, x1, y, step, colorInk(c));
+  }
+
+private:
+  uint8_t *black;
+  uint8_t *color;
+
+  // as GxEPD2_3C::drawPixel(), other colors are white
+  static bool blackInk(uint16_t c)
+  {
+    return c != GxEPD_BLACK;
+  }
+
+  static bool colorInk(uint16_t c)
+  {
+    return c != GxEPD_RED && c != GxEPD_YELLOW;
+  }
+
+  void setPixel(int16_t x, int16_t y, uint16_t c)
+  {
+    const size_t i = y * (W / 8) + x / 8;
+    const uint8_t mask = 0x80 >> (x & 7);
+    black[i] = blackInk(c) ? (black[i] | mask) : (black[i] & ~mask);
+    color[i] = colorInk(c) ? (color[i] | mask) : (color[i] & ~mask);
+  }
+
+  void fillSpan(int16_t x0, int16_t x1, int16_t y, uint16_t c)
+  {
+    fillPlaneSpan<W>(black, x0, x1, y, blackInk(c));
+    fillPlaneSpan<W>(color, x0, x1, y, colorInk(c));
+  }
+
+  void fillColumn(int16_t x, int16_t y0, int16_t y1, uint16_t c)
+  {
+    fillPlaneColumn<W>(black, x, y0, y1, blackInk(c));
+    fillPlaneColumn<W>(color, x, y0, y1, colorInk(c));
+  }
+};
+
+/* 7-color frame, 4bpp with the even pixel in the high nibble. The native
+ * format of GxEPD2_7C panels.
+ */
+template<int16_t W, int16_t H, uint8_t R = 0>
+class Color7Frame : public FrameBackend<Color7Frame<W, H, R>, W, H, R>
+{
+  using Base = FrameBackend<Color7Frame<W, H, R>, W, H, R>;
+  friend Base;
+
+public:
+  static constexpr size_t size = (W / 2) * H;
+
+  explicit Color7Frame(uint8_t *frame) : frame(frame) {}
+
+  void fillScreen(uint16_t color)
+  {
+    memset(frame, nibble(color) * 0x11, size);
+  }
+
+private:
+  uint8_t *frame;
+
+  // as GxEPD2_7C::drawPixel() for the colors the renderer uses
+  static uint8_t nibble(uint16_t color)
+  {
+    switch (color)
+    {
+    case GxEPD_BLACK:  return 0x00;
+    case GxEPD_GREEN:  return 0x02;
+    case GxEPD_BLUE:   return 0x03;
+    case GxEPD_RED:    return 0x04;
+    case GxEPD_YELLOW: return 0x05;
+    case GxEPD_ORANGE: return 0x06;
+    default:           return 0x01; // white
+    }
+  }
+
+  void setPixel(int16_t x, int16_t y, uint16_t color)
+  {
+    const uint8_t c = nibble(color);
+    uint8_t &b = frame[(y * W + x) / 2];
+    b = (x & 1) ? ((b & 0xF0) | c) : ((b & 0x0F) | (c << 4));
+  }
+
+  void fillSpan(int16_t x0, int16_t x1, int16_t y, uint16_t color)
+  {
+    const uint8_t c = nibble(color);
+    uint8_t *row = frame + y * (W / 2);
+    if (x0 & 1)
+    { // odd first pixel, low nibble
+      row[x0 / 2] = (row[x0 / 2] & 0xF0) | c;
+      ++x0;
+    }
+    if (!(x1 & 1) && x1 >= x0)
+    { // even last pixel, high nibble
+      row[x1 / 2] = (row[x1 / 2] & 0x0F) | (c << 4);
+      --x1;
+    }
+    if (x1 > x0)
+    {
+      memset(row + x0 / 2, c * 0x11, (x1 - x0 + 1) / 2);
+    }
+  }
+
+  void fillColumn(int16_t x, int16_t y0, int16_t y1, uint16_t color)
+  {
+    for (int16_t y = y0; y <= y1; ++y)
+    {
+      setPixel(x, y, color);
+    }
+  }
+};
+
+#endif
@@ -0,0 +1,66 @@
+/* Frame differencing declarations for esp32-weather-epd.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __FRAME_DIFF_H__
+#define __FRAME_DIFF_H__
+
+#include <cstdint>
+
+// Frames are compared in square tiles of this many pixels. Must be a multiple
+// of 8 (partial windows are byte aligned) and divide the display dimensions.
+#define FRAME_TILE_SIZE 32
+// Maximum number of partial windows per refresh. Beyond this the changed tiles
+// are refreshed as their bounding box.
+#define FRAME_MAX_RECTS 8
+
+typedef struct frame_rect
+{
+  uint16_t x;
+  uint16_t y;
+  uint16_t w;
+  uint16_t h;
+} frame_rect_t;
+
+typedef enum frame_refresh
+{
+  FRAME_REFRESH_NONE,
+  FRAME_REFRESH_PARTIAL,
+  FRAME_REFRESH_FULL
+} frame_refresh_t;
+
+typedef struct frame_policy
+{
+  float max_area;         // fraction of the display above which to refresh fully
+  int   max_partials;     // partial refreshes between full refreshes (ghosting)
+} frame_policy_t;
+
+typedef struct frame_diff
+{
+  int          changed_tiles;
+  int          total_tiles;
+  int          num_rects;
+  frame_rect_t rects[FRAME_MAX_RECTS];
+} frame_diff_t;
+
+void frameHashTiles(const uint8_t *buf, int width, int height,
+                    uint32_t *hashes);
+void frameDiffTiles(const uint32_t *prev, const uint32_t *cur,
+                    int tilesX, int tilesY, frame_diff_t &d);
+frame_refresh_t frameRefreshPolicy(const frame_diff_t &d, bool prevValid,
+                                   int partials, const frame_policy_t &p);
+
+#endif
@@ -0,0 +1,290 @@
+/* Dashboard layout for esp32-weather-epd.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LAYOUT_H__
+#define __LAYOUT_H__
+
+#include <cstdint>
+#include "config.h"
+
+#if defined(DISP_BW_V2) || defined(DISP_3C_B) || defined(DISP_7C_F)
+  #define DISP_WIDTH  800
+  #define DISP_HEIGHT 480
+#endif
+#ifdef DISP_BW_V1
+  #define DISP_WIDTH  640
+  #define DISP_HEIGHT 384
+#endif
+
+// Outlook graph plot area, the right edge depends on the precipitation axis.
+#define GRAPH_X0 350
+#define GRAPH_Y0 216
+#define GRAPH_Y1 (DISP_HEIGHT - 46)
+
+// Current conditions grid, 2 columns of cells below the current conditions
+// header. Cell n is in column n % 2 and row n / 2.
+#define GRID_Y      204
+#define GRID_CELL_W 162
+#define GRID_CELL_H 48
+#define GRID_GAP    8   // between rows
+
+// Grid cell of each current conditions widget, -1 if it is not shown.
+#ifdef POS_SUNRISE
+  #define GRID_SUNRISE POS_SUNRISE
+#else
+  #define GRID_SUNRISE -1
+#endif
+#ifdef POS_SUNSET
+  #define GRID_SUNSET POS_SUNSET
+#else
+  #define GRID_SUNSET -1
+#endif
+#ifdef POS_WIND
+  #define GRID_WIND POS_WIND
+#else
+  #define GRID_WIND -1
+#endif
+#ifdef POS_HUMIDITY
+  #define GRID_HUMIDITY POS_HUMIDITY
+#else
+  #define GRID_HUMIDITY -1
+#endif
+#ifdef POS_UVI
+  #define GRID_UVI POS_UVI
+#else
+  #define GRID_UVI -1
+#endif
+#ifdef POS_PRESSURE
+  #define GRID_PRESSURE POS_PRESSURE
+#else
+  #define GRID_PRESSURE -1
+#endif
+#ifdef POS_VISIBILITY
+  #define GRID_VISIBILITY POS_VISIBILITY
+#else
+  #define GRID_VISIBILITY -1
+#endif
+#ifdef POS_AIR_QULITY
+  #define GRID_AIR_QUALITY POS_AIR_QULITY
+#else
+  #define GRID_AIR_QUALITY -1
+#endif
+#ifdef POS_INTEMP
+  #define GRID_INTEMP POS_INTEMP
+#else
+  #define GRID_INTEMP -1
+#endif
+#ifdef POS_INHUMIDITY
+  #define GRID_INHUMIDITY POS_INHUMIDITY
+#else
+  #define GRID_INHUMIDITY -1
+#endif
+#ifdef POS_DEWPOINT
+  #define GRID_DEWPOINT POS_DEWPOINT
+#else
+  #define GRID_DEWPOINT -1
+#endif
+
+typedef struct layout_rect
+{
+  int16_t x;
+  int16_t y;
+  int16_t w;              // 0 if not shown
+  int16_t h;
+} layout_rect_t;
+
+// Everything on the dashboard that has an area of its own.
+typedef enum layout_id
+{
+  LAYOUT_CURRENT_HEADER,  // current weather icon, temperature and feels like
+  LAYOUT_LOCATION_DATE,   // city and date, top right
+  LAYOUT_FORECAST,        // five day forecast
+  LAYOUT_OUTLOOK_GRAPH,   // including axis labels and hourly icons
+  LAYOUT_STATUS_BAR,
+  // current conditions grid
+  LAYOUT_SUNRISE,
+  LAYOUT_SUNSET,
+  LAYOUT_WIND,
+  LAYOUT_HUMIDITY,
+  LAYOUT_UVI,
+  LAYOUT_PRESSURE,
+  LAYOUT_VISIBILITY,
+  LAYOUT_AIR_QUALITY,
+  LAYOUT_INTEMP,
+  LAYOUT_INHUMIDITY,
+  LAYOUT_DEWPOINT,
+  LAYOUT_COUNT
+} layout_id_t;
+
+/* Returns the area of grid cell pos, empty if pos is -1.
+ */
+constexpr layout_rect_t layoutGridCell(int pos)
+{
+  if (pos < 0)
+  {
+    return {0, 0, 0, 0};
+  }
+  return {static_cast<int16_t>(GRID_CELL_W * (pos % 2)),
+          static_cast<int16_t>(GRID_Y + (GRID_CELL_H + GRID_GAP) * (pos / 2)),
+          GRID_CELL_W, GRID_CELL_H};
+} // end layoutGridCell
+
+// Area of everything on the dashboard, by layout_id_t. The current conditions
+// header and the forecast are drawn from the widget cache, their x and w are
+// multiples of 8.
+constexpr layout_rect_t LAYOUT[LAYOUT_COUNT] = {
+#ifndef DISP_BW_V1
+  {  0,  0, 360, 200},
+  {360,  0, DISP_WIDTH - 360, 56},
+  {392, 56, 408, 144},
+#else
+  {  0,  0, 320, 200},
+  {320,  0, DISP_WIDTH - 320, 56},
+  {312, 56, 328, 144},
+#endif
+  // the temperature axis labels reach left of GRAPH_X0 up to the grid, the
+  // hourly icons rise up to 32px above GRAPH_Y0
+  {2 * GRID_CELL_W, GRAPH_Y0 - 32,
+   DISP_WIDTH - 2 * GRID_CELL_W, DISP_HEIGHT - 22 - (GRAPH_Y0 - 32)},
+  {344, DISP_HEIGHT - 22, DISP_WIDTH - 344, 22},
+  layoutGridCell(GRID_SUNRISE),
+  layoutGridCell(GRID_SUNSET),
+  layoutGridCell(GRID_WIND),
+  layoutGridCell(GRID_HUMIDITY),
+  layoutGridCell(GRID_UVI),
+  layoutGridCell(GRID_PRESSURE),
+  layoutGridCell(GRID_VISIBILITY),
+  layoutGridCell(GRID_AIR_QUALITY),
+  layoutGridCell(GRID_INTEMP),
+  layoutGridCell(GRID_INHUMIDITY),
+  layoutGridCell(GRID_DEWPOINT),
+};
+
+// Five day forecast, each day is a 64px wide column.
+#ifndef DISP_BW_V1
+#define FORECAST_DAY_PITCH 82
+#else
+#define FORECAST_DAY_PITCH 64
+#endif
+
+/* Returns the area of the ith day of the five day forecast.
+ */
+constexpr layout_rect_t layoutForecastDay(int i)
+{
+  return {static_cast<int16_t>(LAYOUT[LAYOUT_FORECAST].x + 6
+                               + i * FORECAST_DAY_PITCH),
+          LAYOUT[LAYOUT_FORECAST].y, 64, LAYOUT[LAYOUT_FORECAST].h};
+} // end layoutForecastDay
+
+/* Returns the smallest rectangle containing a and b.
+ */
+constexpr layout_rect_t layoutUnion(const layout_rect_t &a,
+                                    const layout_rect_t &b)
+{
+  const int x0 = a.x < b.x ? a.x : b.x;
+  const int y0 = a.y < b.y ? a.y : b.y;
+  const int x1 = a.x + a.w > b.x + b.w ? a.x + a.w : b.x + b.w;
+  const int y1 = a.y + a.h > b.y + b.h ? a.y + a.h : b.y + b.h;
+  return {static_cast<int16_t>(x0), static_cast<int16_t>(y0),
+          static_cast<int16_t>(x1 - x0), static_cast<int16_t>(y1 - y0)};
+} // end layoutUnion
+
+/* Returns true if r covers any of the rows y0 to y1 - 1.
+ */
+constexpr bool layoutInRows(const layout_rect_t &r, int y0, int y1)
+{
+  return r.w > 0 && r.h > 0 && r.y < y1 && y0 < r.y + r.h;
+} // end layoutInRows
+
+/* Returns true if a and b share any pixel.
+ */
+constexpr bool layoutOverlaps(const layout_rect_t &a, const layout_rect_t &b)
+{
+  return layoutInRows(a, b.y, b.y + b.h) && b.w > 0
+      && a.x < b.x + b.w && b.x < a.x + a.w;
+} // end layoutOverlaps
+
+/* Returns true if r is empty or on the panel.
+ */
+constexpr bool layoutOnPanel(const layout_rect_t &r)
+{
+  return r.w == 0 || r.h == 0
+      || (r.x >= 0 && r.y >= 0
+          && r.x + r.w <= DISP_WIDTH && r.y + r.h <= DISP_HEIGHT);
+} // end layoutOnPanel
+
+/* Areas that are known to overlap: the outlook graph reaches into the bottom of
+ * the header and forecast for the hourly icons, and on DISP_BW_V1 the cached
+ * header and forecast share the byte their rectangles are padded to.
+ */
+constexpr bool layoutMayOverlap(int a, int b)
+{
+  return (a == LAYOUT_CURRENT_HEADER && b == LAYOUT_OUTLOOK_GRAPH)
+      || (a == LAYOUT_FORECAST && b == LAYOUT_OUTLOOK_GRAPH)
+#ifdef DISP_BW_V1
+      || (a == LAYOUT_CURRENT_HEADER && b == LAYOUT_FORECAST)
+#endif
+      ;
+} // end layoutMayOverlap
+
+/* Returns true if all areas are on the panel.
+ */
+constexpr bool layoutFitsPanel()
+{
+  for (int i = 0; i < LAYOUT_COUNT; ++i)
+  {
+    if (!layoutOnPanel(LAYOUT[i]))
+    {
+      return false;
+    }
+  }
+  for (int i = 0; i < 5; ++i)
+  {
+    const layout_rect_t day = layoutForecastDay(i);
+    if (day.x + day.w > LAYOUT[LAYOUT_FORECAST].x + LAYOUT[LAYOUT_FORECAST].w)
+    {
+      return false;
+    }
+  }
+  return true;
+} // end layoutFitsPanel
+
+/* Returns true if no two areas overlap, other than those that may.
+ */
+constexpr bool layoutDisjoint()
+{
+  for (int i = 0; i < LAYOUT_COUNT; ++i)
+  {
+    for (int j = i + 1; j < LAYOUT_COUNT; ++j)
+    {
+      if (layoutOverlaps(LAYOUT[i], LAYOUT[j]) && !layoutMayOverlap(i, j))
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+} // end layoutDisjoint
+
+static_assert(layoutFitsPanel(),
+              "Invalid configuration. A widget is off the panel, "
+              "POS_* must be 0 to 9 (0 to 5 on DISP_BW_V1).");
+static_assert(layoutDisjoint(),
+              "Invalid configuration. Widgets overlap, "
+              "each POS_* must be a different position.");
+
+#endif
@@ -0,0 +1,31 @@
+/* PackBits run-length coding declarations for esp32-weather-epd.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __PACKBITS_H__
+#define __PACKBITS_H__
+
+#include <cstddef>
+#include <cstdint>
+
+// Worst case encoded size of n bytes.
+#define PACKBITS_MAX_SIZE(n) ((n) + ((n) + 127) / 128)
+
+size_t packBitsEncode(const uint8_t *src, size_t n, uint8_t *dst);
+size_t packBitsDecode(const uint8_t *src, size_t n, uint8_t *dst,
+                      size_t size);
+
+#endif
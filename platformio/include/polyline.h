@@ -0,0 +1,29 @@
+/* Thick polyline rasterizer declarations for esp32-weather-epd.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __POLYLINE_H__
+#define __POLYLINE_H__
+
+#include <cstdint>
+
+// Number of columns thickPolylineSpans() fills for a polyline from x0 to x1.
+#define POLYLINE_COLUMNS(x0, x1, width) ((x1) - (x0) + (width))
+
+uint16_t thickPolylineSpans(const int *xs, const int *ys, uint16_t n,
+                            uint8_t width, int16_t *lo, int16_t *hi);
+
+#endif
@@ -0,0 +1,75 @@
+/* Derived render model for esp32-weather-epd.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __RENDER_MODEL_H__
+#define __RENDER_MODEL_H__
+
+#include <cstdint>
+#include "api_response.h"
+#include "config.h"
+#include "layout.h"
+#include "units.h"
+
+// Outlook graph: intervals of the y axes, and the most x ticks (hours with a
+// label) it may have.
+#define GRAPH_Y_MAJOR_TICKS 5
+#define GRAPH_X_MAX_TICKS   8
+
+// What the dashboard shows that is derived from the forecast rather than read
+// from it. Built once per update by buildRenderModel(), the draw functions and
+// the display state hash read it instead of working it out again, which the
+// draw functions would otherwise do for every page.
+typedef struct render_model
+{
+  // current conditions
+  const uint8_t *current_icon;    // 196x196 current conditions icon
+  const uint8_t *wind_icon;       // 24x24 wind direction arrow
+  const char    *wind_compass;    // compass point of the wind direction
+  unsigned int   uvi;             // UV index, rounded
+  const char    *uvi_desc;        // UV index descriptor
+  const char    *aqi_desc;        // air quality index descriptor
+  float          dew_point;       // (°C) from temperature and humidity, or NaN
+
+  // five day forecast
+  const uint8_t *daily_icon[5];   // 64x64 icon of each day
+
+  // outlook graph, hours 0 to HOURLY_GRAPH_MAX - 1
+  float          temp[OM_NUM_HOURLY];    // temperature (Temp units)
+  float          precip[OM_NUM_HOURLY];  // precipitation (Precip units)
+  float          temp_min;               // lowest of temp[]
+  float          temp_max;               // highest of temp[]
+  int            temp_bound_min;         // bottom of the temperature axis
+  int            temp_bound_max;         // top of the temperature axis
+  int            temp_tick;              // temperature axis step
+  float          precip_bound_max;       // top of the precipitation axis, 0 if
+                                         // there is no precipitation
+  int16_t        temp_y[OM_NUM_HOURLY];  // y of each temperature on the graph
+  int16_t        precip_y[OM_NUM_HOURLY];// top of each precipitation bar
+  int            hour_interval;          // hours between x ticks
+  uint8_t        day_idx[OM_NUM_HOURLY]; // daily[] day each hour is in
+  const uint8_t *hourly_icon[OM_NUM_HOURLY]; // 32x32 icon at the x ticks after
+                                             // the first, nullptr elsewhere
+} render_model_t;
+
+// The outlook graph must be drawn in the Temp and Precip units the model was
+// built with.
+template<class Temp = TempUnits, class Precip = HourlyPrecipUnits>
+void buildRenderModel(render_model_t &model, const om_current_t &current,
+                      const om_hourly_t *hourly, const om_daily_t *daily,
+                      const om_resp_air_quality_t &air_quality);
+
+#endif
@@ -22,36 +22,605 @@
 #include <time.h>
 #include "api_response.h"
 #include "config.h"
+#include "layout.h"
+#include "render_model.h"
+#include "units.h"
+
+// Black and white panels draw the frame into a 1bpp frame buffer of their own
+// (captured) when there is memory for it, a byte at a time instead of through
+// drawPixel(). That buffer (48KB for DISP_BW_V2) is allocated for each update,
+// error screens included. The GxEPD2_BW page buffer is kept to 1/8 of the panel
+// for when it can't be, the frame is then drawn in 8 pages (16 on panels with
+// fast partial refresh, which GxEPD2_BW goes through twice).
+#if defined(DISP_BW_V2) || defined(DISP_BW_V1)
+  #define FRAME_CAPTURE_ACTIVE 1
+#else
+  #define FRAME_CAPTURE_ACTIVE 0
+#endif
+
+// Differential refresh needs the whole 1bpp frame in memory.
+#if FRAME_DIFF && (defined(DISP_BW_V2) || defined(DISP_BW_V1))
+  #define FRAME_DIFF_ACTIVE 1
+#else
+  #define FRAME_DIFF_ACTIVE 0
+#endif
+
+// Cached widgets are cut from and blitted into the captured 1bpp frame.
+#if WIDGET_CACHE && FRAME_DIFF_ACTIVE
+  #define WIDGET_CACHE_ACTIVE 1
+#else
+  #define WIDGET_CACHE_ACTIVE 0
+#endif
+
+// The background is read back from the captured 1bpp frame to be stored.
+#if BACKGROUND_CACHE && FRAME_DIFF_ACTIVE
+  #define BACKGROUND_CACHE_ACTIVE 1
+#else
+  #define BACKGROUND_CACHE_ACTIVE 0
+#endif
+
+// Paged panels can record a frame once and replay it for each page.
+#if DISPLAY_LIST && (defined(DISP_3C_B) || defined(DISP_7C_F))
+  #define DISPLAY_LIST_ACTIVE 1
+#else
+  #define DISPLAY_LIST_ACTIVE 0
+#endif
+
+// Paged panels can draw the whole frame at once into PSRAM, if there is any.
+#if PSRAM_FRAME && (defined(DISP_3C_B) || defined(DISP_7C_F))
+  #define PSRAM_FRAME_ACTIVE 1
+#else
+  #define PSRAM_FRAME_ACTIVE 0
+#endif
+
+// Per pixel fillPattern() and drawDottedHLine() (see blit.h), for displays
+// drawing through drawPixel().
+template<class GFX>
+void fillPatternPixels(GFX &gfx, int16_t x, int16_t y, int16_t w, int16_t h,
+                       const uint8_t pattern[8], uint16_t color)
+{
+  for (int16_t py = y; py < y + h; ++py)
+  {
+    const uint8_t bits = pattern[py & 7];
+    for (int16_t px = x; bits != 0 && px < x + w; ++px)
+    {
+      if (bits & (0x80 >> (px & 7)))
+      {
+        gfx.drawPixel(px, py, color);
+      }
+    }
+  }
+}
+
+template<class GFX>
+void drawDottedHLinePixels(GFX &gfx, int16_t x0, int16_t x1, int16_t y,
+                           uint8_t step, uint16_t color)
+{
+  for (int16_t x = x0; x <= x1; x += step)
+  {
+    gfx.drawPixel(x, y, color);
+  }
+}
+
+#if defined(DISP_BW_V2) || defined(DISP_BW_V1)
+  #include <GxEPD2_BW.h>
+  #include "frame_backend.h"
+// GxEPD2_BW that can instead draw the frame into a buffer of its own (1bpp,
+// white = 1, same layout as the GxEPD2_BW buffer), which is then shown from
+// there. With FRAME_DIFF it is first compared against the previous frame.
+//
+// Draw calls into that frame go to a MonoFrame of the panel size, which writes
+// to it directly instead of through the virtual drawPixel().
+template<typename GxEPD2_Type, const uint16_t page_height>
+class GxEPD2_BW_Display : public GxEPD2_BW<GxEPD2_Type, page_height>
+{
+  using Base = GxEPD2_BW<GxEPD2_Type, page_height>;
+  template<uint8_t R>
+  using Frame = MonoFrame<GxEPD2_Type::WIDTH, GxEPD2_Type::HEIGHT, R>;
+
+public:
+  using Base::GxEPD2_BW;
+
+  // draw calls go to this frame instead of the GxEPD2_BW buffer while set
+  uint8_t *capture = nullptr;
+
+  // font set with setFont(), nullptr for the classic font
+  const GFXfont *getFont() const
+  {
+    return this->gfxFont;
+  }
+
+  // Any rotation, the other draw calls end up here when it isn't 0.
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override
+  {
+    switch (capture == nullptr ? 4 : this->rotation)
+    {
+    case 0: Frame<0>(capture).drawPixel(x, y, color); break;
+    case 1: Frame<1>(capture).drawPixel(x, y, color); break;
+    case 2: Frame<2>(capture).drawPixel(x, y, color); break;
+    case 3: Frame<3>(capture).drawPixel(x, y, color); break;
+    default: Base::drawPixel(x, y, color);            break;
+    }
+  }
+
+  void fillScreen(uint16_t color) override
+  {
+    if (capture == nullptr)
+    {
+      Base::fillScreen(color);
+      return;
+    }
+    Frame<0>(capture).fillScreen(color);
+  }
+
+  void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                uint16_t color) override
+  {
+    if (!captured())
+    {
+      Base::drawLine(x0, y0, x1, y1, color);
+      return;
+    }
+    Frame<0>(capture).drawLine(x0, y0, x1, y1, color);
+  }
+
+  void drawFastHLine(int16_t x, int16_t y, int16_t w,
+                     uint16_t color) override
+  {
+    if (!captured())
+    {
+      Base::drawFastHLine(x, y, w, color);
+      return;
+    }
+    Frame<0>(capture).drawFastHLine(x, y, w, color);
+  }
+
+  void drawFastVLine(int16_t x, int16_t y, int16_t h,
+                     uint16_t color) override
+  {
+    if (!captured())
+    {
+      Base::drawFastVLine(x, y, h, color);
+      return;
+    }
+    Frame<0>(capture).drawFastVLine(x, y, h, color);
+  }
+
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                uint16_t color) override
+  {
+    if (!captured())
+    {
+      Base::fillRect(x, y, w, h, color);
+      return;
+    }
+    Frame<0>(capture).fillRect(x, y, w, h, color);
+  }
+
+  // Hides GxEPD2_BW::drawInvertedBitmap(), the bitmap is copied into the frame
+  // a byte at a time instead of pixel by pixel.
+  void drawInvertedBitmap(int16_t x, int16_t y, const uint8_t bitmap[],
+                          int16_t w, int16_t h, uint16_t color)
+  {
+    if (!captured())
+    {
+      Base::drawInvertedBitmap(x, y, bitmap, w, h, color);
+      return;
+    }
+    Frame<0>(capture).drawInvertedBitmap(x, y, bitmap, w, h, color);
+  }
+
+  // Glyphs are copied into the frame a row at a time, instead of pixel by
+  // pixel through drawChar().
+  size_t write(uint8_t c) override
+  {
+    const GFXfont *font = this->gfxFont;
+    if (!captured() || font == nullptr || c < font->first || c > font->last
+     || this->textsize_x != 1 || this->textsize_y != 1 || this->wrap)
+    {
+      return Base::write(c);
+    }
+    this->cursor_x += Frame<0>(capture).drawGlyph(font, c, this->cursor_x,
+                                               this->cursor_y,
+                                               this->textcolor);
+    return 1;
+  }
+
+  // Sets the pixels of the rectangle that are 1 in the 8x8 pattern to color.
+  void fillPattern(int16_t x, int16_t y, int16_t w, int16_t h,
+                   const uint8_t pattern[8], uint16_t color)
+  {
+    if (!captured())
+    {
+      fillPatternPixels(*this, x, y, w, h, pattern, color);
+      return;
+    }
+    Frame<0>(capture).fillPattern(x, y, w, h, pattern, color);
+  }
+
+  // Draws every step-th pixel (step 1 to 8) from x0 to x1 of row y.
+  void drawDottedHLine(int16_t x0, int16_t x1, int16_t y, uint8_t step,
+                       uint16_t color)
+  {
+    if (!captured())
+    {
+      drawDottedHLinePixels(*this, x0, x1, y, step, color);
+      return;
+    }
+    Frame<0>(capture).drawDottedHLine(x0, x1, y, step, color);
+  }
+
+  // Shows the frame with a full refresh, the same as display() shows the
+  // GxEPD2_BW buffer.
+  void displayCapture()
+  {
+    this->epd2.writeImageForFullRefresh(capture, 0, 0,
+                                        this->WIDTH, this->HEIGHT);
+    this->epd2.refresh(false);
+    if (this->epd2.hasFastPartialUpdate)
+    {
+      this->epd2.writeImageAgain(capture, 0, 0, this->WIDTH, this->HEIGHT);
+    }
+    this->epd2.powerOff();
+  }
+
+  // Shows a window of the frame, the same as displayWindow() shows the
+  // GxEPD2_BW buffer. previous is the frame on the panel, the panel's own copy
+  // is lost when it is powered off and a partial refresh only drives the pixels
+  // that differ from it. It is nullptr if that copy was written back already,
+  // by writeCaptureWindowAgain(). x and w should be multiples of 8.
+  void displayCaptureWindow(const uint8_t *previous,
+                            int16_t x, int16_t y, int16_t w, int16_t h)
+  {
+    if (previous != nullptr)
+    {
+      this->epd2.writeImagePartAgain(previous, x, y, this->WIDTH, this->HEIGHT,
+                                     x, y, w, h);
+    }
+    this->epd2.writeImagePart(capture, x, y, this->WIDTH, this->HEIGHT,
+                              x, y, w, h);
+    this->epd2.refresh(x, y, w, h);
+    if (this->epd2.hasFastPartialUpdate)
+    {
+      this->epd2.writeImagePartAgain(capture, x, y, this->WIDTH, this->HEIGHT,
+                                     x, y, w, h);
+    }
+  }
+
+  // Writes a window of the frame as the image on the panel, the previous image
+  // of the next partial refresh, without refreshing. x and w should be
+  // multiples of 8.
+  void writeCaptureWindowAgain(int16_t x, int16_t y, int16_t w, int16_t h)
+  {
+    this->epd2.writeImagePartAgain(capture, x, y, this->WIDTH, this->HEIGHT,
+                                   x, y, w, h);
+  }
+
+private:
+  // Draw calls other than drawPixel() take the frame at rotation 0, the one
+  // the renderer uses, and go through drawPixel() otherwise.
+  bool captured() const
+  {
+    return capture != nullptr && this->rotation == 0;
+  }
+};
+#endif
+
+#if defined(DISP_3C_B) || defined(DISP_7C_F)
+  #include <Adafruit_GFX.h>
+  #include "display_list.h"
+  #include "frame_backend.h"
+// Paged display (GxEPD2_3C, GxEPD2_7C) that can record what is drawn into a
+// display list instead of drawing it, and replay that list one page at a time.
+// It can also draw into a full frame buffer of its own (in PSRAM), which is
+// written to the panel at once, so that nothing is drawn more than once. Draw
+// calls into that frame go to a Color3Frame or Color7Frame of the panel size.
+template<class GxEPD2_Base>
+class GxEPD2_Paged_Display : public GxEPD2_Base
+{
+  using Panel = decltype(GxEPD2_Base::epd2);
+#ifdef DISP_3C_B
+  using Frame = Color3Frame<Panel::WIDTH, Panel::HEIGHT>;
+#else
+  using Frame = Color7Frame<Panel::WIDTH, Panel::HEIGHT>;
+#endif
+
+public:
+  using GxEPD2_Base::GxEPD2_Base;
+
+  // draw calls are recorded here while set
+  display_list_t *list = nullptr;
+  // draw calls go to this full frame (frameSize() bytes) instead of the page
+  // buffer while set
+  uint8_t *frame = nullptr;
+
+  // font set with setFont(), nullptr for the classic font
+  const GFXfont *getFont() const
+  {
+    return this->gfxFont;
+  }
+
+  // Size of a full frame in the native format of the panel. 3C: a black and a
+  // color plane, 1bpp each, 1 = white. 7C: 4bpp, 2 pixels per byte.
+  size_t frameSize() const
+  {
+    return Frame::size;
+  }
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override
+  {
+    if (list != nullptr)
+    {
+      dlPixel(*list, x, y, color);
+      return;
+    }
+    if (frame != nullptr)
+    { // rotation is always 0
+      Frame(frame).drawPixel(x, y, color);
+      return;
+    }
+    GxEPD2_Base::drawPixel(x, y, color);
+  }
+
+  void fillScreen(uint16_t color) override
+  {
+    if (frame == nullptr)
+    {
+      GxEPD2_Base::fillScreen(color);
+      return;
+    }
+    Frame(frame).fillScreen(color);
+  }
+
+  // Sets the pixels of the rectangle that are 1 in the 8x8 pattern to color.
+  void fillPattern(int16_t x, int16_t y, int16_t w, int16_t h,
+                   const uint8_t pattern[8], uint16_t color)
+  {
+    if (!framed())
+    {
+      fillPatternPixels(*this, x, y, w, h, pattern, color);
+      return;
+    }
+    Frame(frame).fillPattern(x, y, w, h, pattern, color);
+  }
+
+  // Draws every step-th pixel (step 1 to 8) from x0 to x1 of row y.
+  void drawDottedHLine(int16_t x0, int16_t x1, int16_t y, uint8_t step,
+                       uint16_t color)
+  {
+    if (!framed())
+    {
+      drawDottedHLinePixels(*this, x0, x1, y, step, color);
+      return;
+    }
+    Frame(frame).drawDottedHLine(x0, x1, y, step, color);
+  }
+
+  // Writes the full frame to the panel and refreshes it.
+  void writeFrame()
+  {
+#ifdef DISP_3C_B
+    GxEPD2_Base::writeImage(frame, frame + frameSize() / 2,
+                            0, 0, this->WIDTH, this->HEIGHT);
+#else
+    GxEPD2_Base::writeNative(frame, nullptr, 0, 0, this->WIDTH, this->HEIGHT);
+#endif
+    GxEPD2_Base::refresh(false);
+  }
+
+  void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                uint16_t color) override
+  {
+    if (list != nullptr)
+    {
+      dlLine(*list, x0, y0, x1, y1, color);
+      return;
+    }
+    if (framed())
+    {
+      Frame(frame).drawLine(x0, y0, x1, y1, color);
+      return;
+    }
+    GxEPD2_Base::drawLine(x0, y0, x1, y1, color);
+  }
+
+  void drawFastHLine(int16_t x, int16_t y, int16_t w,
+                     uint16_t color) override
+  {
+    if (list != nullptr)
+    {
+      if (w > 0)
+      {
+        dlLine(*list, x, y, x + w - 1, y, color);
+      }
+      return;
+    }
+    if (framed())
+    {
+      Frame(frame).drawFastHLine(x, y, w, color);
+      return;
+    }
+    GxEPD2_Base::drawFastHLine(x, y, w, color);
+  }
+
+  void drawFastVLine(int16_t x, int16_t y, int16_t h,
+                     uint16_t color) override
+  {
+    if (list != nullptr)
+    {
+      if (h > 0)
+      {
+        dlLine(*list, x, y, x, y + h - 1, color);
+      }
+      return;
+    }
+    if (framed())
+    {
+      Frame(frame).drawFastVLine(x, y, h, color);
+      return;
+    }
+    GxEPD2_Base::drawFastVLine(x, y, h, color);
+  }
+
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                uint16_t color) override
+  {
+    if (framed())
+    {
+      Frame(frame).fillRect(x, y, w, h, color);
+      return;
+    }
+    GxEPD2_Base::fillRect(x, y, w, h, color);
+  }
+
+  void drawInvertedBitmap(int16_t x, int16_t y, const uint8_t bitmap[],
+                          int16_t w, int16_t h, uint16_t color)
+  {
+    if (list != nullptr)
+    {
+      dlBitmap(*list, bitmap, x, y, w, h, color);
+      return;
+    }
+    if (framed())
+    { // 3C: copied into both planes of the frame a byte at a time
+      Frame(frame).drawInvertedBitmap(x, y, bitmap, w, h, color);
+      return;
+    }
+    GxEPD2_Base::drawInvertedBitmap(x, y, bitmap, w, h, color);
+  }
+
+  size_t write(uint8_t c) override
+  {
+    if (list != nullptr)
+    {
+      return write(&c, 1);
+    }
+    // Glyphs go straight into the frame instead of through drawChar(). On 3C
+    // they are copied into both planes a row at a time.
+    const GFXfont *font = this->gfxFont;
+    if (framed() && font != nullptr && c >= font->first && c <= font->last
+     && this->textsize_x == 1 && this->textsize_y == 1 && !this->wrap)
+    {
+      this->cursor_x += Frame(frame).drawGlyph(font, c, this->cursor_x,
+                                               this->cursor_y,
+                                               this->textcolor);
+      return 1;
+    }
+    return GxEPD2_Base::write(c);
+  }
+
+  // Text is recorded as a whole run. The cursor is advanced as if it was
+  // printed, so getCursorX() keeps working while recording.
+  size_t write(const uint8_t *buffer, size_t size) override
+  {
+    if (list == nullptr)
+    {
+      return Print::write(buffer, size);
+    }
+    int16_t x = this->cursor_x;
+    int16_t y = this->cursor_y;
+    int16_t minx = 0x7FFF, miny = 0x7FFF, maxx = -1, maxy = -1;
+    for (size_t i = 0; i < size; ++i)
+    {
+      this->charBounds(buffer[i], &x, &y, &minx, &miny, &maxx, &maxy);
+    }
+    dlText(*list, this->gfxFont, this->cursor_x, this->cursor_y,
+           reinterpret_cast<const char *>(buffer), size, miny, maxy,
+           this->textcolor);
+    this->cursor_x = x;
+    this->cursor_y = y;
+    return size;
+  }
+
+  // Draws the commands of dl that intersect rows y0 to y1 (the current page).
+  void replay(const display_list_t &dl, int16_t y0, int16_t y1)
+  {
+    for (uint16_t i = 0; i < dl.num_cmds; ++i)
+    {
+      const dl_cmd_t &cmd = dl.cmds[i];
+      if (!dlIntersects(cmd, y0, y1))
+      {
+        continue;
+      }
+      switch (cmd.op)
+      {
+      case DL_OP_PIXELS:
+        for (int r = 0; r < cmd.f; ++r)
+        {
+          const int16_t y = cmd.b + r * cmd.e;
+          if (y < y0 || y > y1)
+          {
+            continue;
+          }
+          for (int k = 0; k < cmd.d; ++k)
+          {
+            GxEPD2_Base::drawPixel(cmd.a + k * cmd.c, y, cmd.color);
+          }
+        }
+        break;
+      case DL_OP_LINE:
+        GxEPD2_Base::drawLine(cmd.a, cmd.b, cmd.c, cmd.d, cmd.color);
+        break;
+      case DL_OP_BITMAP:
+        GxEPD2_Base::drawInvertedBitmap(cmd.a, cmd.b,
+                                        static_cast<const uint8_t *>(cmd.ptr),
+                                        cmd.c, cmd.d, cmd.color);
+        break;
+      case DL_OP_TEXT:
+        this->setFont(static_cast<const GFXfont *>(cmd.ptr));
+        this->setTextColor(cmd.color);
+        this->setCursor(cmd.a, cmd.b);
+        for (int k = 0; k < cmd.d; ++k)
+        {
+          GxEPD2_Base::write(static_cast<uint8_t>(dl.text[cmd.c + k]));
+        }
+        break;
+      }
+    }
+  }
+
+private:
+  // Draw calls other than drawPixel() only take the frame at rotation 0, the
+  // one the renderer uses.
+  bool framed() const
+  {
+    return list == nullptr && frame != nullptr && this->rotation == 0;
+  }
+};
+#endif
 
 #ifdef DISP_BW_V2
-  #define DISP_WIDTH  800
-  #define DISP_HEIGHT 480
   #include <GxEPD2_BW.h>
-  extern GxEPD2_BW<GxEPD2_750_T7,
-                   GxEPD2_750_T7::HEIGHT> display;
+  extern GxEPD2_BW_Display<GxEPD2_750_T7,
+                           GxEPD2_750_T7::HEIGHT / 8> display;
 #endif
 #ifdef DISP_3C_B
-  #define DISP_WIDTH  800
-  #define DISP_HEIGHT 480
   #include <GxEPD2_3C.h>
-  extern GxEPD2_3C<GxEPD2_750c_Z08,
-                   GxEPD2_750c_Z08::HEIGHT / 2> display;
+  extern GxEPD2_Paged_Display<GxEPD2_3C<GxEPD2_750c_Z08,
+                              GxEPD2_750c_Z08::HEIGHT / 2>> display;
 #endif
 #ifdef DISP_7C_F
-  #define DISP_WIDTH  800
-  #define DISP_HEIGHT 480
   #include <GxEPD2_7C.h>
-  extern GxEPD2_7C<GxEPD2_730c_GDEY073D46, 
-                   GxEPD2_730c_GDEY073D46::HEIGHT / 4> display;
+  extern GxEPD2_Paged_Display<GxEPD2_7C<GxEPD2_730c_GDEY073D46,
+                              GxEPD2_730c_GDEY073D46::HEIGHT / 4>> display;
 #endif
 #ifdef DISP_BW_V1
-  #define DISP_WIDTH  640
-  #define DISP_HEIGHT 384
   #include <GxEPD2_BW.h>
-  extern GxEPD2_BW<GxEPD2_750,
-                   GxEPD2_750::HEIGHT> display;
+  extern GxEPD2_BW_Display<GxEPD2_750,
+                           GxEPD2_750::HEIGHT / 8> display;
 #endif
 
+// What interim wakes redraw besides the status text and RSSI, as drawn by the
+// last full update or interim wake, and as it is to be drawn.
+typedef struct interim_values
+{
+  float    in_temp;
+  float    in_humidity;
+  uint32_t bat_voltage;
+  float    bat_days_left;
+  char     refresh_time[48];
+} interim_values_t;
+
 typedef enum alignment
 {
   LEFT,
@@ -59,38 +628,67 @@ typedef enum alignment
   CENTER
 } alignment_t;
 
+uint16_t getStringWidth(const char *text);
 uint16_t getStringWidth(const String &text);
+uint16_t getStringHeight(const char *text);
 uint16_t getStringHeight(const String &text);
+void drawString(int16_t x, int16_t y, const char *text, alignment_t alignment,
+                uint16_t color=GxEPD_BLACK);
 void drawString(int16_t x, int16_t y, const String &text, alignment_t alignment,
                 uint16_t color=GxEPD_BLACK);
+void drawMultiLnString(int16_t x, int16_t y, const char *text,
+                       alignment_t alignment, uint16_t max_width,
+                       uint16_t max_lines, int16_t line_spacing,
+                       uint16_t color=GxEPD_BLACK);
 void drawMultiLnString(int16_t x, int16_t y, const String &text,
                        alignment_t alignment, uint16_t max_width,
                        uint16_t max_lines, int16_t line_spacing,
                        uint16_t color=GxEPD_BLACK);
-void initDisplay();
+void initDisplay(bool partial=false);
 void powerOffDisplay();
-void drawCurrentConditions(const om_current_t &current,
-                           const om_daily_t &today,
+void beginFrame();
+bool nextFrame();
+bool onPage(layout_id_t id);
+void drawBackground(const render_model_t &model);
+void drawCurrentConditions(const render_model_t &model,
+                           const om_current_t &current,
                            const om_resp_air_quality_t &air_quality,
                            float inTemp, float inHumidity);
-void drawForecast(const om_daily_t *daily, tm timeInfo);
+template<class Temp = TempUnits, class Precip = DailyPrecipUnits>
+void drawForecast(const render_model_t &model, const om_daily_t *daily,
+                  tm timeInfo);
 void drawLocationDate(const String &city, const String &date);
-void drawOutlookGraph(const om_hourly_t *hourly, const om_daily_t *daily,
+template<class Temp = TempUnits, class Precip = HourlyPrecipUnits>
+void drawOutlookGraph(const render_model_t &model, const om_hourly_t *hourly,
                       tm timeInfo);
 void drawStatusBar(const String &statusStr, const String &refreshTimeStr,
-                   int rssi, uint32_t batVoltage);
+                   int rssi, uint32_t batVoltage, float batDaysLeft);
 void drawError(const uint8_t *bitmap_196x196,
                const String &errMsgLn1, const String &errMsgLn2="");
+bool hasFastPartialRefresh();
+bool beginWindows();
+void endWindows();
+void redrawIndoorConditions(const interim_values_t &shown,
+                            const interim_values_t &values);
+void redrawStatusBar(const String &statusStr, int rssi,
+                     const interim_values_t &shown,
+                     const interim_values_t &values);
 void drawCurrentSunrise(const om_current_t &current);
 void drawCurrentSunset(const om_current_t &current);
+template<class Temp = TempUnits>
 void drawCurrentInTemp(float inTemp);
 void drawCurrentInHumidity(float inHumidity);
-void drawCurrentWind(const om_current_t &current);
+template<class Speed = SpeedUnits>
+void drawCurrentWind(const render_model_t &model, const om_current_t &current);
 void drawCurrentHumidity(const om_current_t &current);
-void drawCurrentUVI(const om_current_t &current);
+void drawCurrentUVI(const render_model_t &model);
+template<class Pres = PresUnits>
 void drawCurrentPressure(const om_current_t &current);
+template<class Dist = DistUnits>
 void drawCurrentVisibility(const om_current_t &current);
-void drawCurrentAirQuality(const om_resp_air_quality_t &air_quality);
-void drawCurrentDewpoint(const om_current_t &current);
+void drawCurrentAirQuality(const render_model_t &model,
+                           const om_resp_air_quality_t &air_quality);
+template<class Temp = TempUnits>
+void drawCurrentDewpoint(const render_model_t &model);
 
 #endif
@@ -0,0 +1,60 @@
+/* Indoor environment sensor utility declarations for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __SENSOR_UTILS_H__
+#define __SENSOR_UTILS_H__
+
+#include <cstdint>
+#include <Arduino.h>
+
+typedef enum sensor_status
+{
+  SENSOR_OK,
+  SENSOR_READ_FAILED,
+  SENSOR_NOT_FOUND
+} sensor_status_t;
+
+// A single indoor reading, packed to keep the RTC history small.
+typedef struct indoor_sample
+{
+  uint32_t dt;            // Unix timestamp
+  int16_t  temp;          // centidegrees (°C * 100)
+  uint16_t humidity;      // centipercent (% * 100)
+} indoor_sample_t;
+
+// Indoor statistics derived from the RTC history.
+typedef struct indoor_stats
+{
+  int   count;            // number of samples within the window
+  float temp_min;         // °C
+  float temp_max;         // °C
+  float temp_trend;       // °C per hour (least-squares slope)
+  float humidity_min;     // %
+  float humidity_max;     // %
+  float humidity_trend;   // % per hour (least-squares slope)
+} indoor_stats_t;
+
+void startIndoorSensor();
+sensor_status_t finishIndoorSensor(float &temp, float &humidity,
+                                   float &gasResistance);
+void stopIndoorSensor();
+sensor_status_t readIndoorSensor(float &temp, float &humidity);
+void recordIndoorSample(int64_t dt, float temp, float humidity);
+bool getIndoorStats(indoor_stats_t &stats, int64_t now, int64_t window);
+
+#endif
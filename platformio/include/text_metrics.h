@@ -0,0 +1,38 @@
+/* Text measurement declarations for esp32-weather-epd.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __TEXT_METRICS_H__
+#define __TEXT_METRICS_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <gfxfont.h>
+
+// Bounding box of the pixels of a text printed with the cursor at (0, 0), the
+// same as Adafruit_GFX::getTextBounds() gives (text size 1, no wrapping).
+typedef struct text_bounds
+{
+  int16_t  x;
+  int16_t  y;
+  uint16_t w;
+  uint16_t h;
+} text_bounds_t;
+
+text_bounds_t fontTextBounds(const GFXfont *font, const char *text, size_t len);
+uint16_t fontTextWidth(const GFXfont *font, const char *text, size_t len);
+
+#endif
@@ -0,0 +1,37 @@
+/* Word wrapping declarations for esp32-weather-epd.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __TEXT_WRAP_H__
+#define __TEXT_WRAP_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <gfxfont.h>
+
+// A line broken off a text: its first len chars, followed by an ellipsis
+// (...) if ellipsis is set. w is the width of both together in pixels.
+typedef struct text_line
+{
+  size_t   len;
+  bool     ellipsis;
+  uint16_t w;
+} text_line_t;
+
+size_t wrapLine(const GFXfont *font, const char *text, size_t len,
+                uint16_t max_width, bool last_line, text_line_t &line);
+
+#endif
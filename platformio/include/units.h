@@ -0,0 +1,422 @@
+/* Compile-time unit policies for esp32-weather-epd.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __UNITS_H__
+#define __UNITS_H__
+
+#include <cmath>
+#include <cstddef>
+#include "_locale.h"
+#include "api_response.h"
+#include "config.h"
+#include "conversions.h"
+#include "float_math.h"
+#include "text_format.h"
+
+/* Each unit a value can be shown in is a policy type:
+ *   convert(v)   the value in this unit, from the unit Open-Meteo reports
+ *   decimals     digits shown after the decimal point
+ *   label()      unit label
+ *   spaced       whether a space goes between the value and the label
+ *
+ * The renderer and the display state hash take the policy as a template
+ * parameter, so the unit is chosen at compile time and nothing is looked up
+ * per value. The policies selected in config.h are aliased at the end of this
+ * file.
+ */
+
+// Temperature, from Celsius. decimals is used by the indoor temperature and
+// dew point; everything else shows whole degrees. symbol() follows the value
+// where the label isn't shown.
+struct TempKelvin
+{
+  static constexpr int decimals = 1;
+  static float convert(float celsius) { return celsius_to_kelvin(celsius); }
+  static const char *label() { return TXT_UNITS_TEMP_KELVIN; }
+  static const char *symbol() { return ""; }
+};
+
+struct TempCelsius
+{
+  static constexpr int decimals = 1;
+  static float convert(float celsius) { return celsius; }
+  static const char *label() { return TXT_UNITS_TEMP_CELSIUS; }
+  static const char *symbol() { return "\260"; }
+};
+
+struct TempFahrenheit
+{
+  static constexpr int decimals = 0;
+  static float convert(float celsius) { return celsius_to_fahrenheit(celsius); }
+  static const char *label() { return TXT_UNITS_TEMP_FAHRENHEIT; }
+  static const char *symbol() { return "\260"; }
+};
+
+// Wind speed, from km/h.
+struct SpeedMetersPerSecond
+{
+  static constexpr int decimals = 0;
+  static constexpr bool spaced = true;
+  static float convert(float kmh)
+  {
+    return kilometersperhour_to_meterspersecond(kmh);
+  }
+  static const char *label() { return TXT_UNITS_SPEED_METERSPERSECOND; }
+};
+
+struct SpeedFeetPerSecond
+{
+  static constexpr int decimals = 0;
+  static constexpr bool spaced = true;
+  static float convert(float kmh)
+  {
+    return kilometersperhour_to_feetpersecond(kmh);
+  }
+  static const char *label() { return TXT_UNITS_SPEED_FEETPERSECOND; }
+};
+
+struct SpeedKilometersPerHour
+{
+  static constexpr int decimals = 0;
+  static constexpr bool spaced = true;
+  static float convert(float kmh) { return kmh; }
+  static const char *label() { return TXT_UNITS_SPEED_KILOMETERSPERHOUR; }
+};
+
+struct SpeedMilesPerHour
+{
+  static constexpr int decimals = 0;
+  static constexpr bool spaced = true;
+  static float convert(float kmh)
+  {
+    return kilometersperhour_to_milesperhour(kmh);
+  }
+  static const char *label() { return TXT_UNITS_SPEED_MILESPERHOUR; }
+};
+
+struct SpeedKnots
+{
+  static constexpr int decimals = 0;
+  static constexpr bool spaced = true;
+  static float convert(float kmh) { return kilometersperhour_to_knots(kmh); }
+  static const char *label() { return TXT_UNITS_SPEED_KNOTS; }
+};
+
+struct SpeedBeaufort
+{
+  static constexpr int decimals = 0;
+  static constexpr bool spaced = true;
+  static float convert(float kmh)
+  {
+    return static_cast<float>(kilometersperhour_to_beaufort(kmh));
+  }
+  static const char *label() { return TXT_UNITS_SPEED_BEAUFORT; }
+};
+
+// Pressure, from hPa.
+struct PresHectopascals
+{
+  static constexpr int decimals = 0;
+  static constexpr bool spaced = true;
+  static float convert(float hpa) { return hpa; }
+  static const char *label() { return TXT_UNITS_PRES_HECTOPASCALS; }
+};
+
+struct PresPascals
+{
+  static constexpr int decimals = 0;
+  static constexpr bool spaced = true;
+  static float convert(float hpa) { return hectopascals_to_pascals(hpa); }
+  static const char *label() { return TXT_UNITS_PRES_PASCALS; }
+};
+
+struct PresMillimetersOfMercury
+{
+  static constexpr int decimals = 0;
+  static constexpr bool spaced = true;
+  static float convert(float hpa)
+  {
+    return hectopascals_to_millimetersofmercury(hpa);
+  }
+  static const char *label() { return TXT_UNITS_PRES_MILLIMETERSOFMERCURY; }
+};
+
+struct PresInchesOfMercury
+{
+  static constexpr int decimals = 1;
+  static constexpr bool spaced = true;
+  static float convert(float hpa)
+  {
+    return hectopascals_to_inchesofmercury(hpa);
+  }
+  static const char *label() { return TXT_UNITS_PRES_INCHESOFMERCURY; }
+};
+
+struct PresMillibars
+{
+  static constexpr int decimals = 0;
+  static constexpr bool spaced = true;
+  static float convert(float hpa) { return hectopascals_to_millibars(hpa); }
+  static const char *label() { return TXT_UNITS_PRES_MILLIBARS; }
+};
+
+struct PresAtmospheres
+{
+  static constexpr int decimals = 3;
+  static constexpr bool spaced = true;
+  static float convert(float hpa) { return hectopascals_to_atmospheres(hpa); }
+  static const char *label() { return TXT_UNITS_PRES_ATMOSPHERES; }
+};
+
+struct PresGramsPerSquareCentimeter
+{
+  static constexpr int decimals = 0;
+  static constexpr bool spaced = true;
+  static float convert(float hpa)
+  {
+    return hectopascals_to_gramspersquarecentimeter(hpa);
+  }
+  static const char *label()
+  {
+    return TXT_UNITS_PRES_GRAMSPERSQUARECENTIMETER;
+  }
+};
+
+struct PresPoundsPerSquareInch
+{
+  static constexpr int decimals = 2;
+  static constexpr bool spaced = true;
+  static float convert(float hpa)
+  {
+    return hectopascals_to_poundspersquareinch(hpa);
+  }
+  static const char *label() { return TXT_UNITS_PRES_POUNDSPERSQUAREINCH; }
+};
+
+// Visibility, from meters. Open-Meteo caps visibility, from cap up it is
+// shown as "> cap".
+struct DistKilometers
+{
+  static constexpr float cap = 10;
+  static constexpr bool spaced = true;
+  static float convert(float meters) { return meters_to_kilometers(meters); }
+  static const char *label() { return TXT_UNITS_DIST_KILOMETERS; }
+};
+
+struct DistMiles
+{
+  static constexpr float cap = 6;
+  static constexpr bool spaced = true;
+  static float convert(float meters) { return meters_to_miles(meters); }
+  static const char *label() { return TXT_UNITS_DIST_MILES; }
+};
+
+// Precipitation of the outlook graph, from an hour of the forecast.
+//   axisMax(max)       top of the axis for the largest value of the graph
+//   tickDecimals(top)  decimals of the axis labels
+//   labelWidth(top)    room right of the graph for the unit of the labels
+// decimals is the resolution Open-Meteo reports the value at.
+struct HourlyPrecipPop
+{
+  static constexpr int decimals = 0;
+  static constexpr bool spaced = false;
+  static float convert(const om_hourly_t &hour) { return hour.pop; }
+  static float axisMax(float max) { return max > 0 ? 100.0f : 0.0f; }
+  static int tickDecimals(float) { return 0; }
+  static int labelWidth(float) { return 23; }
+  static const char *label() { return "%"; }
+};
+
+struct HourlyPrecipMillimeters
+{
+  static constexpr int decimals = 2;
+  static constexpr bool spaced = true;
+  static float convert(const om_hourly_t &hour) { return hour.precipitation; }
+  static float axisMax(float max) { return std::ceil(max); }
+  static int tickDecimals(float top) { return top < 10; }
+  static int labelWidth(float) { return 24; }
+  static const char *label() { return TXT_UNITS_PRECIP_MILLIMETERS; }
+};
+
+struct HourlyPrecipCentimeters
+{
+  static constexpr int decimals = 3;
+  static constexpr bool spaced = true;
+  static float convert(const om_hourly_t &hour)
+  {
+    return millimeters_to_centimeters(hour.precipitation);
+  }
+  static float axisMax(float max) { return std::ceil(max * 10) / 10.0f; }
+  static int tickDecimals(float top) { return top < 1 ? 2 : top < 10; }
+  // labels below 1 cm need extra room
+  static int labelWidth(float top) { return top > 0 && top < 1 ? 31 : 25; }
+  static const char *label() { return TXT_UNITS_PRECIP_CENTIMETERS; }
+};
+
+struct HourlyPrecipInches
+{
+  static constexpr int decimals = 3;
+  static constexpr bool spaced = true;
+  static float convert(const om_hourly_t &hour)
+  {
+    return millimeters_to_inches(hour.precipitation);
+  }
+  static float axisMax(float max) { return std::ceil(max * 10) / 10.0f; }
+  static int tickDecimals(float top) { return top < 1 ? 2 : top < 10; }
+  static int labelWidth(float) { return 25; }
+  static const char *label() { return TXT_UNITS_PRECIP_INCHES; }
+};
+
+// Precipitation of the daily forecast, from a day of the forecast.
+struct DailyPrecipPop
+{
+  static constexpr int decimals = 0;
+  static constexpr bool spaced = false;
+  static float convert(const om_daily_t &day) { return day.pop; }
+  static const char *label() { return "%"; }
+};
+
+struct DailyPrecipMillimeters
+{
+  static constexpr int decimals = 0;
+  static constexpr bool spaced = true;
+  static float convert(const om_daily_t &day) { return day.precipitation; }
+  static const char *label() { return TXT_UNITS_PRECIP_MILLIMETERS; }
+};
+
+struct DailyPrecipCentimeters
+{
+  static constexpr int decimals = 1;
+  static constexpr bool spaced = true;
+  static float convert(const om_daily_t &day)
+  {
+    return millimeters_to_centimeters(day.precipitation);
+  }
+  static const char *label() { return TXT_UNITS_PRECIP_CENTIMETERS; }
+};
+
+struct DailyPrecipInches
+{
+  static constexpr int decimals = 1;
+  static constexpr bool spaced = true;
+  static float convert(const om_daily_t &day)
+  {
+    return millimeters_to_inches(day.precipitation);
+  }
+  static const char *label() { return TXT_UNITS_PRECIP_INCHES; }
+};
+
+/* Rounds a value in Unit to the decimals it is shown with.
+ */
+template<class Unit>
+inline float roundUnits(float value)
+{
+  return roundDecimals(value, Unit::decimals);
+}
+
+/* Appends a value in Unit, rounded to the decimals it is shown with.
+ */
+template<class Unit>
+inline size_t appendUnits(char *buf, size_t size, float value)
+{
+  if (Unit::decimals == 0)
+  {
+    return appendInt(buf, size, static_cast<long>(std::round(value)));
+  }
+  return appendFixed(buf, size, roundUnits<Unit>(value), Unit::decimals);
+}
+
+/* Appends the label of Unit, with the space before it if it takes one.
+ */
+template<class Unit>
+inline size_t appendUnitLabel(char *buf, size_t size)
+{
+  if (Unit::spaced)
+  {
+    appendStr(buf, size, " ");
+  }
+  return appendStr(buf, size, Unit::label());
+}
+
+// The units selected in config.h
+#if defined(UNITS_TEMP_KELVIN)
+using TempUnits = TempKelvin;
+#elif defined(UNITS_TEMP_CELSIUS)
+using TempUnits = TempCelsius;
+#elif defined(UNITS_TEMP_FAHRENHEIT)
+using TempUnits = TempFahrenheit;
+#endif
+
+#if defined(UNITS_SPEED_METERSPERSECOND)
+using SpeedUnits = SpeedMetersPerSecond;
+#elif defined(UNITS_SPEED_FEETPERSECOND)
+using SpeedUnits = SpeedFeetPerSecond;
+#elif defined(UNITS_SPEED_KILOMETERSPERHOUR)
+using SpeedUnits = SpeedKilometersPerHour;
+#elif defined(UNITS_SPEED_MILESPERHOUR)
+using SpeedUnits = SpeedMilesPerHour;
+#elif defined(UNITS_SPEED_KNOTS)
+using SpeedUnits = SpeedKnots;
+#elif defined(UNITS_SPEED_BEAUFORT)
+using SpeedUnits = SpeedBeaufort;
+#endif
+
+#if defined(UNITS_PRES_HECTOPASCALS)
+using PresUnits = PresHectopascals;
+#elif defined(UNITS_PRES_PASCALS)
+using PresUnits = PresPascals;
+#elif defined(UNITS_PRES_MILLIMETERSOFMERCURY)
+using PresUnits = PresMillimetersOfMercury;
+#elif defined(UNITS_PRES_INCHESOFMERCURY)
+using PresUnits = PresInchesOfMercury;
+#elif defined(UNITS_PRES_MILLIBARS)
+using PresUnits = PresMillibars;
+#elif defined(UNITS_PRES_ATMOSPHERES)
+using PresUnits = PresAtmospheres;
+#elif defined(UNITS_PRES_GRAMSPERSQUARECENTIMETER)
+using PresUnits = PresGramsPerSquareCentimeter;
+#elif defined(UNITS_PRES_POUNDSPERSQUAREINCH)
+using PresUnits = PresPoundsPerSquareInch;
+#endif
+
+#if defined(UNITS_DIST_KILOMETERS)
+using DistUnits = DistKilometers;
+#elif defined(UNITS_DIST_MILES)
+using DistUnits = DistMiles;
+#endif
+
+#if defined(UNITS_HOURLY_PRECIP_POP)
+using HourlyPrecipUnits = HourlyPrecipPop;
+#elif defined(UNITS_HOURLY_PRECIP_MILLIMETERS)
+using HourlyPrecipUnits = HourlyPrecipMillimeters;
+#elif defined(UNITS_HOURLY_PRECIP_CENTIMETERS)
+using HourlyPrecipUnits = HourlyPrecipCentimeters;
+#elif defined(UNITS_HOURLY_PRECIP_INCHES)
+using HourlyPrecipUnits = HourlyPrecipInches;
+#endif
+
+#if defined(UNITS_DAILY_PRECIP_POP)
+using DailyPrecipUnits = DailyPrecipPop;
+#elif defined(UNITS_DAILY_PRECIP_MILLIMETERS)
+using DailyPrecipUnits = DailyPrecipMillimeters;
+#elif defined(UNITS_DAILY_PRECIP_CENTIMETERS)
+using DailyPrecipUnits = DailyPrecipCentimeters;
+#elif defined(UNITS_DAILY_PRECIP_INCHES)
+using DailyPrecipUnits = DailyPrecipInches;
+#endif
+
+#endif
@@ -0,0 +1,44 @@
+/* Wake planner declarations for esp32-weather-epd.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __WAKE_PLANNER_H__
+#define __WAKE_PLANNER_H__
+
+#include <cstdint>
+#include "api_response.h"
+
+// Reason for a planned wake, in order of precedence when several coincide.
+typedef enum wake_event
+{
+  WAKE_EVENT_NONE,        // no transition within the max interval
+  WAKE_EVENT_PRECIP,      // precipitation starts
+  WAKE_EVENT_ICON,        // weather icon changes (weather code or day/night)
+  WAKE_EVENT_SUN,         // sunrise or sunset
+  WAKE_EVENT_TEMP,        // temperature drifts from the hour shown at wake
+  WAKE_EVENT_HOUR         // routine top-of-hour outlook graph shift
+} wake_event_t;
+
+typedef struct wake_plan
+{
+  int64_t      dt;        // Unix timestamp of the next wake
+  wake_event_t event;
+} wake_plan_t;
+
+wake_plan_t planNextWake(const om_hourly_t *hourly, const om_daily_t *daily,
+                         int64_t now, int64_t minSeconds, int64_t maxSeconds);
+
+#endif
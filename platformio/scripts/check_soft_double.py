@@ -0,0 +1,105 @@
+#!/usr/bin/env python3
+# Checks that the render and parse objects of the firmware don't call the
+# software double precision routines.
+# Copyright (C) 2026  Anthony Fenzl
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#
+# The ESP32 FPU is single precision only, libgcc does double arithmetic,
+# conversions and comparisons in software, and the double libm functions are
+# built on them. An object calling any of these has a double left in it.
+#
+# Run by PlatformIO after linking (extra_scripts = post:...), failing the
+# build, or by hand on objects built elsewhere:
+#   python3 scripts/check_soft_double.py <nm> <object>...
+import os
+import subprocess
+import sys
+
+# objects of the render and parse paths, in $BUILD_DIR/src
+OBJECTS = [
+    'api_response.cpp.o',
+    'conversions.cpp.o',
+    'display_state.cpp.o',
+    'display_utils.cpp.o',
+    'float_math.cpp.o',
+    'render_model.cpp.o',
+    'renderer.cpp.o',
+    'text_format.cpp.o',
+    'text_metrics.cpp.o',
+    'text_wrap.cpp.o',
+]
+
+SOFT_DOUBLE = {
+    # arithmetic
+    '__adddf3', '__subdf3', '__muldf3', '__divdf3', '__negdf2',
+    # conversions
+    '__extendsfdf2', '__truncdfsf2', '__fixdfsi', '__fixunsdfsi',
+    '__fixdfdi', '__fixunsdfdi', '__floatsidf', '__floatunsidf',
+    '__floatdidf', '__floatundidf',
+    # comparisons
+    '__eqdf2', '__nedf2', '__ltdf2', '__ledf2', '__gtdf2', '__gedf2',
+    '__unorddf2',
+    # double libm
+    'pow', 'sqrt', 'cbrt', 'exp', 'log', 'log10', 'round', 'lround', 'floor',
+    'ceil', 'fmod',
+}
+
+
+def soft_double_calls(nm, obj):
+    '''Returns the soft double routines obj calls, sorted.'''
+    out = subprocess.run([nm, '--undefined-only', obj], check=True,
+                         capture_output=True, text=True).stdout
+    names = {line.split()[-1] for line in out.splitlines() if line.strip()}
+    return sorted(names & SOFT_DOUBLE)
+
+
+def check(nm, objs):
+    '''Prints the objects calling soft double routines, returns their count.'''
+    failed = 0
+    for obj in objs:
+        calls = soft_double_calls(nm, obj)
+        if calls:
+            print(f'{os.path.basename(obj)} calls soft double routines: '
+                  f'{", ".join(calls)}')
+            failed += 1
+    return failed
+
+
+def after_link(source, target, env):
+    build_src = os.path.join(env.subst('$BUILD_DIR'), 'src')
+    objs = [os.path.join(build_src, o) for o in OBJECTS
+            if os.path.isfile(os.path.join(build_src, o))]
+    # the nm of the toolchain, next to its gcc, on the PATH PlatformIO builds
+    # with rather than the one of the OS
+    nm = env.WhereIs(os.path.basename(env.subst('$CC'))[:-len('gcc')] + 'nm')
+    if nm is None:
+        print('Warning: nm of the toolchain not found, soft double routines '
+              'not checked')
+        return
+    if check(nm, objs) > 0:
+        print('Error: soft double routines in the render and parse objects')
+        env.Exit(1)
+        return
+    print(f'No soft double routines in {len(objs)} render and parse objects')
+
+
+if __name__ == '__main__':
+    if len(sys.argv) < 3:
+        print(f'usage: {sys.argv[0]} <nm> <object>...')
+        sys.exit(2)
+    sys.exit(1 if check(sys.argv[1], sys.argv[2:]) > 0 else 0)
+else:
+    Import('env')  # noqa: F821 (provided by PlatformIO)
+    env.AddPostAction('$BUILD_DIR/${PROGNAME}.elf', after_link)  # noqa: F821
@@ -20,6 +20,7 @@
 
 #include "api_response.h"
 #include "config.h"
+#include "text_format.h"
 #include <time.h>
 
 // Parse ISO8601 datetime string to Unix timestamp
@@ -86,8 +87,11 @@ DeserializationError deserializeForecast(const String &json,
   r.current.is_day = current["is_day"] | 1;
 
 #if DEBUG_LEVEL >= 1
-  Serial.printf("[debug] Parsed temp (Celsius): %.2f, humidity: %d, pressure: %d\n",
-                r.current.temp, r.current.humidity, r.current.pressure);
+  // a float passed to printf() is promoted to double, format it here instead
+  char tempStr[16] = "";
+  appendFixed(tempStr, sizeof(tempStr), r.current.temp, 2);
+  Serial.printf("[debug] Parsed temp (Celsius): %s, humidity: %d, pressure: %d\n",
+                tempStr, r.current.humidity, r.current.pressure);
 #endif
 
   // Hourly forecast
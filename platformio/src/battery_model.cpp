@@ -0,0 +1,274 @@
+/* Battery discharge model for esp32-weather-epd.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "battery_model.h"
+
+#include <cmath>
+
+// A voltage rise larger than this between two samples means the battery was
+// charged or replaced, the old history no longer applies.
+#define BAT_RECHARGE_MV 100
+// Older samples are weighted down with this half-life, so the fit follows the
+// current part of the (non-linear) discharge curve.
+#define BAT_WEIGHT_HALF_LIFE (7 * 86400.f) // seconds
+// Window used to measure the recent consumption rate.
+#define BAT_RATE_WINDOW      (7 * 86400)   // seconds
+// Minimum history required before an estimate is made.
+#define BAT_MIN_SAMPLES      4
+#define BAT_MIN_SPAN         86400         // seconds
+
+/* Appends a sample to the discharge history, compacting it first if full.
+ *
+ * chargeMah is the charge consumed since the previous sample. The history is
+ * reset if the battery appears to have been recharged or the clock went
+ * backwards.
+ */
+void batHistoryAppend(bat_history_t &h, uint32_t dt, uint16_t mv,
+                      float chargeMah)
+{
+  if (h.count > BAT_HISTORY_SIZE)
+  {
+    h.count = 0; // corrupt
+  }
+  if (h.count > 0)
+  {
+    const bat_sample_t &last = h.samples[h.count - 1];
+    if (dt <= last.dt || mv > last.mv + BAT_RECHARGE_MV)
+    {
+      h.count = 0;
+    }
+  }
+  if (h.count == BAT_HISTORY_SIZE)
+  {
+    batHistoryCompact(h);
+  }
+
+  bat_sample_t &s = h.samples[h.count];
+  s.dt = dt;
+  s.mv = mv;
+  if (h.count == 0)
+  { // nothing to attribute the charge to
+    s.charge = 0;
+  }
+  else
+  {
+    float c = std::round(chargeMah * 100.f);
+    s.charge = (uint16_t) std::fmin(std::fmax(c, 0.f), 65535.f);
+  }
+  ++h.count;
+  return;
+} // end batHistoryAppend
+
+/* Frees a quarter of the history by merging adjacent pairs in its oldest half.
+ *
+ * This keeps the full span of the history, at a reduced resolution for the
+ * oldest part. A merged sample is placed at the average time and voltage of
+ * the pair. Half of the later sample's charge is carried forward to the next
+ * sample, so the running total still matches the merged point and no charge
+ * is lost.
+ */
+void batHistoryCompact(bat_history_t &h)
+{
+  const int half = (h.count / 2) & ~1;
+  if (half < 2)
+  {
+    return;
+  }
+
+  uint32_t carry = 0;
+  for (int i = 0; i < half; i += 2)
+  {
+    const bat_sample_t &a = h.samples[i];
+    const bat_sample_t &b = h.samples[i + 1];
+    bat_sample_t m;
+    m.dt = a.dt + (b.dt - a.dt) / 2;
+    m.mv = (uint16_t) ((a.mv + b.mv + 1) / 2);
+    uint32_t c = carry + a.charge + b.charge / 2;
+    m.charge = (uint16_t) (c > 65535 ? 65535 : c);
+    carry = b.charge - b.charge / 2;
+    h.samples[i / 2] = m;
+  }
+  uint32_t c = carry + h.samples[half].charge;
+  h.samples[half].charge = (uint16_t) (c > 65535 ? 65535 : c);
+
+  // shift the untouched newer half down
+  for (int i = half; i < h.count; ++i)
+  {
+    h.samples[i - half / 2] = h.samples[i];
+  }
+  h.count -= half / 2;
+  return;
+} // end batHistoryCompact
+
+/* Estimates the charge and time remaining until critMv is reached.
+ *
+ * Voltage is fit against cumulative charge consumed (weighted least squares,
+ * favouring recent samples), which gives the discharge slope independently of
+ * how often the device wakes. The remaining charge is then converted to time
+ * using the recent consumption rate.
+ *
+ * Returns false if there is not enough history, or the voltage is not (yet)
+ * measurably falling.
+ */
+bool batEstimate(const bat_history_t &h, uint32_t critMv, bat_estimate_t &e)
+{
+  e = {};
+  if (h.count < BAT_MIN_SAMPLES || h.count > BAT_HISTORY_SIZE)
+  {
+    return false;
+  }
+  const bat_sample_t &last = h.samples[h.count - 1];
+  if (last.dt - h.samples[0].dt < BAT_MIN_SPAN)
+  {
+    return false;
+  }
+
+  // cumulative charge (mAh) is measured backwards from the newest sample, so
+  // the fitted intercept is the voltage now
+  float q[BAT_HISTORY_SIZE];
+  float total = 0.f;
+  for (int i = h.count - 1; i >= 0; --i)
+  {
+    q[i] = -total;
+    total += h.samples[i].charge / 100.f;
+  }
+
+  // weighted means, voltages relative to the newest sample so that a flat
+  // voltage is exactly flat in single precision
+  float sw = 0.f, sq = 0.f, sv = 0.f;
+  for (int i = 0; i < h.count; ++i)
+  {
+    const float w = std::exp2((int32_t) (h.samples[i].dt - last.dt)
+                              / BAT_WEIGHT_HALF_LIFE);
+    sw += w;
+    sq += w * q[i];
+    sv += w * (h.samples[i].mv - last.mv);
+  }
+  const float mq = sq / sw;
+  const float mv = sv / sw;
+
+  // weighted covariance
+  float sqq = 0.f, sqv = 0.f;
+  for (int i = 0; i < h.count; ++i)
+  {
+    const float w = std::exp2((int32_t) (h.samples[i].dt - last.dt)
+                              / BAT_WEIGHT_HALF_LIFE);
+    const float dq = q[i] - mq;
+    sqq += w * dq * dq;
+    sqv += w * dq * (h.samples[i].mv - last.mv - mv);
+  }
+  if (sqq <= 1e-6f)
+  {
+    return false;
+  }
+  const float slope = sqv / sqq;
+  if (slope >= 0.f)
+  {
+    return false;
+  }
+  const float vNow = last.mv + mv - slope * mq;
+
+  // recent consumption rate
+  int k = h.count - 1;
+  while (k > 0 && last.dt - h.samples[k - 1].dt <= BAT_RATE_WINDOW)
+  {
+    --k;
+  }
+  if (k == h.count - 1)
+  {
+    k = h.count - 2;
+  }
+  const float rate = (0.f - q[k]) * 86400.f / (last.dt - h.samples[k].dt);
+  if (rate <= 0.f)
+  {
+    return false;
+  }
+
+  e.mv_per_mah  = slope;
+  e.mah_per_day = rate;
+  e.mah_left    = std::fmax((vNow - (float) critMv) / -slope, 0.f);
+  // a tiny rate would predict years, or overflow to infinity
+  e.days_left   = std::fmin(e.mah_left / rate, 9999.f);
+  return true;
+} // end batEstimate
+
+/* Returns the interquartile mean of n raw ADC samples, rounded to the nearest
+ * integer.
+ *
+ * The lowest and highest quarter of the samples are discarded before
+ * averaging, which rejects the occasional spike the ESP32 ADC produces (e.g.
+ * from WiFi/RF activity) while still averaging down the remaining noise.
+ *
+ * Note: samples is sorted in place.
+ */
+uint32_t filterAdcSamples(uint16_t *samples, size_t n)
+{
+  if (n == 0)
+  {
+    return 0;
+  }
+
+  // insertion sort, n is small
+  for (size_t i = 1; i < n; ++i)
+  {
+    uint16_t v = samples[i];
+    size_t j = i;
+    while (j > 0 && samples[j - 1] > v)
+    {
+      samples[j] = samples[j - 1];
+      --j;
+    }
+    samples[j] = v;
+  }
+
+  const size_t trim = n / 4;
+  uint32_t sum = 0;
+  for (size_t i = trim; i < n - trim; ++i)
+  {
+    sum += samples[i];
+  }
+  const uint32_t count = n - 2 * trim;
+  return (sum + count / 2) / count;
+} // end filterAdcSamples
+
+/* Returns the battery level for voltage v (millivolts). thresholds[l] is the
+ * voltage at which level l is entered, thresholds[BATTERY_OK] is unused.
+ *
+ * A level is entered as soon as v falls to its threshold, but is only left once
+ * v rises more than hysteresis millivolts above it. This keeps a reading that
+ * hovers around a threshold from flapping between the low battery screen and
+ * normal operation.
+ */
+battery_level_t batLevel(uint32_t v, battery_level_t prevLevel,
+                         const uint32_t thresholds[BATTERY_CRIT_LOW + 1],
+                         uint32_t hysteresis)
+{
+  battery_level_t level = BATTERY_OK;
+  for (int l = BATTERY_LOW; l <= BATTERY_CRIT_LOW; ++l)
+  {
+    uint32_t threshold = thresholds[l];
+    if (l <= prevLevel)
+    {
+      threshold += hysteresis;
+    }
+    if (v <= threshold)
+    {
+      level = static_cast<battery_level_t>(l);
+    }
+  }
+  return level;
+} // end batLevel
@@ -0,0 +1,298 @@
+/* Battery sensing utilities for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <Arduino.h>
+#include <driver/adc.h>
+#include <esp_adc_cal.h>
+
+#include "battery_utils.h"
+#include "config.h"
+
+// Number of ADC samples taken per battery reading. A burst of 32 samples takes
+// roughly 1ms.
+#define BATTERY_ADC_SAMPLES 32
+
+// The ADC characterization only depends on the chip's eFuse calibration, so it
+// is computed once and kept in RTC memory. (~40 bytes)
+RTC_DATA_ATTR static bool                          rtc_adc_chars_valid = false;
+RTC_DATA_ATTR static esp_adc_cal_characteristics_t rtc_adc_chars;
+
+// Minimum time between samples of the discharge history in NVS. Readings taken
+// in between are averaged and their charge accumulated in RTC memory, which
+// also limits NVS wear.
+#define BAT_HISTORY_INTERVAL (2 * 3600) // seconds
+// Any earlier time means the system time has not been synchronized yet.
+#define BAT_MIN_VALID_TIME   1577836800 // 2020-01-01T00:00:00Z
+
+RTC_DATA_ATTR static bool           rtc_bat_model_loaded    = false;
+RTC_DATA_ATTR static uint32_t       rtc_bat_last_dt         = 0;
+RTC_DATA_ATTR static float          rtc_bat_charge          = 0.f; // mAh
+RTC_DATA_ATTR static uint32_t       rtc_bat_mv_sum          = 0;
+RTC_DATA_ATTR static uint16_t       rtc_bat_mv_count        = 0;
+RTC_DATA_ATTR static bool           rtc_bat_estimate_valid  = false;
+RTC_DATA_ATTR static bat_estimate_t rtc_bat_estimate;
+
+RTC_DATA_ATTR static energy_budget_t rtc_energy_budget = {};
+
+// Phase durations of the current wake.
+static energy_trace_t energy_trace = {};
+static unsigned long  energy_phase_start[ENERGY_PHASE_COUNT] = {};
+
+/* Returns battery voltage in millivolts (mv).
+ */
+uint32_t readBatteryVoltage()
+{
+  uint16_t samples[BATTERY_ADC_SAMPLES];
+  adc_power_acquire();
+  for (int i = 0; i < BATTERY_ADC_SAMPLES; ++i)
+  {
+    samples[i] = analogRead(PIN_BAT_ADC);
+  }
+  adc_power_release();
+  uint32_t adc_val = filterAdcSamples(samples, BATTERY_ADC_SAMPLES);
+
+  // We will use the eFuse ADC calibration bits, to get accurate voltage
+  // readings. The DFRobot FireBeetle Esp32-E V1.0's ADC is 12 bit, and uses
+  // 11db attenuation, which gives it a measurable input voltage range of 150mV
+  // to 2450mV.
+  if (!rtc_adc_chars_valid)
+  {
+    // __attribute__((unused)) disables compiler warnings about this variable
+    // being unused (Clang, GCC) which is the case when DEBUG_LEVEL == 0.
+    esp_adc_cal_value_t val_type __attribute__((unused));
+    val_type = esp_adc_cal_characterize(ADC_UNIT_1, ADC_ATTEN_11db,
+                                        ADC_WIDTH_BIT_12, 1100, &rtc_adc_chars);
+    rtc_adc_chars_valid = true;
+
+#if DEBUG_LEVEL >= 1
+    if (val_type == ESP_ADC_CAL_VAL_EFUSE_VREF)
+    {
+      Serial.println("[debug] ADC Cal eFuse Vref");
+    }
+    else if (val_type == ESP_ADC_CAL_VAL_EFUSE_TP)
+    {
+      Serial.println("[debug] ADC Cal Two Point");
+    }
+    else
+    {
+      Serial.println("[debug] ADC Cal Default");
+    }
+#endif
+  }
+
+  uint32_t batteryVoltage = esp_adc_cal_raw_to_voltage(adc_val, &rtc_adc_chars);
+  // DFRobot FireBeetle Esp32-E V1.0 voltage divider (1M+1M), so readings are
+  // multiplied by 2.
+  batteryVoltage *= 2;
+  return batteryVoltage;
+} // end readBatteryVoltage
+
+/* Returns the battery level for voltage v (millivolts), see batLevel().
+ */
+battery_level_t getBatteryLevel(uint32_t v, battery_level_t prevLevel,
+                                uint32_t hysteresis)
+{
+  // thresholds indexed by the level they lead into
+  const uint32_t thresholds[] = {
+    0, // unused
+    LOW_BATTERY_VOLTAGE,
+    VERY_LOW_BATTERY_VOLTAGE,
+    CRIT_LOW_BATTERY_VOLTAGE
+  };
+  return batLevel(v, prevLevel, thresholds, hysteresis);
+} // end getBatteryLevel
+
+/* Feeds a battery reading (millivolts) into the discharge model.
+ *
+ * Readings are averaged in RTC memory and committed to the discharge history
+ * in NVS at most every BAT_HISTORY_INTERVAL, together with the charge consumed
+ * since the last sample. The estimate is refreshed whenever the history is
+ * loaded. Readings are only averaged until the system time is known.
+ */
+void updateBatteryModel(Preferences &prefs, uint32_t v, time_t now)
+{
+  rtc_bat_mv_sum += v;
+  ++rtc_bat_mv_count;
+  if (now < BAT_MIN_VALID_TIME)
+  {
+    return;
+  }
+  if (rtc_bat_model_loaded && now - rtc_bat_last_dt < BAT_HISTORY_INTERVAL)
+  {
+    return;
+  }
+
+  bat_history_t h;
+  if (prefs.getBytes("batHist", &h, sizeof(h)) != sizeof(h))
+  {
+    h.count = 0;
+  }
+
+  if (!rtc_bat_model_loaded && h.count > 0)
+  { // RTC memory was lost (reset/power-on), so the charge consumed since the
+    // last sample is unknown. Extrapolate it from the previous estimate.
+    rtc_bat_last_dt = h.samples[h.count - 1].dt;
+    bat_estimate_t e;
+    if (batEstimate(h, CRIT_LOW_BATTERY_VOLTAGE, e) && now > rtc_bat_last_dt)
+    {
+      rtc_bat_charge = e.mah_per_day * (now - rtc_bat_last_dt) / 86400.f;
+    }
+  }
+  rtc_bat_model_loaded = true;
+
+  if (h.count == 0 || now - rtc_bat_last_dt >= BAT_HISTORY_INTERVAL)
+  {
+    uint16_t mv = (rtc_bat_mv_sum + rtc_bat_mv_count / 2) / rtc_bat_mv_count;
+    batHistoryAppend(h, now, mv, rtc_bat_charge);
+    prefs.putBytes("batHist", &h, sizeof(h));
+    rtc_bat_last_dt  = now;
+    rtc_bat_charge   = 0.f;
+    rtc_bat_mv_sum   = 0;
+    rtc_bat_mv_count = 0;
+  }
+
+  rtc_bat_estimate_valid = batEstimate(h, CRIT_LOW_BATTERY_VOLTAGE,
+                                       rtc_bat_estimate);
+#if DEBUG_LEVEL >= 1
+  Serial.println("[debug] Battery history : " + String(h.count)
+                 + " samples");
+  if (rtc_bat_estimate_valid)
+  {
+    Serial.println("[debug] Battery model   : "
+                   + String(rtc_bat_estimate.mv_per_mah, 3) + "mV/mAh, "
+                   + String(rtc_bat_estimate.mah_per_day, 2) + "mAh/day, "
+                   + String(rtc_bat_estimate.mah_left, 0) + "mAh left, "
+                   + String(rtc_bat_estimate.days_left, 1) + " days left");
+  }
+#endif
+  return;
+} // end updateBatteryModel
+
+/* Gets the most recent time-to-empty estimate of the discharge model.
+ *
+ * Returns false if no estimate is available yet.
+ */
+bool getBatteryEstimate(bat_estimate_t &e)
+{
+  e = rtc_bat_estimate;
+  return rtc_bat_estimate_valid;
+} // end getBatteryEstimate
+
+/* Marks the start of a wake phase with a distinct current draw.
+ */
+void beginEnergyPhase(energy_phase_t phase)
+{
+  if (energy_phase_start[phase] == 0)
+  {
+    energy_phase_start[phase] = millis() | 1; // 0 means not running
+  }
+  return;
+} // end beginEnergyPhase
+
+/* Marks the end of a wake phase, adding its duration to the wake's trace.
+ */
+void endEnergyPhase(energy_phase_t phase)
+{
+  if (energy_phase_start[phase] != 0)
+  {
+    energy_trace.phase_ms[phase] += millis() - energy_phase_start[phase];
+    energy_phase_start[phase] = 0;
+  }
+  return;
+} // end endEnergyPhase
+
+/* Returns the energy policy derived from the battery life target.
+ */
+static energy_policy_t getEnergyPolicy()
+{
+  energy_policy_t p;
+  p.daily_mah      = BATTERY_CAPACITY / BATTERY_LIFE_TARGET;
+  p.sleep_ma       = BATTERY_SLEEP_CURRENT;
+  p.active_minutes = 24 * 60;
+  if (BED_TIME != WAKE_TIME)
+  {
+    p.active_minutes = ((BED_TIME - WAKE_TIME + 24) % 24) * 60;
+  }
+  p.min_interval   = SLEEP_DURATION_MIN;
+  p.max_interval   = SLEEP_DURATION_MAX;
+  p.step           = SLEEP_DURATION_STEP;
+  return p;
+} // end getEnergyPolicy
+
+/* Accumulates the charge consumed by this wake and the following deep sleep.
+ *
+ * The wake's charge is estimated from its measured phase durations. It is
+ * added to the discharge model and accounted against the energy budget. Interim
+ * wakes only count towards the balance, the charge per wake is that of regular
+ * updates.
+ */
+void accumulateBatteryCharge(unsigned long awakeMs, uint64_t sleepSeconds,
+                             bool interimWake)
+{
+  for (int i = 0; i < ENERGY_PHASE_COUNT; ++i)
+  {
+    endEnergyPhase(static_cast<energy_phase_t>(i));
+  }
+  energy_trace.awake_ms = awakeMs;
+
+  energy_currents_t c;
+  c.active                       = BATTERY_ACTIVE_CURRENT;
+  c.phase[ENERGY_PHASE_WIFI]     = BATTERY_WIFI_CURRENT;
+  c.phase[ENERGY_PHASE_DISPLAY]  = BATTERY_DISPLAY_CURRENT;
+  c.sleep                        = BATTERY_SLEEP_CURRENT;
+  const float wakeMah  = energyWakeCharge(energy_trace, c);
+  const float sleepMah = sleepSeconds / 3600.f * c.sleep;
+  rtc_bat_charge += wakeMah + sleepMah;
+
+  if (interimWake)
+  {
+    energyBudgetBalance(rtc_energy_budget, getEnergyPolicy(),
+                        wakeMah + sleepMah, awakeMs / 1000 + sleepSeconds);
+  }
+  else
+  {
+    energyBudgetUpdate(rtc_energy_budget, getEnergyPolicy(), wakeMah, sleepMah,
+                       awakeMs / 1000 + sleepSeconds);
+  }
+#if DEBUG_LEVEL >= 1
+  Serial.println("[debug] Wake energy     : "
+                 + String(energy_trace.awake_ms) + "ms awake, "
+                 + String(energy_trace.phase_ms[ENERGY_PHASE_WIFI]) + "ms wifi, "
+                 + String(energy_trace.phase_ms[ENERGY_PHASE_DISPLAY])
+                 + "ms display, " + String(wakeMah, 3) + "mAh");
+  Serial.println("[debug] Energy budget   : "
+                 + String(rtc_energy_budget.wake_mah, 3) + "mAh/wake, "
+                 + String(rtc_energy_budget.balance_mah, 2) + "mAh balance");
+#endif
+  return;
+} // end accumulateBatteryCharge
+
+/* Returns the sleep interval (minutes) between updates.
+ *
+ * With ADAPTIVE_SLEEP this is chosen from the energy budget to meet
+ * BATTERY_LIFE_TARGET, otherwise it is SLEEP_DURATION.
+ */
+int getSleepInterval()
+{
+#if ADAPTIVE_SLEEP
+  return energySleepInterval(rtc_energy_budget, getEnergyPolicy(),
+                             SLEEP_DURATION);
+#else
+  return SLEEP_DURATION;
+#endif
+} // end getSleepInterval
@@ -0,0 +1,281 @@
+/* Glyph and bitmap blitting for esp32-weather-epd.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "blit.h"
+
+#include <algorithm>
+
+/* Sets the pixels of row (1bpp, MSB first) that are 1 in bits to value, bits
+ * holding the 8 pixels from x on, MSB first. They cover 1 or 2 bytes of row.
+ */
+static inline void mergeBits(uint8_t *row, int16_t x, uint8_t bits, bool value)
+{
+  const uint16_t mask = static_cast<uint16_t>(bits) << (8 - (x & 7));
+  uint8_t *dst = row + (x >> 3);
+  if (value)
+  {
+    dst[0] |= mask >> 8;
+    if (mask & 0xFF)
+    {
+      dst[1] |= mask;
+    }
+  }
+  else
+  {
+    dst[0] &= ~(mask >> 8);
+    if (mask & 0xFF)
+    {
+      dst[1] &= ~mask;
+    }
+  }
+  return;
+} // end mergeBits
+
+/* Sets the pixels of glyph c of font, printed with the cursor at (x, y), to
+ * value in a 1bpp plane of w x h pixels (w a multiple of 8, rows of w / 8
+ * bytes, MSB first). The glyph is clipped to the plane. Returns the advance of
+ * the glyph, 0 if font doesn't have c.
+ *
+ * Glyph bitmaps are packed MSB first without padding between rows. Each row is
+ * copied 8 pixels at a time: 8 bits are taken from the bitmap at any bit
+ * offset, shifted to the x offset in the plane and merged into the 1 or 2
+ * bytes they cover. This is the same as Adafruit_GFX::drawChar() with a
+ * transparent background.
+ */
+uint8_t blitGlyph(uint8_t *plane, int16_t w, int16_t h, const GFXfont *font,
+                  uint8_t c, int16_t x, int16_t y, bool value)
+{
+  if (c < font->first || c > font->last)
+  {
+    return 0;
+  }
+  const GFXglyph &g = font->glyph[c - font->first];
+  const int16_t gx = x + g.xOffset;
+  const int16_t gy = y + g.yOffset;
+  // visible columns and rows of the glyph
+  const int16_t c0 = std::max(0, -gx);
+  const int16_t c1 = std::min<int16_t>(g.width, w - gx);
+  const int16_t r0 = std::max(0, -gy);
+  const int16_t r1 = std::min<int16_t>(g.height, h - gy);
+  const uint8_t *bitmap = font->bitmap + g.bitmapOffset;
+  const int16_t stride = w / 8;
+
+  for (int16_t r = r0; r < r1; ++r)
+  {
+    uint8_t *row = plane + (gy + r) * stride;
+    uint32_t bit = r * g.width + c0;
+    for (int16_t col = c0; col < c1; col += 8)
+    {
+      const int n = std::min(8, c1 - col);
+      const uint8_t *src = bitmap + (bit >> 3);
+      const int shift = bit & 7;
+      uint8_t bits = src[0] << shift;
+      if (shift + n > 8)
+      {
+        bits |= src[1] >> (8 - shift);
+      }
+      bits &= 0xFF << (8 - n);
+      mergeBits(row, gx + col, bits, value);
+      bit += n;
+    }
+  }
+  return g.xAdvance;
+} // end blitGlyph
+
+/* Sets the pixels of a bw x bh bitmap that are 0 (rows padded to whole bytes,
+ * MSB first), drawn with its top left corner at (x, y), to value in a 1bpp
+ * plane of w x h pixels (as for blitGlyph()). The bitmap is clipped to the
+ * plane. This is the same as drawInvertedBitmap() of GxEPD2.
+ *
+ * Where the bitmap and the plane are both byte aligned (x a multiple of 8, not
+ * clipped on the left) each byte is a straight masked copy. Otherwise bytes are
+ * shifted and merged into the 2 bytes they cover.
+ */
+void blitInvertedBitmap(uint8_t *plane, int16_t w, int16_t h,
+                        const uint8_t *bitmap, int16_t x, int16_t y,
+                        int16_t bw, int16_t bh, bool value)
+{
+  // visible columns and rows of the bitmap
+  const int16_t c0 = std::max(0, -x);
+  const int16_t c1 = std::min<int16_t>(bw, w - x);
+  const int16_t r0 = std::max(0, -y);
+  const int16_t r1 = std::min<int16_t>(bh, h - y);
+  if (c0 >= c1 || r0 >= r1)
+  {
+    return;
+  }
+  const int16_t stride = w / 8;
+  const int16_t srcStride = (bw + 7) / 8;
+  const bool aligned = (x & 7) == 0 && c0 == 0;
+
+  for (int16_t r = r0; r < r1; ++r)
+  {
+    const uint8_t *src = bitmap + r * srcStride;
+    uint8_t *row = plane + (y + r) * stride;
+    if (aligned)
+    {
+      uint8_t *dst = row + (x >> 3);
+      for (int16_t col = 0; col < c1; col += 8)
+      {
+        const uint8_t ink = ~*src++ & (0xFF << (8 - std::min(8, c1 - col)));
+        if (value)
+        {
+          *dst++ |= ink;
+        }
+        else
+        {
+          *dst++ &= ~ink;
+        }
+      }
+      continue;
+    }
+    for (int16_t col = c0; col < c1; col += 8)
+    {
+      const int n = std::min(8, c1 - col);
+      const int shift = col & 7;
+      uint8_t bits = src[col >> 3] << shift;
+      if (shift + n > 8)
+      {
+        bits |= src[(col >> 3) + 1] >> (8 - shift);
+      }
+      mergeBits(row, x + col, ~bits & (0xFF << (8 - n)), value);
+    }
+  }
+  return;
+} // end blitInvertedBitmap
+
+/* Sets the pixels of the pw x ph rectangle at (x, y) that are 1 in pattern to
+ * value in a 1bpp plane of w x h pixels (as for blitGlyph()). pattern is an 8x8
+ * tile anchored at (0, 0) of the plane, pattern[y % 8] holds row y with the
+ * pixel x % 8 == 0 as MSB, so it is already shifted to the bytes of the plane.
+ * The rectangle is clipped to the plane.
+ */
+void fillPattern(uint8_t *plane, int16_t w, int16_t h,
+                 int16_t x, int16_t y, int16_t pw, int16_t ph,
+                 const uint8_t pattern[8], bool value)
+{
+  const int16_t x0 = std::max<int16_t>(x, 0);
+  const int16_t x1 = std::min<int16_t>(x + pw, w) - 1;
+  const int16_t y0 = std::max<int16_t>(y, 0);
+  const int16_t y1 = std::min<int16_t>(y + ph, h) - 1;
+  if (x0 > x1 || y0 > y1)
+  {
+    return;
+  }
+  const int16_t stride = w / 8;
+  // pixels of the first and last byte inside the rectangle
+  const uint8_t firstMask = 0xFF >> (x0 & 7);
+  const uint8_t lastMask = 0xFF << (7 - (x1 & 7));
+
+  for (int16_t r = y0; r <= y1; ++r)
+  {
+    const uint8_t bits = pattern[r & 7];
+    if (bits == 0)
+    {
+      continue;
+    }
+    uint8_t *row = plane + r * stride;
+    for (int16_t b = x0 >> 3; b <= x1 >> 3; ++b)
+    {
+      uint8_t mask = bits;
+      if (b == x0 >> 3)
+      {
+        mask &= firstMask;
+      }
+      if (b == x1 >> 3)
+      {
+        mask &= lastMask;
+      }
+      row[b] = value ? (row[b] | mask) : (row[b] & ~mask);
+    }
+  }
+  return;
+} // end fillPattern
+
+/* Sets every step-th pixel from x0 to x1 (inclusive) of row y to value in a
+ * 1bpp plane of w x h pixels (as for blitGlyph()), step 1 to 8. The dots are
+ * clipped to the plane.
+ *
+ * The dots repeat every step bytes, so the bytes of one period, starting at the
+ * byte of x0, are built first and then written in turn.
+ */
+void drawDottedHLine(uint8_t *plane, int16_t w, int16_t h,
+                     int16_t x0, int16_t x1, int16_t y, uint8_t step,
+                     bool value)
+{
+  if (y < 0 || y >= h)
+  {
+    return;
+  }
+  if (x0 < 0)
+  { // first dot inside the plane
+    x0 += (-x0 + step - 1) / step * step;
+  }
+  x1 = std::min<int16_t>(x1, w - 1);
+  if (x0 > x1)
+  {
+    return;
+  }
+
+  uint8_t period[8] = {};
+  const int16_t base = x0 & ~7;
+  for (int16_t x = x0 - (x0 - base) / step * step; x < base + 8 * step;
+       x += step)
+  {
+    period[(x - base) >> 3] |= 0x80 >> ((x - base) & 7);
+  }
+
+  uint8_t *row = plane + y * (w / 8);
+  uint8_t i = 0;
+  for (int16_t b = x0 >> 3; b <= x1 >> 3; ++b)
+  {
+    uint8_t mask = period[i];
+    if (b == x0 >> 3)
+    { // no dots before x0
+      mask &= 0xFF >> (x0 & 7);
+    }
+    if (b == x1 >> 3)
+    {
+      mask &= 0xFF << (7 - (x1 & 7));
+    }
+    row[b] = value ? (row[b] | mask) : (row[b] & ~mask);
+    i = (i + 1 < step) ? i + 1 : 0;
+  }
+  return;
+} // end drawDottedHLine
+
+/* Sets len pixels of column x from row y down to value in a 1bpp plane of w x h
+ * pixels (as for blitGlyph()), clipped to the plane.
+ */
+void fillVLine(uint8_t *plane, int16_t w, int16_t h,
+               int16_t x, int16_t y, int16_t len, bool value)
+{
+  const int16_t y0 = std::max<int16_t>(y, 0);
+  const int16_t y1 = std::min<int16_t>(y + len, h);
+  if (x < 0 || x >= w || y0 >= y1)
+  {
+    return;
+  }
+  const int16_t stride = w / 8;
+  const uint8_t mask = 0x80 >> (x & 7);
+  uint8_t *dst = plane + y0 * stride + (x >> 3);
+  for (int16_t r = y0; r < y1; ++r, dst += stride)
+  {
+    *dst = value ? (*dst | mask) : (*dst & ~mask);
+  }
+  return;
+} // end fillVLine
@@ -18,6 +18,7 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include "battery_utils.h"
 #include "client_utils.h"
 #include "config.h"
 #include <HTTPClient.h>
@@ -46,6 +47,7 @@ static bool isRetryableError(int httpCode)
 
 wl_status_t startWiFi()
 {
+  beginEnergyPhase(ENERGY_PHASE_WIFI);
   WiFi.mode(WIFI_STA);
   WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
 
@@ -76,6 +78,7 @@ void killWiFi()
 {
   WiFi.disconnect();
   WiFi.mode(WIFI_OFF);
+  endEnergyPhase(ENERGY_PHASE_WIFI);
 }
 
 bool waitForSNTPSync()
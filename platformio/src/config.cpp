@@ -132,10 +132,57 @@ const uint32_t VERY_LOW_BATTERY_VOLTAGE = 3442; // (millivolts)  ~8%
 const uint32_t CRIT_LOW_BATTERY_VOLTAGE = 3404; // (millivolts)  ~5%
 const unsigned long LOW_BATTERY_SLEEP_INTERVAL      = 30;  // (minutes)
 const unsigned long VERY_LOW_BATTERY_SLEEP_INTERVAL = 120; // (minutes)
+// Once a battery level above has been entered, the voltage must rise this far
+// above its threshold before it is left again. Prevents a noisy reading near a
+// threshold from flapping between the low battery screen and normal operation.
+// Should be smaller than the gaps between the thresholds above.
+const uint32_t BATTERY_VOLTAGE_HYSTERESIS = 15; // (millivolts)
+// Average current draw while awake (CPU only), while WiFi is on, while the
+// display is powered and while in deep sleep. These are used to estimate the
+// charge consumed by each wake from how long each was on. The battery discharge
+// model relates this to the measured voltage drop to predict time-to-empty.
+const float BATTERY_ACTIVE_CURRENT  = 40.f;   // (milliamps)
+const float BATTERY_WIFI_CURRENT    = 120.f;  // (milliamps)
+const float BATTERY_DISPLAY_CURRENT = 45.f;   // (milliamps)
+const float BATTERY_SLEEP_CURRENT   = 0.014f; // (milliamps)
 // Battery voltage calculations are based on a typical 3.7v LiPo.
 const uint32_t MAX_BATTERY_VOLTAGE = 4200; // (millivolts)
 const uint32_t MIN_BATTERY_VOLTAGE = 3000; // (millivolts)
 
+// ADAPTIVE SLEEP
+// When ADAPTIVE_SLEEP is enabled in config.h, SLEEP_DURATION is only used until
+// the charge per wake is known. The interval is then chosen so that a full
+// battery of BATTERY_CAPACITY lasts BATTERY_LIFE_TARGET days, rounded up to a
+// multiple of SLEEP_DURATION_STEP and kept within the bounds below.
+// The bounds also apply to wakes planned when WAKE_PLANNER is enabled.
+const float BATTERY_CAPACITY    = 2000.f; // (milliamp hours)
+const int   BATTERY_LIFE_TARGET = 60;     // (days)
+const int   SLEEP_DURATION_MIN  = 15;     // (minutes)
+const int   SLEEP_DURATION_MAX  = 240;    // (minutes)
+const int   SLEEP_DURATION_STEP = 15;     // (minutes)
+
+// INTERIM WAKES
+// When INTERIM_WAKES is enabled in config.h, the indoor conditions and status
+// bar are refreshed this often between full updates. After
+// INTERIM_FULL_REFRESH_CYCLES partial refreshes the next wake is a full update,
+// which refreshes the display in full to clear ghosting.
+const int INTERIM_WAKE_INTERVAL       = 10; // (minutes)
+const int INTERIM_FULL_REFRESH_CYCLES = 12;
+
+// DIFFERENTIAL REFRESH
+// When FRAME_DIFF is enabled in config.h, a full refresh is done instead of
+// partial refreshes once more than FRAME_DIFF_MAX_AREA of the display changed,
+// or after FRAME_DIFF_FULL_REFRESH_CYCLES partial refreshes to clear ghosting.
+// The update after interim wakes redrew the display is always a full refresh.
+const float FRAME_DIFF_MAX_AREA            = 0.5f; // (fraction of display)
+const int   FRAME_DIFF_FULL_REFRESH_CYCLES = 24;
+
+// SKIP UNCHANGED UPDATES
+// When SKIP_UNCHANGED_DISPLAY is enabled in config.h, an unchanged display is
+// still refreshed once it is this old, so the last refresh time shown in the
+// status bar never falls too far behind.
+const int UNCHANGED_DISPLAY_MAX_AGE = 180; // (minutes)
+
 // See config.h for the below options
 // E-PAPER PANEL
 // LOCALE
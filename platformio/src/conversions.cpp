@@ -17,8 +17,6 @@
 
 #include "conversions.h"
 
-#include <cmath>
-
 float kelvin_to_celsius(float kelvin)
 {
   return kelvin - 273.15f;
@@ -59,14 +57,22 @@ float kilometersperhour_to_knots(float kilometersperhour)
   return kilometersperhour * 0.5400f;
 } // end kilometersperhour_to_knots
 
+// Lowest speed (km/h) of Beaufort numbers 1 to 12. Beaufort number B is
+// v = 0.836 B^1.5 m/s, rounded to the nearest number, so B starts at
+// 3.6 * 0.836 (B - 0.5)^1.5 km/h.
+static const float BEAUFORT_MIN_KILOMETERSPERHOUR[12] = {
+    1.064054f,  5.528987f, 11.896487f,  19.706560f,  28.729464f,  38.819752f,
+   49.874519f, 61.815960f, 74.582527f,  88.123985f, 102.398285f, 117.369560f};
+
 int kilometersperhour_to_beaufort(float kilometersperhour)
 {
-  // Beaufort scale uses m/s, so convert first
-  float meterspersecond = kilometersperhour / 3.6f;
-  int beaufort = (int) ((powf( 1 / 0.836f, 2.f/3.f)
-                         * powf(meterspersecond, 2.f/3.f))
-                        + .5f);
-  return beaufort > 12 ? 12 : beaufort;
+  int beaufort = 0;
+  while (beaufort < 12
+      && kilometersperhour >= BEAUFORT_MIN_KILOMETERSPERHOUR[beaufort])
+  {
+    ++beaufort;
+  }
+  return beaufort;
 } // end kilometersperhour_to_beaufort
 
 float hectopascals_to_pascals(float hectopascals)
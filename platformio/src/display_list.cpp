@@ -0,0 +1,209 @@
+/* Display list for esp32-weather-epd.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "display_list.h"
+
+#include <algorithm>
+#include <cstring>
+
+/* Returns the number of bytes of memory a display list needs.
+ */
+size_t dlMemSize()
+{
+  return DL_MAX_CMDS * sizeof(dl_cmd_t) + DL_MAX_TEXT;
+} // end dlMemSize
+
+/* Initializes an empty display list in mem, which must be dlMemSize() bytes.
+ */
+void dlInit(display_list_t &dl, void *mem)
+{
+  dl.cmds     = static_cast<dl_cmd_t *>(mem);
+  dl.text     = reinterpret_cast<char *>(dl.cmds + DL_MAX_CMDS);
+  dl.num_cmds = 0;
+  dl.text_len = 0;
+  dl.overflow = false;
+  return;
+} // end dlInit
+
+/* Folds the last command into the one before it, if both are single rows of
+ * pixels with the same columns that continue the same vertical step. Drawing
+ * loops that hatch an area row by row become a single command this way.
+ */
+static void foldRows(display_list_t &dl)
+{
+  if (dl.num_cmds < 2)
+  {
+    return;
+  }
+  const dl_cmd_t &cur = dl.cmds[dl.num_cmds - 1];
+  dl_cmd_t &prev = dl.cmds[dl.num_cmds - 2];
+  if (cur.op != DL_OP_PIXELS || prev.op != DL_OP_PIXELS
+   || cur.color != prev.color || cur.f != 1
+   || cur.a != prev.a || cur.c != prev.c || cur.d != prev.d)
+  {
+    return;
+  }
+  if (prev.f == 1 && cur.b != prev.b)
+  {
+    prev.e = cur.b - prev.b;
+  }
+  else if (prev.f == 1 || cur.b != prev.b + prev.e * prev.f)
+  {
+    return;
+  }
+  ++prev.f;
+  prev.y0 = std::min(prev.y0, cur.y0);
+  prev.y1 = std::max(prev.y1, cur.y1);
+  --dl.num_cmds;
+  return;
+} // end foldRows
+
+/* Appends a command, or returns nullptr and marks the list as overflowed if it
+ * is full.
+ */
+static dl_cmd_t *push(display_list_t &dl, dl_op_t op, uint16_t color,
+                      int16_t y0, int16_t y1)
+{
+  foldRows(dl);
+  if (dl.num_cmds >= DL_MAX_CMDS)
+  {
+    dl.overflow = true;
+    return nullptr;
+  }
+  dl_cmd_t &cmd = dl.cmds[dl.num_cmds++];
+  memset(&cmd, 0, sizeof(cmd));
+  cmd.op    = op;
+  cmd.color = color;
+  cmd.y0    = y0;
+  cmd.y1    = y1;
+  return &cmd;
+} // end push
+
+/* Records a pixel. Pixels that continue an evenly spaced run on the same row
+ * extend the last command instead of adding one.
+ */
+void dlPixel(display_list_t &dl, int16_t x, int16_t y, uint16_t color)
+{
+  if (dl.num_cmds > 0)
+  {
+    dl_cmd_t &last = dl.cmds[dl.num_cmds - 1];
+    if (last.op == DL_OP_PIXELS && last.f == 1 && last.color == color
+     && last.b == y)
+    {
+      if (last.d == 1 && x > last.a)
+      {
+        last.c = x - last.a;
+        last.d = 2;
+        return;
+      }
+      if (last.d > 1 && x == last.a + last.c * last.d)
+      {
+        ++last.d;
+        return;
+      }
+    }
+  }
+  dl_cmd_t *cmd = push(dl, DL_OP_PIXELS, color, y, y);
+  if (cmd != nullptr)
+  {
+    cmd->a = x;
+    cmd->b = y;
+    cmd->d = 1;
+    cmd->f = 1;
+  }
+  return;
+} // end dlPixel
+
+/* Records a line.
+ */
+void dlLine(display_list_t &dl, int16_t x0, int16_t y0,
+            int16_t x1, int16_t y1, uint16_t color)
+{
+  dl_cmd_t *cmd = push(dl, DL_OP_LINE, color,
+                       std::min(y0, y1), std::max(y0, y1));
+  if (cmd != nullptr)
+  {
+    cmd->a = x0;
+    cmd->b = y0;
+    cmd->c = x1;
+    cmd->d = y1;
+  }
+  return;
+} // end dlLine
+
+/* Records an inverted bitmap. The bitmap must stay valid until the list is
+ * replayed (icons are in flash).
+ */
+void dlBitmap(display_list_t &dl, const uint8_t *bitmap,
+              int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+  dl_cmd_t *cmd = push(dl, DL_OP_BITMAP, color, y, y + h - 1);
+  if (cmd != nullptr)
+  {
+    cmd->a   = x;
+    cmd->b   = y;
+    cmd->c   = w;
+    cmd->d   = h;
+    cmd->ptr = bitmap;
+  }
+  return;
+} // end dlBitmap
+
+/* Records a run of text printed at cursor (x, y), whose glyphs span rows y0 to
+ * y1. The text is copied into the list.
+ */
+void dlText(display_list_t &dl, const void *font, int16_t x, int16_t y,
+            const char *text, uint16_t len, int16_t y0, int16_t y1,
+            uint16_t color)
+{
+  if (len == 0 || y0 > y1)
+  { // nothing visible
+    return;
+  }
+  if (dl.text_len + len > DL_MAX_TEXT)
+  {
+    dl.overflow = true;
+    return;
+  }
+  dl_cmd_t *cmd = push(dl, DL_OP_TEXT, color, y0, y1);
+  if (cmd != nullptr)
+  {
+    memcpy(dl.text + dl.text_len, text, len);
+    cmd->a   = x;
+    cmd->b   = y;
+    cmd->c   = dl.text_len;
+    cmd->d   = len;
+    cmd->ptr = font;
+    dl.text_len += len;
+  }
+  return;
+} // end dlText
+
+/* Completes a display list before it is replayed.
+ */
+void dlFinish(display_list_t &dl)
+{
+  foldRows(dl);
+  return;
+} // end dlFinish
+
+/* Returns true if the command draws anything on rows y0 to y1 (inclusive).
+ */
+bool dlIntersects(const dl_cmd_t &cmd, int16_t y0, int16_t y1)
+{
+  return cmd.y1 >= y0 && cmd.y0 <= y1;
+} // end dlIntersects
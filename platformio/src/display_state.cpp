@@ -0,0 +1,325 @@
+/* Displayed state tracking for esp32-weather-epd.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "display_state.h"
+
+#include <cmath>
+#include <cstring>
+#include <esp_attr.h>
+#include "_strftime.h"
+#include "config.h"
+#include "display_utils.h"
+#include "float_math.h"
+#include "units.h"
+
+// Hash of the values shown by the last full render, 0 if the content of the
+// panel is unknown.
+RTC_DATA_ATTR static uint32_t rtc_display_hash = 0;
+RTC_DATA_ATTR static int64_t  rtc_display_time = 0;
+
+/* FNV-1a over a block of memory.
+ */
+static uint32_t hashBytes(uint32_t h, const void *data, size_t len)
+{
+  const uint8_t *p = static_cast<const uint8_t *>(data);
+  for (size_t i = 0; i < len; ++i)
+  {
+    h = (h ^ p[i]) * 16777619u;
+  }
+  return h;
+} // end hashBytes
+
+static uint32_t hashInt(uint32_t h, int32_t v)
+{
+  return hashBytes(h, &v, sizeof(v));
+}
+
+static uint32_t hashPtr(uint32_t h, const void *p)
+{
+  return hashBytes(h, &p, sizeof(p));
+}
+
+static uint32_t hashStr(uint32_t h, const char *s)
+{
+  // include the terminator so that consecutive strings can't run together
+  return hashBytes(h, s, strlen(s) + 1);
+}
+
+/* Rounds v to the given number of decimals and returns it as an integer, ie.
+ * the value as it is shown with that many digits after the decimal point.
+ */
+static int32_t quantize(float v, int decimals)
+{
+  return static_cast<int32_t>(std::round(v * powerOfTen(decimals)));
+}
+
+/* Hashes a time formatted the way it is shown.
+ */
+static uint32_t hashTime(uint32_t h, int64_t dt, const char *format)
+{
+  char buf[12] = {}; // big enough to accommodate "hh:mm:ss am"
+  time_t ts = dt;
+  tm timeInfo = {};
+  localtime_r(&ts, &timeInfo);
+  _strftime(buf, sizeof(buf), format, &timeInfo);
+  return hashStr(h, buf);
+}
+
+/* Hashes the current conditions icon, temperature and feels like.
+ */
+template<class Temp = TempUnits>
+static uint32_t hashCurrentHeader(uint32_t h, const render_model_t &model,
+                                  const om_current_t &current)
+{
+  h = hashPtr(h, model.current_icon);
+  h = hashInt(h, quantize(Temp::convert(current.temp), 0));
+  h = hashInt(h, quantize(Temp::convert(current.feels_like), 0));
+  return h;
+} // end hashCurrentHeader
+
+/* Hashes the current conditions, each widget at the precision it is shown at.
+ * See drawCurrentConditions().
+ */
+static uint32_t hashCurrentConditions(uint32_t h, const render_model_t &model,
+                                      const om_current_t &current,
+                                      const om_resp_air_quality_t &air_quality,
+                                      float inTemp, float inHumidity)
+{
+  h = hashCurrentHeader(h, model, current);
+
+#ifdef POS_SUNRISE
+  h = hashTime(h, current.sunrise, TIME_FORMAT);
+#endif
+#ifdef POS_SUNSET
+  h = hashTime(h, current.sunset, TIME_FORMAT);
+#endif
+#ifdef POS_WIND
+#ifdef WIND_INDICATOR_ARROW
+  h = hashPtr(h, model.wind_icon);
+#endif
+  h = hashInt(h, quantize(SpeedUnits::convert(current.wind_speed),
+                          SpeedUnits::decimals));
+#if defined(WIND_INDICATOR_NUMBER)
+  h = hashInt(h, current.wind_deg);
+#endif
+#if defined(WIND_INDICATOR_CPN_CARDINAL)                \
+ || defined(WIND_INDICATOR_CPN_INTERCARDINAL)           \
+ || defined(WIND_INDICATOR_CPN_SECONDARY_INTERCARDINAL) \
+ || defined(WIND_INDICATOR_CPN_TERTIARY_INTERCARDINAL)
+  h = hashPtr(h, model.wind_compass);
+#endif
+#endif // POS_WIND
+#ifdef POS_HUMIDITY
+  h = hashInt(h, current.humidity);
+#endif
+#ifdef POS_UVI
+  h = hashInt(h, model.uvi);
+#endif
+#ifdef POS_PRESSURE
+  h = hashInt(h, quantize(PresUnits::convert(current.pressure),
+                          PresUnits::decimals));
+#endif // POS_PRESSURE
+#ifdef POS_VISIBILITY
+  float vis = DistUnits::convert(current.visibility);
+  // one decimal below 1.95, whole units above, capped with "> "
+  h = hashInt(h, vis < 1.95f ? quantize(vis, 1) : 1000 + quantize(vis, 0));
+  h = hashInt(h, vis >= DistUnits::cap);
+#endif // POS_VISIBILITY
+#ifdef POS_AIR_QULITY
+  h = hashInt(h, air_quality.aqi);
+#endif
+#ifdef POS_INTEMP
+  if (std::isnan(inTemp))
+  {
+    h = hashInt(h, INT32_MIN);
+  }
+  else
+  {
+    h = hashInt(h, quantize(TempUnits::convert(inTemp), TempUnits::decimals));
+  }
+#endif
+#ifdef POS_INHUMIDITY
+  h = hashInt(h, std::isnan(inHumidity) ? INT32_MIN : quantize(inHumidity, 0));
+#endif
+#ifdef POS_DEWPOINT
+  if (std::isnan(model.dew_point))
+  {
+    h = hashInt(h, INT32_MIN);
+  }
+  else
+  {
+    h = hashInt(h, quantize(TempUnits::convert(model.dew_point),
+                            TempUnits::decimals));
+  }
+#endif
+  return h;
+} // end hashCurrentConditions
+
+/* Hashes the five day forecast. See drawForecast().
+ */
+template<class Temp = TempUnits, class Precip = DailyPrecipUnits>
+static uint32_t hashForecast(uint32_t h, const render_model_t &model,
+                             const om_daily_t *daily, int wday)
+{
+  h = hashInt(h, wday);
+  for (int i = 0; i < 5; ++i)
+  {
+    h = hashPtr(h, model.daily_icon[i]);
+    h = hashInt(h, quantize(Temp::convert(daily[i].temp_max), 0));
+    h = hashInt(h, quantize(Temp::convert(daily[i].temp_min), 0));
+#if DISPLAY_DAILY_PRECIP
+    h = hashInt(h, quantize(Precip::convert(daily[i]), Precip::decimals));
+#endif
+  }
+  return h;
+} // end hashForecast
+
+/* Hashes the outlook graph. See drawOutlookGraph().
+ *
+ * The temperatures and precipitation are hashed as the pixel rows they are
+ * plotted at, and the axis bounds as the labels they are shown with.
+ */
+static uint32_t hashOutlookGraph(uint32_t h, const render_model_t &model,
+                                 const om_hourly_t *hourly)
+{
+  for (int i = 0; i < HOURLY_GRAPH_MAX; ++i)
+  {
+    h = hashInt(h, model.temp_y[i]);
+    h = hashInt(h, model.precip_y[i]);
+    h = hashBytes(h, &hourly[i].dt, sizeof(hourly[i].dt));
+    h = hashPtr(h, model.hourly_icon[i]);
+  }
+  h = hashInt(h, model.temp_bound_min);
+  h = hashInt(h, model.temp_bound_max);
+  h = hashInt(h, model.temp_tick);
+  h = hashBytes(h, &model.precip_bound_max, sizeof(model.precip_bound_max));
+  return h;
+} // end hashOutlookGraph
+
+/* Hashes the status bar. See drawStatusBar().
+ *
+ * The last refresh time is left out, so that it keeps showing when the
+ * displayed values were last updated.
+ */
+static uint32_t hashStatusBar(uint32_t h, const String &statusStr, int rssi,
+                              uint32_t batVoltage, float batDaysLeft)
+{
+#if BATTERY_MONITORING
+  uint32_t batPercent = calcBatPercent(batVoltage,
+                                       MIN_BATTERY_VOLTAGE,
+                                       MAX_BATTERY_VOLTAGE);
+  h = hashInt(h, batPercent);
+#if defined(DISP_3C_B) || defined(DISP_7C_F)
+  h = hashInt(h, batVoltage < WARN_BATTERY_VOLTAGE);
+#endif
+#if STATUS_BAR_EXTRAS_BAT_VOLTAGE
+  h = hashInt(h, quantize(batVoltage / 1000.f, 2));
+#endif
+#if STATUS_BAR_EXTRAS_BAT_DAYS_LEFT
+  h = hashInt(h, std::isnan(batDaysLeft)
+                 ? -1 : static_cast<int>(std::fmin(batDaysLeft, 999.f)));
+#endif
+#endif
+  h = hashInt(h, rssi >= -70);
+  h = hashPtr(h, getWiFiBitmap16(rssi));
+#if STATUS_BAR_EXTRAS_WIFI_STRENGTH
+  h = hashPtr(h, getWiFidesc(rssi));
+#endif
+#if STATUS_BAR_EXTRAS_WIFI_RSSI
+  h = hashInt(h, rssi);
+#endif
+  h = hashStr(h, statusStr.c_str());
+  return h;
+} // end hashStatusBar
+
+/* Reduces everything a full render would show to the precision it is shown at
+ * (rounded values, icons, graph coordinates, strings) and hashes it. Equal
+ * hashes mean the rendered frames would look the same.
+ */
+uint32_t hashDisplayState(const render_model_t &model,
+                          const om_current_t &current,
+                          const om_hourly_t *hourly, const om_daily_t *daily,
+                          const om_resp_air_quality_t &air_quality,
+                          float inTemp, float inHumidity,
+                          const String &city, const String &date,
+                          const String &statusStr, int rssi,
+                          uint32_t batVoltage, float batDaysLeft,
+                          const tm &timeInfo)
+{
+  uint32_t h = 2166136261u;
+  h = hashCurrentConditions(h, model, current, air_quality,
+                            inTemp, inHumidity);
+  h = hashOutlookGraph(h, model, hourly);
+  h = hashForecast(h, model, daily, timeInfo.tm_wday);
+  h = hashStr(h, city.c_str());
+  h = hashStr(h, date.c_str());
+  h = hashStatusBar(h, statusStr, rssi, batVoltage, batDaysLeft);
+  // 0 is reserved for an unknown panel
+  return h != 0 ? h : 1;
+} // end hashDisplayState
+
+/* Hashes what the current conditions icon, temperature and feels like show.
+ */
+template<class Temp>
+uint32_t hashCurrentHeaderState(const render_model_t &model,
+                                const om_current_t &current)
+{
+  return hashCurrentHeader<Temp>(2166136261u, model, current);
+} // end hashCurrentHeaderState
+template uint32_t hashCurrentHeaderState<TempUnits>(
+  const render_model_t &model, const om_current_t &current);
+
+/* Hashes what the five day forecast shows, starting on weekday wday.
+ */
+template<class Temp, class Precip>
+uint32_t hashForecastState(const render_model_t &model,
+                           const om_daily_t *daily, int wday)
+{
+  return hashForecast<Temp, Precip>(2166136261u, model, daily, wday);
+} // end hashForecastState
+template uint32_t hashForecastState<TempUnits, DailyPrecipUnits>(
+  const render_model_t &model, const om_daily_t *daily, int wday);
+
+/* Returns true if the panel already shows a frame with this hash, and that
+ * frame is not older than UNCHANGED_DISPLAY_MAX_AGE.
+ */
+bool isDisplayCurrent(uint32_t hash, int64_t now)
+{
+  if (rtc_display_hash == 0 || hash != rtc_display_hash)
+  {
+    return false;
+  }
+  const int64_t age = now - rtc_display_time;
+  return age >= 0 && age < UNCHANGED_DISPLAY_MAX_AGE * 60LL;
+} // end isDisplayCurrent
+
+/* Records the hash of the frame that was just fully rendered.
+ */
+void setDisplayState(uint32_t hash, int64_t now)
+{
+  rtc_display_hash = hash;
+  rtc_display_time = now;
+  return;
+} // end setDisplayState
+
+/* Forgets what the panel shows. Called whenever the panel is drawn to.
+ */
+void invalidateDisplayState()
+{
+  rtc_display_hash = 0;
+  return;
+} // end invalidateDisplayState
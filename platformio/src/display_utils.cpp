@@ -17,8 +17,6 @@
 
 #include <cmath>
 #include <Arduino.h>
-#include <driver/adc.h>
-#include <esp_adc_cal.h>
 
 #include "_locale.h"
 #include "_strftime.h"
@@ -33,47 +31,6 @@
 template <int BitmapSize>
 const uint8_t *getIconFromWMO(int code, bool is_day);
 
-/* Returns battery voltage in millivolts (mv).
- */
-uint32_t readBatteryVoltage()
-{
-  esp_adc_cal_characteristics_t adc_chars;
-  // __attribute__((unused)) disables compiler warnings about this variable
-  // being unused (Clang, GCC) which is the case when DEBUG_LEVEL == 0.
-  esp_adc_cal_value_t val_type __attribute__((unused));
-  adc_power_acquire();
-  uint16_t adc_val = analogRead(PIN_BAT_ADC);
-  adc_power_release();
-
-  // We will use the eFuse ADC calibration bits, to get accurate voltage
-  // readings. The DFRobot FireBeetle Esp32-E V1.0's ADC is 12 bit, and uses
-  // 11db attenuation, which gives it a measurable input voltage range of 150mV
-  // to 2450mV.
-  val_type = esp_adc_cal_characterize(ADC_UNIT_1, ADC_ATTEN_11db,
-                                      ADC_WIDTH_BIT_12, 1100, &adc_chars);
-
-#if DEBUG_LEVEL >= 1
-  if (val_type == ESP_ADC_CAL_VAL_EFUSE_VREF)
-  {
-    Serial.println("[debug] ADC Cal eFuse Vref");
-  }
-  else if (val_type == ESP_ADC_CAL_VAL_EFUSE_TP)
-  {
-    Serial.println("[debug] ADC Cal Two Point");
-  }
-  else
-  {
-    Serial.println("[debug] ADC Cal Default");
-  }
-#endif
-
-  uint32_t batteryVoltage = esp_adc_cal_raw_to_voltage(adc_val, &adc_chars);
-  // DFRobot FireBeetle Esp32-E V1.0 voltage divider (1M+1M), so readings are
-  // multiplied by 2.
-  batteryVoltage *= 2;
-  return batteryVoltage;
-} // end readBatteryVoltage
-
 /* Returns battery percentage, rounded to the nearest integer.
  * Takes a voltage in millivolts and uses a sigmoidal approximation to find an
  * approximation of the battery life percentage remaining.
@@ -94,8 +51,10 @@ uint32_t calcBatPercent(uint32_t v, uint32_t minv, uint32_t maxv)
   // steep
   //uint32_t p = 102 - (102 / (1 + pow(1.621 * (v - minv)/(maxv - minv), 8.1)));
 
-  // normal
-  uint32_t p = 105 - (105 / (1 + pow(1.724 * (v - minv)/(maxv - minv), 5.5)));
+  // normal, x^5.5 as x^5 * sqrt(x) in single precision
+  const float x = 1.724f * (v - minv) / (maxv - minv);
+  const float x2 = x * x;
+  uint32_t p = 105 - (105 / (1 + x2 * x2 * x * std::sqrt(x)));
   return p >= 100 ? 100 : p;
 } // end calcBatPercent
 
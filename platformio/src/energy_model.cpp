@@ -0,0 +1,126 @@
+/* Energy accounting for esp32-weather-epd.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "energy_model.h"
+
+#include <cmath>
+
+// Weight of the newest wake in the smoothed charge per wake. A single slow wake
+// (WiFi retries, API timeouts) should not double the sleep interval on its own.
+#define ENERGY_WAKE_SMOOTHING 0.25f
+// Saved or overspent charge is paid back over this many days, so the interval
+// drifts towards the target instead of jumping.
+#define ENERGY_BALANCE_DAYS   3.f
+
+/* Returns the charge (mAh) consumed by a wake.
+ */
+float energyWakeCharge(const energy_trace_t &t, const energy_currents_t &c)
+{
+  float mah = 0.f;
+  uint32_t phaseMs = 0;
+  for (int i = 0; i < ENERGY_PHASE_COUNT; ++i)
+  {
+    mah += t.phase_ms[i] * c.phase[i];
+    phaseMs += t.phase_ms[i];
+  }
+  if (t.awake_ms > phaseMs)
+  {
+    mah += (t.awake_ms - phaseMs) * c.active;
+  }
+  return mah / 3600000.f;
+} // end energyWakeCharge
+
+/* Accounts charge consumed over a cycle against the balance only.
+ *
+ * The budget is credited with the target daily charge for the length of the
+ * cycle and debited with what was consumed. The balance is capped at one day of
+ * charge either way, so the budget only reflects recent history. Used directly
+ * for wakes that are not regular updates (interim wakes), which must not skew
+ * the charge per wake the interval is derived from.
+ */
+void energyBudgetBalance(energy_budget_t &b, const energy_policy_t &p,
+                         float mah, uint32_t cycleSeconds)
+{
+  if (!std::isfinite(b.balance_mah))
+  {
+    b.balance_mah = 0.f;
+  }
+  b.balance_mah += p.daily_mah * cycleSeconds / 86400.f - mah;
+  b.balance_mah = std::fmin(std::fmax(b.balance_mah, -p.daily_mah),
+                            p.daily_mah);
+  return;
+} // end energyBudgetBalance
+
+/* Accounts a regular update and the deep sleep following it against the
+ * budget, updating the smoothed charge per wake and the balance.
+ */
+void energyBudgetUpdate(energy_budget_t &b, const energy_policy_t &p,
+                        float wakeMah, float sleepMah, uint32_t cycleSeconds)
+{
+  if (!std::isfinite(b.wake_mah) || b.wake_mah <= 0.f)
+  {
+    b.wake_mah = wakeMah;
+  }
+  else
+  {
+    b.wake_mah += (wakeMah - b.wake_mah) * ENERGY_WAKE_SMOOTHING;
+  }
+  energyBudgetBalance(b, p, wakeMah + sleepMah, cycleSeconds);
+  return;
+} // end energyBudgetUpdate
+
+/* Returns the sleep interval (minutes) that meets the daily charge target.
+ *
+ * The charge left for wakes, after deep sleep and repaying the balance, is
+ * spread evenly over the active (non bed time) minutes of the day. Returns
+ * fallback, bounded, until the charge per wake is known.
+ */
+int energySleepInterval(const energy_budget_t &b, const energy_policy_t &p,
+                        int fallback)
+{
+  int interval = fallback;
+  if (std::isfinite(b.wake_mah) && b.wake_mah > 0.f)
+  {
+    const float available = p.daily_mah - p.sleep_ma * 24.f
+                            + b.balance_mah / ENERGY_BALANCE_DAYS;
+    if (available <= 0.f)
+    {
+      interval = p.max_interval;
+    }
+    else
+    {
+      const float wakes = available / b.wake_mah;
+      const float minutes = std::fmin(p.active_minutes / wakes,
+                                      (float) p.max_interval);
+      interval = (int) std::ceil(minutes);
+    }
+  }
+
+  if (p.step > 1)
+  {
+    interval = (interval + p.step - 1) / p.step * p.step;
+  }
+  if (interval < p.min_interval)
+  {
+    interval = p.min_interval;
+  }
+  if (interval > p.max_interval)
+  {
+    interval = p.max_interval;
+  }
+  return interval;
+} // end energySleepInterval
@@ -0,0 +1,66 @@
+/* Single precision math helpers for esp32-weather-epd.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "float_math.h"
+
+#include <cmath>
+
+// The ESP32 FPU is single precision only, double math is done in software.
+// std::pow(float, int), unqualified ceil() and double literals all end up
+// there, these helpers stay in float or integer arithmetic.
+
+static const float POWERS_OF_TEN[] = {1e0f, 1e1f, 1e2f, 1e3f, 1e4f,
+                                      1e5f, 1e6f, 1e7f, 1e8f, 1e9f};
+
+/* Returns 10^exponent for exponent 0 to 9, from a table. Exponents outside of
+ * that range are clamped to it.
+ */
+float powerOfTen(int exponent)
+{
+  if (exponent < 0)
+  {
+    return POWERS_OF_TEN[0];
+  }
+  if (exponent > 9)
+  {
+    return POWERS_OF_TEN[9];
+  }
+  return POWERS_OF_TEN[exponent];
+} // end powerOfTen
+
+/* Returns value rounded (half away from zero) to decimals digits after the
+ * decimal point.
+ */
+float roundDecimals(float value, int decimals)
+{
+  const float scale = powerOfTen(decimals);
+  return std::round(value * scale) / scale;
+} // end roundDecimals
+
+/* Returns numerator / denominator rounded up, both positive.
+ */
+int ceilDiv(int numerator, int denominator)
+{
+  return (numerator + denominator - 1) / denominator;
+} // end ceilDiv
+
+/* Returns numerator / denominator rounded half up, both positive.
+ */
+int roundDiv(int numerator, int denominator)
+{
+  return (2 * numerator + denominator) / (2 * denominator);
+} // end roundDiv
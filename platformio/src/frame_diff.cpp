@@ -0,0 +1,165 @@
+/* Frame differencing for esp32-weather-epd.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "frame_diff.h"
+
+/* Hashes each tile of a 1bpp frame buffer (rows of width / 8 bytes, MSB is
+ * the leftmost pixel) into hashes, row by row.
+ *
+ * Tiles are hashed with 32-bit FNV-1a. A hash is never 0, so 0 can be used to
+ * mark a tile whose content on the panel is unknown.
+ */
+void frameHashTiles(const uint8_t *buf, int width, int height,
+                    uint32_t *hashes)
+{
+  const int stride = width / 8;
+  const int tilesX = width / FRAME_TILE_SIZE;
+  const int tilesY = height / FRAME_TILE_SIZE;
+  for (int ty = 0; ty < tilesY; ++ty)
+  {
+    for (int tx = 0; tx < tilesX; ++tx)
+    {
+      uint32_t h = 2166136261u;
+      const uint8_t *row = buf + ty * FRAME_TILE_SIZE * stride
+                           + tx * (FRAME_TILE_SIZE / 8);
+      for (int y = 0; y < FRAME_TILE_SIZE; ++y, row += stride)
+      {
+        for (int b = 0; b < FRAME_TILE_SIZE / 8; ++b)
+        {
+          h = (h ^ row[b]) * 16777619u;
+        }
+      }
+      hashes[ty * tilesX + tx] = h ? h : 1;
+    }
+  }
+  return;
+} // end frameHashTiles
+
+/* Compares two sets of tile hashes and merges the changed tiles into
+ * rectangles (pixels).
+ *
+ * Each row of tiles is split into runs of changed tiles. A run that spans the
+ * same columns as a rectangle ending on the row above extends it downwards. If
+ * more than FRAME_MAX_RECTS rectangles would be needed, the bounding box of all
+ * changed tiles is used instead.
+ */
+void frameDiffTiles(const uint32_t *prev, const uint32_t *cur,
+                    int tilesX, int tilesY, frame_diff_t &d)
+{
+  d.changed_tiles = 0;
+  d.total_tiles   = tilesX * tilesY;
+  d.num_rects     = 0;
+  bool overflow = false;
+  int minX = tilesX, minY = tilesY, maxX = -1, maxY = -1;
+
+  for (int ty = 0; ty < tilesY; ++ty)
+  {
+    int tx = 0;
+    while (tx < tilesX)
+    {
+      if (prev[ty * tilesX + tx] == cur[ty * tilesX + tx])
+      {
+        ++tx;
+        continue;
+      }
+      const int x0 = tx;
+      while (tx < tilesX && prev[ty * tilesX + tx] != cur[ty * tilesX + tx])
+      {
+        ++tx;
+      }
+      d.changed_tiles += tx - x0;
+      if (x0 < minX) minX = x0;
+      if (tx - 1 > maxX) maxX = tx - 1;
+      if (ty < minY) minY = ty;
+      maxY = ty;
+      if (overflow)
+      {
+        continue;
+      }
+
+      // extend a rectangle ending on the row above with the same columns
+      const uint16_t px = x0 * FRAME_TILE_SIZE;
+      const uint16_t pw = (tx - x0) * FRAME_TILE_SIZE;
+      const uint16_t py = ty * FRAME_TILE_SIZE;
+      bool merged = false;
+      for (int i = 0; i < d.num_rects; ++i)
+      {
+        frame_rect_t &r = d.rects[i];
+        if (r.x == px && r.w == pw && r.y + r.h == py)
+        {
+          r.h += FRAME_TILE_SIZE;
+          merged = true;
+          break;
+        }
+      }
+      if (merged)
+      {
+        continue;
+      }
+      if (d.num_rects == FRAME_MAX_RECTS)
+      {
+        overflow = true;
+        continue;
+      }
+      d.rects[d.num_rects++] = {px, py, pw, FRAME_TILE_SIZE};
+    }
+  }
+
+  if (overflow)
+  {
+    d.num_rects = 1;
+    d.rects[0] = {static_cast<uint16_t>(minX * FRAME_TILE_SIZE),
+                  static_cast<uint16_t>(minY * FRAME_TILE_SIZE),
+                  static_cast<uint16_t>((maxX - minX + 1) * FRAME_TILE_SIZE),
+                  static_cast<uint16_t>((maxY - minY + 1) * FRAME_TILE_SIZE)};
+  }
+  return;
+} // end frameDiffTiles
+
+/* Decides how the panel should be refreshed for a frame difference.
+ *
+ * A full refresh is done when the previous frame is unknown, the ghosting
+ * budget of partial refreshes is used up, or the area to refresh exceeds
+ * max_area of the display.
+ */
+frame_refresh_t frameRefreshPolicy(const frame_diff_t &d, bool prevValid,
+                                   int partials, const frame_policy_t &p)
+{
+  if (!prevValid)
+  {
+    return FRAME_REFRESH_FULL;
+  }
+  if (d.changed_tiles == 0)
+  {
+    return FRAME_REFRESH_NONE;
+  }
+  if (partials >= p.max_partials)
+  {
+    return FRAME_REFRESH_FULL;
+  }
+  int area = 0;
+  for (int i = 0; i < d.num_rects; ++i)
+  {
+    area += d.rects[i].w * d.rects[i].h;
+  }
+  const int total = d.total_tiles * FRAME_TILE_SIZE * FRAME_TILE_SIZE;
+  if (area > p.max_area * total)
+  {
+    return FRAME_REFRESH_FULL;
+  }
+  return FRAME_REFRESH_PARTIAL;
+} // end frameRefreshPolicy
@@ -20,31 +20,29 @@
 
 #include "config.h"
 #include <Arduino.h>
-#include <Adafruit_Sensor.h>
 #include <Preferences.h>
 #include <time.h>
 #include <WiFi.h>
-#include <Wire.h>
 
 #include "_locale.h"
 #include "api_response.h"
+#include "battery_utils.h"
 #include "client_utils.h"
 #include "config.h"
+#include "display_state.h"
 #include "display_utils.h"
 #include "icons/icons_196x196.h"
+#include "render_model.h"
 #include "renderer.h"
+#include "sensor_utils.h"
+#include "wake_planner.h"
 
-#if defined(SENSOR_BME280)
-  #include <Adafruit_BME280.h>
-#endif
-#if defined(SENSOR_BME680)
-  #include <Adafruit_BME680.h>
-#endif
 #include <WiFiClientSecure.h>
 
 // too large to allocate locally on stack
 static om_resp_forecast_t    forecast;
 static om_resp_air_quality_t air_quality;
+static render_model_t        model;
 
 #if STALE_DATA_ON_API_FAIL
 // RTC memory: survives deep sleep, lost on power-off/reset. ~2KB total.
@@ -54,10 +52,128 @@ RTC_DATA_ATTR static int                       rtc_aqi;
 RTC_DATA_ATTR static char                      rtc_refreshTimeStr[48];
 #endif
 
+#if INTERIM_WAKES
+// RTC memory: state carried from the last full update to interim wakes.
+RTC_DATA_ATTR static int64_t rtc_full_wake_at   = 0; // Unix timestamp
+RTC_DATA_ATTR static uint8_t rtc_interim_count  = 0; // partial refreshes
+RTC_DATA_ATTR static int     rtc_wifiRSSI       = 0;
+RTC_DATA_ATTR static char    rtc_statusStr[64]  = {};
+// what the panel shows where interim wakes redraw
+RTC_DATA_ATTR static interim_values_t rtc_shown = {};
+// Interim wakes may only follow a full update that drew the dashboard.
+static bool dashboardDrawn = false;
+#endif
+
 Preferences prefs;
 
+#if WAKE_PLANNER
+// Unix timestamp of the wake planned from the displayed forecast, 0 if none.
+static int64_t plannedWake = 0;
+#endif
+
+/* Enter deep sleep for sleepDuration seconds. interimWake is true if this wake
+ * was an interim wake rather than an update.
+ */
+void startDeepSleep(unsigned long startTime, uint64_t sleepDuration,
+                    bool interimWake)
+{
+  // no-op unless an error path skipped finishIndoorSensor()
+  stopIndoorSensor();
+
+#if BATTERY_MONITORING
+  accumulateBatteryCharge(millis() - startTime, sleepDuration, interimWake);
+#endif
+
+#if DEBUG_LEVEL >= 1
+  printHeapUsage();
+#endif
+
+  esp_sleep_enable_timer_wakeup(sleepDuration * 1000000ULL);
+  Serial.print(TXT_AWAKE_FOR);
+  Serial.println(" "  + String((millis() - startTime) / 1000.0, 3) + "s");
+  Serial.print(TXT_ENTERING_DEEP_SLEEP_FOR);
+  Serial.println(" " + String(sleepDuration) + "s");
+  esp_deep_sleep_start();
+} // end startDeepSleep
+
+#if INTERIM_WAKES
+/* Returns the time (seconds) to sleep until the next wake. This is an interim
+ * wake if the next full update is far enough away, otherwise the full update.
+ */
+uint64_t getInterimSleep(time_t now)
+{
+  const int64_t untilFull = rtc_full_wake_at - now;
+  if (untilFull <= 0)
+  {
+    return 0;
+  }
+  if (untilFull > (INTERIM_WAKE_INTERVAL + 2) * 60LL)
+  {
+    return INTERIM_WAKE_INTERVAL * 60ULL;
+  }
+  return untilFull;
+} // end getInterimSleep
+
+/* Returns true if this is an interim wake between full updates. After
+ * INTERIM_FULL_REFRESH_CYCLES interim wakes that redrew the display, the wake
+ * is a full update instead, which refreshes the display in full to clear the
+ * ghosting of the partial refreshes.
+ */
+bool isInterimWake()
+{
+  if (esp_sleep_get_wakeup_cause() != ESP_SLEEP_WAKEUP_TIMER
+   || rtc_interim_count >= INTERIM_FULL_REFRESH_CYCLES)
+  {
+    return false;
+  }
+  const int64_t untilFull = rtc_full_wake_at - time(nullptr);
+  return untilFull > 60 && untilFull <= 86400;
+} // end isInterimWake
+
+/* Reads the indoor sensor and refreshes only the indoor conditions and the
+ * status bar with partial windows, without WiFi. What they show is kept in RTC
+ * memory, to write it back to the panel first. Then deep sleeps until the next
+ * wake.
+ */
+void runInterimWake(unsigned long startTime, uint32_t batteryVoltage,
+                    float batteryDaysLeft)
+{
+  float inTemp;
+  float inHumidity;
+  sensor_status_t sensorStatus = readIndoorSensor(inTemp, inHumidity);
+  time_t now = time(nullptr);
+  tm timeInfo = {};
+  localtime_r(&now, &timeInfo);
+  if (sensorStatus == SENSOR_OK)
+  {
+    recordIndoorSample(now, inTemp, inHumidity);
+  }
+
+  // Panels without fast partial refresh would flash the whole screen, those
+  // only record the indoor history.
+  if (beginWindows())
+  {
+    String refreshTimeStr;
+    getRefreshTimeStr(refreshTimeStr, true, &timeInfo);
+    interim_values_t values = {inTemp, inHumidity, batteryVoltage,
+                               batteryDaysLeft, {}};
+    refreshTimeStr.toCharArray(values.refresh_time,
+                               sizeof(values.refresh_time));
+    redrawIndoorConditions(rtc_shown, values);
+    redrawStatusBar(String(rtc_statusStr), rtc_wifiRSSI, rtc_shown, values);
+    endWindows();
+    rtc_shown = values;
+    ++rtc_interim_count;
+  }
+
+  startDeepSleep(startTime, getInterimSleep(now), true);
+} // end runInterimWake
+#endif
+
 /* Put esp32 into ultra low-power deep sleep (<11μA).
- * Aligns wake time to the minute. Sleep times defined in config.cpp.
+ * Aligns wake time to the minute. Sleep times defined in config.cpp, the
+ * interval is adapted to the energy budget if ADAPTIVE_SLEEP is enabled, and
+ * replaced by the wake planned from the forecast if WAKE_PLANNER is enabled.
  */
 void beginDeepSleep(unsigned long startTime, tm *timeInfo)
 {
@@ -78,33 +194,46 @@ void beginDeepSleep(unsigned long startTime, tm *timeInfo)
     bedtimeHour = (BED_TIME - WAKE_TIME + 24) % 24;
   }
 
+  // sleep interval may be adapted to the energy budget
+  const int sleepInterval = getSleepInterval();
+
   // time is relative to wake time
   int curHour = (timeInfo->tm_hour - WAKE_TIME + 24) % 24;
   const int curMinute = curHour * 60 + timeInfo->tm_min;
   const int curSecond = curHour * 3600
                       + timeInfo->tm_min * 60
                       + timeInfo->tm_sec;
-  const int desiredSleepSeconds = SLEEP_DURATION * 60;
-  const int offsetMinutes = curMinute % SLEEP_DURATION;
+  const int desiredSleepSeconds = sleepInterval * 60;
+  const int offsetMinutes = curMinute % sleepInterval;
   const int offsetSeconds = curSecond % desiredSleepSeconds;
 
-  // align wake time to nearest multiple of SLEEP_DURATION
-  int sleepMinutes = SLEEP_DURATION - offsetMinutes;
+  // align wake time to nearest multiple of sleepInterval
+  int sleepMinutes = sleepInterval - offsetMinutes;
   if (desiredSleepSeconds - offsetSeconds < 120
    || offsetSeconds / (float)desiredSleepSeconds > 0.95f)
-  { // if we have a sleep time less than 2 minutes OR less 5% SLEEP_DURATION,
+  { // if we have a sleep time less than 2 minutes OR less 5% sleepInterval,
     // skip to next alignment
-    sleepMinutes += SLEEP_DURATION;
+    sleepMinutes += sleepInterval;
   }
 
   // estimated wake time, if this falls in a sleep period then sleepDuration
   // must be adjusted
-  const int predictedWakeHour = ((curMinute + sleepMinutes) / 60) % 24;
+  int sleepSeconds = sleepMinutes * 60 - timeInfo->tm_sec;
+#if WAKE_PLANNER
+  // a wake planned from the forecast replaces the regular alignment
+  const time_t now = time(nullptr);
+  if (plannedWake > now)
+  {
+    sleepSeconds = plannedWake - now;
+  }
+#endif
+  const int predictedWakeHour = ((curSecond + sleepSeconds) / 3600) % 24;
 
   uint64_t sleepDuration;
-  if (predictedWakeHour < bedtimeHour)
+  const bool bedtime = predictedWakeHour >= bedtimeHour;
+  if (!bedtime)
   {
-    sleepDuration = sleepMinutes * 60 - timeInfo->tm_sec;
+    sleepDuration = sleepSeconds;
   }
   else
   {
@@ -117,16 +246,18 @@ void beginDeepSleep(unsigned long startTime, tm *timeInfo)
   sleepDuration += 3ULL;
   sleepDuration *= 1.0015f;
 
-#if DEBUG_LEVEL >= 1
-  printHeapUsage();
+#if INTERIM_WAKES
+  // the indoor conditions are refreshed in between, but not during bed time or
+  // over an error screen
+  rtc_full_wake_at  = time(nullptr) + sleepDuration;
+  rtc_interim_count = 0;
+  if (!bedtime && dashboardDrawn)
+  {
+    sleepDuration = getInterimSleep(time(nullptr));
+  }
 #endif
 
-  esp_sleep_enable_timer_wakeup(sleepDuration * 1000000ULL);
-  Serial.print(TXT_AWAKE_FOR);
-  Serial.println(" "  + String((millis() - startTime) / 1000.0, 3) + "s");
-  Serial.print(TXT_ENTERING_DEEP_SLEEP_FOR);
-  Serial.println(" " + String(sleepDuration) + "s");
-  esp_deep_sleep_start();
+  startDeepSleep(startTime, sleepDuration, false);
 } // end beginDeepSleep
 
 /* Program entry point.
@@ -150,38 +281,64 @@ void setup()
   Serial.print(TXT_BATTERY_VOLTAGE);
   Serial.println(": " + String(batteryVoltage) + "mv");
 
+  // The system time keeps running through deep sleep, so it is already valid
+  // here after the first successful time synchronization.
+  updateBatteryModel(prefs, batteryVoltage, time(nullptr));
+  float batteryDaysLeft = NAN;
+  bat_estimate_t batteryEstimate;
+  if (getBatteryEstimate(batteryEstimate))
+  {
+    batteryDaysLeft = batteryEstimate.days_left;
+  }
+
   // When the battery is low, the display should be updated to reflect that, but
   // only the first time we detect low voltage. The next time the display will
   // refresh is when voltage is no longer low. To keep track of that we will
   // make use of non-volatile storage.
   bool lowBat = prefs.getBool("lowBat", false);
 
+  // The previous battery level is kept so that thresholds are applied with
+  // hysteresis.
+  battery_level_t prevBatLevel =
+    static_cast<battery_level_t>(prefs.getUChar("batLevel", BATTERY_OK));
+  battery_level_t batLevel = getBatteryLevel(batteryVoltage, prevBatLevel,
+                                             BATTERY_VOLTAGE_HYSTERESIS);
+  if (batLevel != prevBatLevel)
+  {
+    prefs.putUChar("batLevel", batLevel);
+  }
+
   // low battery, deep sleep now
-  if (batteryVoltage <= LOW_BATTERY_VOLTAGE)
+  if (batLevel != BATTERY_OK)
   {
+#if INTERIM_WAKES
+    rtc_full_wake_at = 0; // no interim wakes over the low battery screen
+#endif
     if (lowBat == false)
     { // battery is now low for the first time
       prefs.putBool("lowBat", true);
       prefs.end();
-      initDisplay();
+      beginFrame();
       do
       {
         drawError(battery_alert_0deg_196x196, TXT_LOW_BATTERY);
-      } while (display.nextPage());
+      } while (nextFrame());
       powerOffDisplay();
     }
 
-    if (batteryVoltage <= CRIT_LOW_BATTERY_VOLTAGE)
+    if (batLevel == BATTERY_CRIT_LOW)
     { // critically low battery
       // don't set esp_sleep_enable_timer_wakeup();
       // We won't wake up again until someone manually presses the RST button.
       Serial.println(TXT_CRIT_LOW_BATTERY_VOLTAGE);
       Serial.println(TXT_HIBERNATING_INDEFINITELY_NOTICE);
     }
-    else if (batteryVoltage <= VERY_LOW_BATTERY_VOLTAGE)
+    else if (batLevel == BATTERY_VERY_LOW)
     { // very low battery
       esp_sleep_enable_timer_wakeup(VERY_LOW_BATTERY_SLEEP_INTERVAL
                                     * 60ULL * 1000000ULL);
+      accumulateBatteryCharge(millis() - startTime,
+                              VERY_LOW_BATTERY_SLEEP_INTERVAL * 60ULL, false);
       Serial.println(TXT_VERY_LOW_BATTERY_VOLTAGE);
       Serial.print(TXT_ENTERING_DEEP_SLEEP_FOR);
       Serial.println(" " + String(VERY_LOW_BATTERY_SLEEP_INTERVAL) + "min");
@@ -190,6 +347,8 @@ void setup()
     { // low battery
       esp_sleep_enable_timer_wakeup(LOW_BATTERY_SLEEP_INTERVAL
                                     * 60ULL * 1000000ULL);
+      accumulateBatteryCharge(millis() - startTime,
+                              LOW_BATTERY_SLEEP_INTERVAL * 60ULL, false);
       Serial.println(TXT_LOW_BATTERY_VOLTAGE);
       Serial.print(TXT_ENTERING_DEEP_SLEEP_FOR);
       Serial.println(" " + String(LOW_BATTERY_SLEEP_INTERVAL) + "min");
@@ -203,11 +362,25 @@ void setup()
   }
 #else
   uint32_t batteryVoltage = UINT32_MAX;
+  float batteryDaysLeft = NAN;
 #endif
 
   // All data should have been loaded from NVS. Close filesystem.
   prefs.end();
 
+#if INTERIM_WAKES
+  // INTERIM WAKE
+  if (isInterimWake())
+  {
+    runInterimWake(startTime, batteryVoltage, batteryDaysLeft);
+  }
+#endif
+
+  // START INDOOR SENSOR MEASUREMENT
+  // The conversion (and BME680 gas heater profile) runs while WiFi connects and
+  // the API requests are made, the result is collected afterwards.
+  startIndoorSensor();
+
   String statusStr = {};
   String tmpStr = {};
 #if STALE_DATA_ON_API_FAIL
@@ -221,14 +394,14 @@ void setup()
   if (wifiStatus != WL_CONNECTED)
   { // WiFi Connection Failed
     killWiFi();
-    initDisplay();
+    beginFrame();
     if (wifiStatus == WL_NO_SSID_AVAIL)
     {
       Serial.println(TXT_NETWORK_NOT_AVAILABLE);
       do
       {
         drawError(wifi_x_196x196, TXT_NETWORK_NOT_AVAILABLE);
-      } while (display.nextPage());
+      } while (nextFrame());
     }
     else
     {
@@ -236,7 +409,7 @@ void setup()
       do
       {
         drawError(wifi_x_196x196, TXT_WIFI_CONNECTION_FAILED);
-      } while (display.nextPage());
+      } while (nextFrame());
     }
     powerOffDisplay();
     beginDeepSleep(startTime, &timeInfo);
@@ -249,11 +422,11 @@ void setup()
   {
     Serial.println(TXT_TIME_SYNCHRONIZATION_FAILED);
     killWiFi();
-    initDisplay();
+    beginFrame();
     do
     {
       drawError(wi_time_4_196x196, TXT_TIME_SYNCHRONIZATION_FAILED);
-    } while (display.nextPage());
+    } while (nextFrame());
     powerOffDisplay();
     beginDeepSleep(startTime, &timeInfo);
   }
@@ -282,11 +455,11 @@ void setup()
   {
     killWiFi();
     tmpStr = forecastError;
-    initDisplay();
+    beginFrame();
     do
     {
       drawError(wi_cloud_down_196x196, "Forecast API Error", tmpStr);
-    } while (display.nextPage());
+    } while (nextFrame());
     powerOffDisplay();
     beginDeepSleep(startTime, &timeInfo);
   }
@@ -308,65 +481,61 @@ void setup()
   {
     killWiFi();
     tmpStr = airQualityError;
-    initDisplay();
+    beginFrame();
     do
     {
       drawError(wi_cloud_down_196x196, "Air Quality API Error", tmpStr);
-    } while (display.nextPage());
+    } while (nextFrame());
     powerOffDisplay();
     beginDeepSleep(startTime, &timeInfo);
   }
   killWiFi(); // WiFi no longer needed
 
   // GET INDOOR TEMPERATURE AND HUMIDITY, start BMEx80...
-  pinMode(PIN_BME_PWR, OUTPUT);
-  digitalWrite(PIN_BME_PWR, HIGH);
-#if defined(SENSOR_INIT_DELAY_MS) && SENSOR_INIT_DELAY_MS > 0
-  delay(SENSOR_INIT_DELAY_MS);
-#endif
-  TwoWire I2C_bme = TwoWire(0);
-  I2C_bme.begin(PIN_BME_SDA, PIN_BME_SCL, 100000); // 100kHz
-  float inTemp     = NAN;
-  float inHumidity = NAN;
 #if defined(SENSOR_BME280)
   Serial.print(String(TXT_READING_FROM) + " BME280... ");
-  Adafruit_BME280 bme;
-
-  if(bme.begin(BME_ADDRESS, &I2C_bme))
-  {
 #endif
 #if defined(SENSOR_BME680)
   Serial.print(String(TXT_READING_FROM) + " BME680... ");
-  Adafruit_BME680 bme(&I2C_bme);
-
-  if(bme.begin(BME_ADDRESS))
-  {
 #endif
-    inTemp     = bme.readTemperature(); // Celsius
-    inHumidity = bme.readHumidity();    // %
-
-    // check if BME readings are valid
-    // note: readings are checked again before drawing to screen. If a reading
-    //       is not a number (NAN) then an error occurred, a dash '-' will be
-    //       displayed.
-    if (std::isnan(inTemp) || std::isnan(inHumidity))
-    {
-      if (statusStr.isEmpty()) statusStr = "BME " + String(TXT_READ_FAILED);
-      else                     statusStr += " | BME " + String(TXT_READ_FAILED);
-      Serial.println(statusStr);
-    }
-    else
-    {
-      Serial.println(TXT_SUCCESS);
-    }
+  float inTemp;
+  float inHumidity;
+  float inGasResistance;
+  sensor_status_t sensorStatus = finishIndoorSensor(inTemp, inHumidity,
+                                                    inGasResistance);
+  if (sensorStatus == SENSOR_OK)
+  {
+    Serial.println(TXT_SUCCESS);
+    recordIndoorSample(now, inTemp, inHumidity);
   }
   else
   {
-    if (statusStr.isEmpty()) statusStr = "BME " + String(TXT_NOT_FOUND);
-    else                     statusStr += " | BME " + String(TXT_NOT_FOUND);
+    tmpStr = (sensorStatus == SENSOR_NOT_FOUND) ? TXT_NOT_FOUND
+                                                : TXT_READ_FAILED;
+    if (statusStr.isEmpty()) statusStr = "BME " + tmpStr;
+    else                     statusStr += " | BME " + tmpStr;
     Serial.println(statusStr);
   }
-  digitalWrite(PIN_BME_PWR, LOW);
+#if DEBUG_LEVEL >= 1
+#if defined(SENSOR_BME680)
+  Serial.println("[debug] Gas resistance  : " + String(inGasResistance, 0)
+                 + " Ohm");
+#endif
+  indoor_stats_t indoorStats;
+  if (getIndoorStats(indoorStats, now, 24 * 3600))
+  {
+    Serial.println("[debug] Indoor history  : " + String(indoorStats.count)
+                   + " samples (24h)");
+    Serial.println("[debug] Indoor temp     : "
+                   + String(indoorStats.temp_min, 2) + " .. "
+                   + String(indoorStats.temp_max, 2) + " C, "
+                   + String(indoorStats.temp_trend, 2) + " C/h");
+    Serial.println("[debug] Indoor humidity : "
+                   + String(indoorStats.humidity_min, 2) + " .. "
+                   + String(indoorStats.humidity_max, 2) + " %, "
+                   + String(indoorStats.humidity_trend, 2) + " %/h");
+  }
+#endif
 
   String refreshTimeStr;
   getRefreshTimeStr(refreshTimeStr, timeConfigured, &timeInfo);
@@ -393,18 +562,83 @@ void setup()
   String dateStr;
   getDateStr(dateStr, &timeInfo);
 
-  // RENDER FULL REFRESH
-  initDisplay();
-  do
+  // DERIVE WHAT IS SHOWN, once for the hash and all pages of the frame
+  buildRenderModel(model, forecast.current, forecast.hourly, forecast.daily,
+                   air_quality);
+
+  // RENDER FULL FRAME
+  // with SKIP_UNCHANGED_DISPLAY the panel is left off if nothing visible
+  // changed, with FRAME_DIFF only the parts that changed are refreshed
+#if SKIP_UNCHANGED_DISPLAY
+  uint32_t displayHash = hashDisplayState(model, forecast.current,
+                                          forecast.hourly, forecast.daily,
+                                          air_quality,
+                                          inTemp, inHumidity, CITY_STRING,
+                                          dateStr, statusStr, wifiRSSI,
+                                          batteryVoltage, batteryDaysLeft,
+                                          timeInfo);
+  if (isDisplayCurrent(displayHash, now))
   {
-    drawCurrentConditions(forecast.current, forecast.daily[0],
-                          air_quality, inTemp, inHumidity);
-    drawOutlookGraph(forecast.hourly, forecast.daily, timeInfo);
-    drawForecast(forecast.daily, timeInfo);
-    drawLocationDate(CITY_STRING, dateStr);
-    drawStatusBar(statusStr, refreshTimeStr, wifiRSSI, batteryVoltage);
-  } while (display.nextPage());
-  powerOffDisplay();
+    Serial.println("Display unchanged, skipping refresh");
+  }
+  else
+#endif
+  {
+    beginFrame();
+    do
+    {
+      // widgets off the page being drawn are skipped
+      drawBackground(model);
+      drawCurrentConditions(model, forecast.current, air_quality,
+                            inTemp, inHumidity);
+      if (onPage(LAYOUT_OUTLOOK_GRAPH))
+      {
+        drawOutlookGraph(model, forecast.hourly, timeInfo);
+      }
+      if (onPage(LAYOUT_FORECAST))
+      {
+        drawForecast(model, forecast.daily, timeInfo);
+      }
+      if (onPage(LAYOUT_LOCATION_DATE))
+      {
+        drawLocationDate(CITY_STRING, dateStr);
+      }
+      if (onPage(LAYOUT_STATUS_BAR))
+      {
+        drawStatusBar(statusStr, refreshTimeStr, wifiRSSI, batteryVoltage,
+                      batteryDaysLeft);
+      }
+    } while (nextFrame());
+    powerOffDisplay();
+#if SKIP_UNCHANGED_DISPLAY
+    setDisplayState(displayHash, now);
+#endif
+#if INTERIM_WAKES
+    // the indoor conditions and status bar are redrawn on interim wakes
+    rtc_wifiRSSI = wifiRSSI;
+    statusStr.toCharArray(rtc_statusStr, sizeof(rtc_statusStr));
+    rtc_shown = {inTemp, inHumidity, batteryVoltage, batteryDaysLeft, {}};
+    refreshTimeStr.toCharArray(rtc_shown.refresh_time,
+                               sizeof(rtc_shown.refresh_time));
+#endif
+  }
+
+#if INTERIM_WAKES
+  dashboardDrawn = true;
+#endif
+
+#if WAKE_PLANNER
+  // PLAN NEXT WAKE
+  wake_plan_t wakePlan = planNextWake(forecast.hourly, forecast.daily, now,
+                                      SLEEP_DURATION_MIN * 60LL,
+                                      getSleepInterval() * 60LL);
+  plannedWake = wakePlan.dt;
+#if DEBUG_LEVEL >= 1
+  Serial.println("[debug] Planned wake    : +"
+                 + String(static_cast<long>(wakePlan.dt - now)) + "s (event "
+                 + String(wakePlan.event) + ")");
+#endif
+#endif
 
   // DEEP SLEEP
   beginDeepSleep(startTime, &timeInfo);
@@ -0,0 +1,104 @@
+/* PackBits run-length coding for esp32-weather-epd.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "packbits.h"
+
+#include <cstring>
+
+/* Encodes n bytes of src with PackBits into dst, which must hold
+ * PACKBITS_MAX_SIZE(n) bytes. Returns the encoded size.
+ *
+ * Each packet starts with a header byte h. For 0 <= h <= 127 the next h + 1
+ * bytes are literals. For 129 <= h <= 255 the next byte is repeated 257 - h
+ * times. Frames are mostly white, so long runs of 0xFF make up most of them.
+ */
+size_t packBitsEncode(const uint8_t *src, size_t n, uint8_t *dst)
+{
+  size_t in = 0;
+  size_t out = 0;
+  while (in < n)
+  {
+    // length of the run starting here
+    size_t run = 1;
+    while (in + run < n && run < 128 && src[in + run] == src[in])
+    {
+      ++run;
+    }
+    if (run >= 3)
+    {
+      dst[out++] = static_cast<uint8_t>(257 - run);
+      dst[out++] = src[in];
+      in += run;
+      continue;
+    }
+    // literals until the next run of at least 3, shorter runs don't pay off
+    size_t lit = 1;
+    while (in + lit < n && lit < 128
+        && !(in + lit + 2 < n && src[in + lit] == src[in + lit + 1]
+             && src[in + lit] == src[in + lit + 2]))
+    {
+      ++lit;
+    }
+    dst[out++] = static_cast<uint8_t>(lit - 1);
+    memcpy(dst + out, src + in, lit);
+    out += lit;
+    in += lit;
+  }
+  return out;
+} // end packBitsEncode
+
+/* Decodes PackBits data from src (n bytes available) until size bytes have
+ * been written to dst. Returns the number of bytes of src consumed, or 0 if
+ * src is truncated or does not decode to exactly size bytes.
+ */
+size_t packBitsDecode(const uint8_t *src, size_t n, uint8_t *dst,
+                      size_t size)
+{
+  size_t in = 0;
+  size_t out = 0;
+  while (out < size)
+  {
+    if (in >= n)
+    {
+      return 0;
+    }
+    const uint8_t h = src[in++];
+    if (h < 128)
+    {
+      const size_t lit = h + 1;
+      if (in + lit > n || out + lit > size)
+      {
+        return 0;
+      }
+      memcpy(dst + out, src + in, lit);
+      in += lit;
+      out += lit;
+    }
+    else if (h > 128)
+    {
+      const size_t run = 257 - h;
+      if (in >= n || out + run > size)
+      {
+        return 0;
+      }
+      memset(dst + out, src[in++], run);
+      out += run;
+    }
+    // 128 is a no-op
+  }
+  return in;
+} // end packBitsDecode
@@ -0,0 +1,115 @@
+/* Thick polyline rasterizer for esp32-weather-epd.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "polyline.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <utility>
+
+/* Adds the pixels of the line from (x0, y0) to (x1, y1) to the columns lo/hi,
+ * column 0 being x = x_first. These are the pixels Adafruit_GFX::drawLine()
+ * draws (Bresenham).
+ */
+static void addLine(int x0, int y0, int x1, int y1, int x_first,
+                    int16_t *lo, int16_t *hi)
+{
+  const bool steep = std::abs(y1 - y0) > std::abs(x1 - x0);
+  if (steep)
+  {
+    std::swap(x0, y0);
+    std::swap(x1, y1);
+  }
+  if (x0 > x1)
+  {
+    std::swap(x0, x1);
+    std::swap(y0, y1);
+  }
+  const int dx = x1 - x0;
+  const int dy = std::abs(y1 - y0);
+  const int ystep = (y0 < y1) ? 1 : -1;
+  int err = dx / 2;
+  for (; x0 <= x1; ++x0)
+  {
+    const int px = steep ? y0 : x0;
+    const int py = steep ? x0 : y0;
+    const int i = px - x_first;
+    lo[i] = std::min<int16_t>(lo[i], py);
+    hi[i] = std::max<int16_t>(hi[i], py);
+    err -= dy;
+    if (err < 0)
+    {
+      y0 += ystep;
+      err += dx;
+    }
+  }
+  return;
+} // end addLine
+
+/* Rasterizes the polyline through the n points (xs[i], ys[i]), stroked width
+ * pixels thick, into one vertical span per column: rows lo[i] to hi[i] of
+ * column x = xs[0] - (width - 1) + i, empty where lo[i] > hi[i]. lo and hi
+ * must hold POLYLINE_COLUMNS(xs[0], xs[n - 1], width) entries, and xs must not
+ * decrease. Returns the number of columns.
+ *
+ * The stroke is each line (as drawLine() draws it) repeated width - 1 pixels to
+ * the left and width - 1 pixels down. For width 2 that is the same as drawing
+ * every line 3 times, at (0, 0), (0, 1) and (-1, 0).
+ *
+ * The lines of a polyline that goes left to right cover a single span of rows
+ * in each column: Bresenham lines are 8-connected, so the pixels of a line in a
+ * column, or of two lines meeting in it, are contiguous. Repeating them down
+ * only extends the span, and the spans of the next columns, repeated to the
+ * left, touch or overlap it. So each pixel of the stroke is drawn exactly once,
+ * joins included.
+ */
+uint16_t thickPolylineSpans(const int *xs, const int *ys, uint16_t n,
+                            uint8_t width, int16_t *lo, int16_t *hi)
+{
+  if (n == 0 || width == 0)
+  {
+    return 0;
+  }
+  const int xFirst = xs[0] - (width - 1);
+  const uint16_t cols = POLYLINE_COLUMNS(xs[0], xs[n - 1], width);
+  std::fill(lo, lo + cols, INT16_MAX);
+  std::fill(hi, hi + cols, INT16_MIN);
+  if (n == 1)
+  {
+    addLine(xs[0], ys[0], xs[0], ys[0], xFirst, lo, hi);
+  }
+  for (uint16_t i = 1; i < n; ++i)
+  {
+    addLine(xs[i - 1], ys[i - 1], xs[i], ys[i], xFirst, lo, hi);
+  }
+
+  // repeat down in the same column, then left from the next columns, which
+  // are still as the lines left them
+  for (uint16_t i = 0; i < cols; ++i)
+  {
+    if (lo[i] <= hi[i])
+    {
+      hi[i] += width - 1;
+    }
+    for (uint16_t k = 1; k < width && i + k < cols; ++k)
+    {
+      lo[i] = std::min(lo[i], lo[i + k]);
+      hi[i] = std::max(hi[i], hi[i + k]);
+    }
+  }
+  return cols;
+} // end thickPolylineSpans
@@ -0,0 +1,171 @@
+/* Derived render model for esp32-weather-epd.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "render_model.h"
+
+#include <algorithm>
+#include <cmath>
+#include "display_utils.h"
+#include "float_math.h"
+
+/* The % operator in C++ is not a true modulo operator but it instead a
+ * remainder operator. The remainder operator and modulo operator are equivalent
+ * for positive numbers, but not for negatives. The follow implementation of the
+ * modulo operator works for +/-a and +b.
+ */
+static inline int modulo(int a, int b)
+{
+  const int result = a % b;
+  return result >= 0 ? result : result + b;
+}
+
+/* Dew point (°C) from temperature (°C) and relative humidity (%), Magnus
+ * formula with the constants of Sonntag (1990). NaN for 0% humidity.
+ */
+static float dewPoint(float celsius, int humidity)
+{
+  if (humidity <= 0)
+  {
+    return NAN;
+  }
+  const float b = 17.62f;
+  const float c = 243.12f;
+  const float gamma = std::log(humidity / 100.0f) + b * celsius / (c + celsius);
+  return c * gamma / (b - gamma);
+} // end dewPoint
+
+/* Picks the temperature axis of the outlook graph: whole multiples of a step
+ * of 5, 10, ... degrees with GRAPH_Y_MAJOR_TICKS intervals, that leave at least
+ * one degree of room above and below the curve.
+ */
+static void setTempAxis(render_model_t &model)
+{
+  const int yMajorTicks = GRAPH_Y_MAJOR_TICKS;
+  const float tempMin = model.temp_min;
+  const float tempMax = model.temp_max;
+  int yTempMajorTicks = 5;
+  int tempBoundMin = static_cast<int>(tempMin - 1)
+                      - modulo(static_cast<int>(tempMin - 1), yTempMajorTicks);
+  int tempBoundMax = static_cast<int>(tempMax + 1)
+   + (yTempMajorTicks - modulo(static_cast<int>(tempMax + 1), yTempMajorTicks));
+
+  // while we have to many major ticks then increase the step
+  while ((tempBoundMax - tempBoundMin) / yTempMajorTicks > yMajorTicks)
+  {
+    yTempMajorTicks += 5;
+    tempBoundMin = static_cast<int>(tempMin - 1)
+                      - modulo(static_cast<int>(tempMin - 1), yTempMajorTicks);
+    tempBoundMax = static_cast<int>(tempMax + 1) + (yTempMajorTicks
+                      - modulo(static_cast<int>(tempMax + 1), yTempMajorTicks));
+  }
+  // while we have not enough major ticks, add to either bound
+  while ((tempBoundMax - tempBoundMin) / yTempMajorTicks < yMajorTicks)
+  {
+    // add to whatever bound is closer to the actual min/max
+    if (tempMin - tempBoundMin <= tempBoundMax - tempMax)
+    {
+      tempBoundMin -= yTempMajorTicks;
+    }
+    else
+    {
+      tempBoundMax += yTempMajorTicks;
+    }
+  }
+  model.temp_bound_min = tempBoundMin;
+  model.temp_bound_max = tempBoundMax;
+  model.temp_tick = yTempMajorTicks;
+  return;
+} // end setTempAxis
+
+/* Places the hourly temperatures and precipitation on the y axes of the outlook
+ * graph, in pixels. These are what the graph shows, so they are also what the
+ * display state hash keeps.
+ */
+static void setGraphY(render_model_t &model)
+{
+  const float tempPxPerUnit = (GRAPH_Y1 - GRAPH_Y0)
+        / static_cast<float>(model.temp_bound_max - model.temp_bound_min);
+  // without precipitation the bars are empty
+  const float precipPxPerUnit = model.precip_bound_max > 0
+        ? (GRAPH_Y1 - GRAPH_Y0) / model.precip_bound_max : 0.f;
+  for (int i = 0; i < HOURLY_GRAPH_MAX; ++i)
+  {
+    model.temp_y[i] = static_cast<int16_t>(std::round(
+      GRAPH_Y1 - (tempPxPerUnit * (model.temp[i] - model.temp_bound_min)) ));
+    model.precip_y[i] = static_cast<int16_t>(std::round(
+      GRAPH_Y1 - (precipPxPerUnit * model.precip[i]) ));
+  }
+  return;
+} // end setGraphY
+
+/* Derives everything the dashboard shows from the forecast, with the hourly
+ * series of the outlook graph in Temp and Precip units. Each hour of the graph
+ * is visited once.
+ */
+template<class Temp, class Precip>
+void buildRenderModel(render_model_t &model, const om_current_t &current,
+                      const om_hourly_t *hourly, const om_daily_t *daily,
+                      const om_resp_air_quality_t &air_quality)
+{
+  model.current_icon = getCurrentConditionsBitmap196(current, daily[0]);
+  model.wind_icon = getWindBitmap24(current.wind_deg);
+  model.wind_compass = getCompassPointNotation(current.wind_deg);
+  model.uvi = static_cast<unsigned int>(
+                std::max(std::round(current.uvi), 0.0f));
+  model.uvi_desc = getUVIdesc(model.uvi);
+  model.aqi_desc = getAQIdesc(air_quality.aqi);
+  model.dew_point = dewPoint(current.temp, current.humidity);
+
+  for (int i = 0; i < 5; ++i)
+  {
+    model.daily_icon[i] = getDailyForecastBitmap64(daily[i]);
+  }
+
+  model.hour_interval = ceilDiv(HOURLY_GRAPH_MAX, GRAPH_X_MAX_TICKS);
+  float precipMax = 0;
+  int day = 0;
+  for (int i = 0; i < HOURLY_GRAPH_MAX; ++i)
+  {
+    const float temp = Temp::convert(hourly[i].temp);
+    model.temp[i] = temp;
+    model.temp_min = i > 0 ? std::min(model.temp_min, temp) : temp;
+    model.temp_max = i > 0 ? std::max(model.temp_max, temp) : temp;
+    model.precip[i] = Precip::convert(hourly[i]);
+    precipMax = std::max(precipMax, model.precip[i]);
+
+    if (i > 0 && daily[day].dt + 86400 <= hourly[i].dt)
+    {
+      ++day;
+    }
+    model.day_idx[i] = day;
+    model.hourly_icon[i] = nullptr;
+#if DISPLAY_HOURLY_ICONS
+    if (i > 0 && (i % model.hour_interval) == 0)
+    {
+      model.hourly_icon[i] = getHourlyForecastBitmap32(hourly[i], daily[day]);
+    }
+#endif
+  }
+  model.precip_bound_max = Precip::axisMax(precipMax);
+  setTempAxis(model);
+  setGraphY(model);
+  return;
+} // end buildRenderModel
+template void buildRenderModel<TempUnits, HourlyPrecipUnits>(
+  render_model_t &model, const om_current_t &current,
+  const om_hourly_t *hourly, const om_daily_t *daily,
+  const om_resp_air_quality_t &air_quality);
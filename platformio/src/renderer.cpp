@@ -22,9 +22,25 @@
 #include "_strftime.h"
 #include "renderer.h"
 #include "api_response.h"
+#include "battery_utils.h"
 #include "config.h"
-#include "conversions.h"
+#include "display_state.h"
 #include "display_utils.h"
+#include "float_math.h"
+#include "frame_diff.h"
+#include "packbits.h"
+#include "polyline.h"
+#include "render_model.h"
+#include "text_format.h"
+#include "text_metrics.h"
+#include "text_wrap.h"
+#include "units.h"
+#if FRAME_DIFF_ACTIVE
+  #include <LittleFS.h>
+#endif
+#if WIDGET_CACHE_ACTIVE || BACKGROUND_CACHE_ACTIVE
+  #include <esp_ota_ops.h>
+#endif
 
 // fonts
 #include FONT_HEADER
@@ -41,32 +57,32 @@
 #include "icons/icons_196x196.h"
 
 #ifdef DISP_BW_V2
-  GxEPD2_BW<GxEPD2_750_T7,
-            GxEPD2_750_T7::HEIGHT> display(
+  GxEPD2_BW_Display<GxEPD2_750_T7,
+                    GxEPD2_750_T7::HEIGHT / 8> display(
     GxEPD2_750_T7(PIN_EPD_CS,
                   PIN_EPD_DC,
                   PIN_EPD_RST,
                   PIN_EPD_BUSY));
 #endif
 #ifdef DISP_3C_B
-  GxEPD2_3C<GxEPD2_750c_Z08,
-            GxEPD2_750c_Z08::HEIGHT / 2> display(
+  GxEPD2_Paged_Display<GxEPD2_3C<GxEPD2_750c_Z08,
+                       GxEPD2_750c_Z08::HEIGHT / 2>> display(
     GxEPD2_750c_Z08(PIN_EPD_CS,
                     PIN_EPD_DC,
                     PIN_EPD_RST,
                     PIN_EPD_BUSY));
 #endif
 #ifdef DISP_7C_F
-  GxEPD2_7C<GxEPD2_730c_GDEY073D46,
-            GxEPD2_730c_GDEY073D46::HEIGHT / 4> display(
+  GxEPD2_Paged_Display<GxEPD2_7C<GxEPD2_730c_GDEY073D46,
+                       GxEPD2_730c_GDEY073D46::HEIGHT / 4>> display(
     GxEPD2_730c_GDEY073D46(PIN_EPD_CS,
                            PIN_EPD_DC,
                            PIN_EPD_RST,
                            PIN_EPD_BUSY));
 #endif
 #ifdef DISP_BW_V1
-  GxEPD2_BW<GxEPD2_750,
-            GxEPD2_750::HEIGHT> display(
+  GxEPD2_BW_Display<GxEPD2_750,
+                    GxEPD2_750::HEIGHT / 8> display(
     GxEPD2_750(PIN_EPD_CS,
                PIN_EPD_DC,
                PIN_EPD_RST,
@@ -77,163 +93,249 @@
   #define ACCENT_COLOR GxEPD_BLACK
 #endif
 
+#if FRAME_DIFF_ACTIVE
+#define FRAME_TILES_X (DISP_WIDTH / FRAME_TILE_SIZE)
+#define FRAME_TILES_Y (DISP_HEIGHT / FRAME_TILE_SIZE)
+// RTC memory: tile hashes of the frame on the panel, 0 where unknown. (~1.5KB)
+RTC_DATA_ATTR static bool     rtc_frame_valid    = false;
+RTC_DATA_ATTR static uint8_t  rtc_frame_partials = 0;
+RTC_DATA_ATTR static uint32_t rtc_frame_hashes[FRAME_TILES_X * FRAME_TILES_Y];
+#endif
+
+#if DISPLAY_LIST_ACTIVE
+// draw calls of the frame being drawn, replayed for each page
+static display_list_t frameList;
+#endif
+
+// time spent drawing the frame being drawn, not counting panel transfers
+static unsigned long frameDrawMs;
+static unsigned long frameDrawStart;
+
+// rows of the page being drawn, the whole frame unless it is drawn in pages
+static int16_t pageTop;
+static int16_t pageBottom;
+
+// outlook graph temperature curve
+#define GRAPH_TEMP_LINE_WIDTH 2
+// precipitation bars: every other pixel (even x) of every other row, the rows
+// of the same parity (even or odd y) as the bottom row of the bar
+static const uint8_t PRECIP_HATCH_EVEN[8] = {0xAA, 0x00, 0xAA, 0x00,
+                                             0xAA, 0x00, 0xAA, 0x00};
+static const uint8_t PRECIP_HATCH_ODD[8]  = {0x00, 0xAA, 0x00, 0xAA,
+                                             0x00, 0xAA, 0x00, 0xAA};
+
+// True once the background of the frame being drawn is on it, the other draw
+// functions then leave out what is part of it.
+static bool backgroundDrawn = false;
+
+// Widgets that can be drawn from the widget cache.
+typedef enum widget_id
+{
+  WIDGET_CURRENT_HEADER,  // current weather icon, temperature and feels like
+  WIDGET_FORECAST,        // five day forecast
+  WIDGET_COUNT
+} widget_id_t;
+
+#if WIDGET_CACHE_ACTIVE
+typedef struct widget_stats
+{
+  uint16_t hits;
+  uint16_t misses;
+  uint32_t draw_us;       // time to draw the widget, last miss
+  uint32_t saved_us;      // total time saved by hits
+} widget_stats_t;
+
+// area each widget draws in, x and w are multiples of 8
+static constexpr layout_id_t WIDGET_AREAS[WIDGET_COUNT] = {
+  LAYOUT_CURRENT_HEADER,
+  LAYOUT_FORECAST
+};
+static_assert(LAYOUT[LAYOUT_CURRENT_HEADER].x % 8 == 0
+           && LAYOUT[LAYOUT_CURRENT_HEADER].w % 8 == 0
+           && LAYOUT[LAYOUT_FORECAST].x % 8 == 0
+           && LAYOUT[LAYOUT_FORECAST].w % 8 == 0,
+              "Cached widgets must be aligned to bytes of the frame.");
+#if DEBUG_LEVEL >= 1
+static const char *WIDGET_NAMES[WIDGET_COUNT] = {"current", "forecast"};
+#endif
+static const char *WIDGET_FILES[WIDGET_COUNT] = {"/widget_current.bin",
+                                                 "/widget_forecast.bin"};
+// RTC memory: widget cache statistics since power on
+RTC_DATA_ATTR static widget_stats_t rtc_widget_stats[WIDGET_COUNT];
+
+/* Returns the size of the render of a widget, 1bpp.
+ */
+static constexpr size_t widgetSize(widget_id_t id)
+{
+  return (LAYOUT[WIDGET_AREAS[id]].w / 8) * LAYOUT[WIDGET_AREAS[id]].h;
+} // end widgetSize
+
+// Render of each widget for the frame being drawn. beginFrame() loads them from
+// flash and nextFrame() stores those that were redrawn, so that drawing the
+// frame neither allocates nor opens files.
+typedef struct widget_slot
+{
+  uint8_t    *bits;       // widgetSize() bytes
+  uint32_t    key;        // key bits were drawn for
+  bool        valid;      // bits hold a render for key
+  bool        dirty;      // redrawn this frame, to be stored
+  const char *result;     // "hit" or "miss" this frame, nullptr if not drawn
+} widget_slot_t;
+
+static uint8_t widgetCurrentBits[widgetSize(WIDGET_CURRENT_HEADER)];
+static uint8_t widgetForecastBits[widgetSize(WIDGET_FORECAST)];
+static widget_slot_t widgetSlots[WIDGET_COUNT] = {
+  {widgetCurrentBits,  0, false, false, nullptr},
+  {widgetForecastBits, 0, false, false, nullptr}
+};
+#endif
+
+/* Returns the bounds of text in the current font, as getTextBounds() gives
+ * them at (0, 0).
+ */
+static text_bounds_t getStringBounds(const char *text)
+{
+  const GFXfont *font = display.getFont();
+  if (font != nullptr)
+  {
+    return fontTextBounds(font, text, strlen(text));
+  }
+  text_bounds_t b;
+  display.getTextBounds(text, 0, 0, &b.x, &b.y, &b.w, &b.h);
+  return b;
+} // end getStringBounds
+
 /* Returns the string width in pixels
  */
+uint16_t getStringWidth(const char *text)
+{
+  const GFXfont *font = display.getFont();
+  if (font != nullptr)
+  {
+    return fontTextWidth(font, text, strlen(text));
+  }
+  return getStringBounds(text).w;
+}
+
 uint16_t getStringWidth(const String &text)
 {
-  int16_t x1, y1;
-  uint16_t w, h;
-  display.getTextBounds(text, 0, 0, &x1, &y1, &w, &h);
-  return w;
+  return getStringWidth(text.c_str());
 }
 
 /* Returns the string height in pixels
  */
+uint16_t getStringHeight(const char *text)
+{
+  return getStringBounds(text).h;
+}
+
 uint16_t getStringHeight(const String &text)
 {
-  int16_t x1, y1;
-  uint16_t w, h;
-  display.getTextBounds(text, 0, 0, &x1, &y1, &w, &h);
-  return h;
+  return getStringHeight(text.c_str());
 }
 
 /* Draws a string with alignment
  */
-void drawString(int16_t x, int16_t y, const String &text, alignment_t alignment,
+void drawString(int16_t x, int16_t y, const char *text, alignment_t alignment,
                 uint16_t color)
 {
-  int16_t x1, y1;
-  uint16_t w, h;
   display.setTextColor(color);
-  display.getTextBounds(text, x, y, &x1, &y1, &w, &h);
   if (alignment == RIGHT)
   {
-    x = x - w;
+    x = x - getStringWidth(text);
   }
   if (alignment == CENTER)
   {
-    x = x - w / 2;
+    x = x - getStringWidth(text) / 2;
   }
   display.setCursor(x, y);
   display.print(text);
   return;
 } // end drawString
 
+void drawString(int16_t x, int16_t y, const String &text, alignment_t alignment,
+                uint16_t color)
+{
+  drawString(x, y, text.c_str(), alignment, color);
+}
+
 /* Draws a string that will flow into the next line when max_width is reached.
  * If a string exceeds max_lines an ellipsis (...) will terminate the last word.
- * Lines will break at spaces(' ') and dashes('-').
+ * Lines will break at spaces(' ') and dashes('-'), see wrapLine().
  *
  * Note: max_width should be big enough to accommodate the largest word that
  *       will be displayed. If an unbroken string of characters longer than
  *       max_width exist in text, then the string will be printed beyond
  *       max_width.
+ *
+ * Note: text must be drawn in a font set with setFont().
  */
-void drawMultiLnString(int16_t x, int16_t y, const String &text,
+void drawMultiLnString(int16_t x, int16_t y, const char *text,
                        alignment_t alignment, uint16_t max_width,
                        uint16_t max_lines, int16_t line_spacing,
                        uint16_t color)
 {
-  uint16_t current_line = 0;
-  String textRemaining = text;
+  const GFXfont *font = display.getFont();
+  const char *textRemaining = text;
+  size_t lenRemaining = strlen(text);
+  Print &out = display;
+  display.setTextColor(color);
   // print until we reach max_lines or no more text remains
-  while (current_line < max_lines && !textRemaining.isEmpty())
+  for (uint16_t current_line = 0;
+       current_line < max_lines && lenRemaining > 0;
+       ++current_line)
   {
-    int16_t  x1, y1;
-    uint16_t w, h;
-
-    display.getTextBounds(textRemaining, 0, 0, &x1, &y1, &w, &h);
-
-    int endIndex = textRemaining.length();
-    // check if remaining text is to wide, if it is then print what we can
-    String subStr = textRemaining;
-    int splitAt = 0;
-    int keepLastChar = 0;
-    while (w > max_width && splitAt != -1)
+    text_line_t line;
+    const size_t next = wrapLine(font, textRemaining, lenRemaining, max_width,
+                                 current_line == max_lines - 1, line);
+    int16_t lineX = x;
+    if (alignment == RIGHT)
     {
-      if (keepLastChar)
-      {
-        // if we kept the last character during the last iteration of this while
-        // loop, remove it now so we don't get stuck in an infinite loop.
-        subStr.remove(subStr.length() - 1);
-      }
-
-      // find the last place in the string that we can break it.
-      if (current_line < max_lines - 1)
-      {
-        splitAt = std::max(subStr.lastIndexOf(" "),
-                           subStr.lastIndexOf("-"));
-      }
-      else
-      {
-        // this is the last line, only break at spaces so we can add ellipsis
-        splitAt = subStr.lastIndexOf(" ");
-      }
-
-      // if splitAt == -1 then there is an unbroken set of characters that is
-      // longer than max_width. Otherwise if splitAt != -1 then we can continue
-      // the loop until the string is <= max_width
-      if (splitAt != -1)
-      {
-        endIndex = splitAt;
-        subStr = subStr.substring(0, endIndex + 1);
-
-        char lastChar = subStr.charAt(endIndex);
-        if (lastChar == ' ')
-        {
-          // remove this char now so it is not counted towards line width
-          keepLastChar = 0;
-          subStr.remove(endIndex);
-          --endIndex;
-        }
-        else if (lastChar == '-')
-        {
-          // this char will be printed on this line and removed next iteration
-          keepLastChar = 1;
-        }
-
-        if (current_line < max_lines - 1)
-        {
-          // this is not the last line
-          display.getTextBounds(subStr, 0, 0, &x1, &y1, &w, &h);
-        }
-        else
-        {
-          // this is the last line, we need to make sure there is space for
-          // ellipsis
-          display.getTextBounds(subStr + "...", 0, 0, &x1, &y1, &w, &h);
-          if (w <= max_width)
-          {
-            // ellipsis fit, add them to subStr
-            subStr = subStr + "...";
-          }
-        }
-
-      } // end if (splitAt != -1)
-    } // end inner while
-
-    drawString(x, y + (current_line * line_spacing), subStr, alignment, color);
-
-    // update textRemaining to no longer include what was printed
-    // +1 for exclusive bounds, +1 to get passed space/dash
-    textRemaining = textRemaining.substring(endIndex + 2 - keepLastChar);
+      lineX = x - line.w;
+    }
+    if (alignment == CENTER)
+    {
+      lineX = x - line.w / 2;
+    }
+    // lines are printed straight from text, without copying them
+    display.setCursor(lineX, y + (current_line * line_spacing));
+    out.write(reinterpret_cast<const uint8_t *>(textRemaining), line.len);
+    if (line.ellipsis)
+    {
+      out.print("...");
+    }
 
-    ++current_line;
-  } // end outer while
+    textRemaining += next;
+    lenRemaining -= next;
+  }
 
   return;
 } // end drawMultiLnString
 
+void drawMultiLnString(int16_t x, int16_t y, const String &text,
+                       alignment_t alignment, uint16_t max_width,
+                       uint16_t max_lines, int16_t line_spacing,
+                       uint16_t color)
+{
+  drawMultiLnString(x, y, text.c_str(), alignment, max_width, max_lines,
+                    line_spacing, color);
+}
+
 /* Initialize e-paper display
+ *
+ * If partial is true the display is not forced to do a full refresh first, so
+ * that only partial windows can be updated.
  */
-void initDisplay()
+void initDisplay(bool partial)
 {
+  beginEnergyPhase(ENERGY_PHASE_DISPLAY);
   pinMode(PIN_EPD_PWR, OUTPUT);
   digitalWrite(PIN_EPD_PWR, HIGH);
 #ifdef DRIVER_WAVESHARE
-  display.init(115200, true, 2, false);
+  display.init(115200, !partial, 2, false);
 #endif
 #ifdef DRIVER_DESPI_C02
-  display.init(115200, true, 10, false);
+  display.init(115200, !partial, 10, false);
 #endif
   // remap spi
   SPI.end();
@@ -249,6 +351,17 @@ void initDisplay()
   // display.fillScreen(GxEPD_WHITE);
   display.setFullWindow();
   display.firstPage(); // use paged drawing mode, sets fillScreen(GxEPD_WHITE)
+  backgroundDrawn = false;
+#if SKIP_UNCHANGED_DISPLAY
+  // whatever is drawn next replaces the last fully rendered state
+  invalidateDisplayState();
+#endif
+#if FRAME_DIFF_ACTIVE
+  if (!partial)
+  { // the panel will be fully redrawn without being tracked
+    rtc_frame_valid = false;
+  }
+#endif
   return;
 } // end initDisplay
 
@@ -259,10 +372,704 @@ void powerOffDisplay()
   display.hibernate(); // turns powerOff() and sets controller to deep sleep for
                        // minimum power use
   digitalWrite(PIN_EPD_PWR, LOW);
+  endEnergyPhase(ENERGY_PHASE_DISPLAY);
   return;
 } // end initDisplay
 
 
+#if FRAME_DIFF_ACTIVE
+/* Returns true once the flash file system holding the frame on the panel and
+ * the widget and background caches is mounted. It is formatted if it can't be
+ * mounted.
+ */
+static bool mountFlashCache()
+{
+  static bool attempted = false;
+  static bool mounted = false;
+  if (!attempted)
+  {
+    attempted = true;
+    mounted = LittleFS.begin(true);
+    if (!mounted)
+    {
+      Serial.println("Flash cache: failed to mount file system");
+    }
+  }
+  return mounted;
+} // end mountFlashCache
+
+#if WIDGET_CACHE_ACTIVE || BACKGROUND_CACHE_ACTIVE
+/* Identifies the firmware build, so that renders cached by a different build
+ * (other fonts, icons or layout) are not reused. Derived from the SHA-256 of the
+ * ELF the running image was built from, which changes with any source file and
+ * stays the same across reflashing an identical image.
+ */
+static uint32_t widgetBuildId()
+{
+  const esp_app_desc_t *app = esp_ota_get_app_description();
+  uint32_t h = 2166136261u;
+  for (size_t i = 0; i < sizeof(app->app_elf_sha256); ++i)
+  {
+    h = (h ^ app->app_elf_sha256[i]) * 16777619u;
+  }
+  return h;
+} // end widgetBuildId
+#endif
+
+#if WIDGET_CACHE_ACTIVE
+/* Reads the cached render of a widget and the key it was drawn for into its
+ * slot. Returns false if there is none.
+ */
+static bool readWidget(widget_id_t id, widget_slot_t &slot)
+{
+  if (!LittleFS.exists(WIDGET_FILES[id]))
+  {
+    return false;
+  }
+  File f = LittleFS.open(WIDGET_FILES[id], "r");
+  if (!f)
+  {
+    return false;
+  }
+  uint32_t header[2] = {};
+  bool ok = f.size() == sizeof(header) + widgetSize(id)
+         && f.read(reinterpret_cast<uint8_t *>(header), sizeof(header))
+            == sizeof(header)
+         && header[0] == widgetBuildId()
+         && f.read(slot.bits, widgetSize(id)) == widgetSize(id);
+  f.close();
+  slot.key = header[1];
+  return ok;
+} // end readWidget
+
+/* Stores the render of a widget in its slot, replacing the previous one.
+ */
+static void writeWidget(widget_id_t id, const widget_slot_t &slot)
+{
+  File f = LittleFS.open(WIDGET_FILES[id], "w");
+  if (!f)
+  {
+    return;
+  }
+  const uint32_t header[2] = {widgetBuildId(), slot.key};
+  f.write(reinterpret_cast<const uint8_t *>(header), sizeof(header));
+  f.write(slot.bits, widgetSize(id));
+  f.close();
+  return;
+} // end writeWidget
+
+/* Loads the cached render of every widget, before the frame is drawn.
+ */
+static void loadWidgets()
+{
+  const bool mounted = mountFlashCache();
+  for (int i = 0; i < WIDGET_COUNT; ++i)
+  {
+    widget_slot_t &slot = widgetSlots[i];
+    slot.valid = mounted && readWidget(static_cast<widget_id_t>(i), slot);
+    slot.dirty = false;
+    slot.result = nullptr;
+  }
+  return;
+} // end loadWidgets
+
+/* Stores the widgets that were redrawn, after the frame is drawn. With
+ * DEBUG_LEVEL >= 1 it logs how the cache did for each widget drawn.
+ */
+static void storeWidgets()
+{
+  for (int i = 0; i < WIDGET_COUNT; ++i)
+  {
+    widget_slot_t &slot = widgetSlots[i];
+    if (slot.result == nullptr)
+    {
+      continue;
+    }
+    if (slot.dirty)
+    {
+      writeWidget(static_cast<widget_id_t>(i), slot);
+      slot.dirty = false;
+    }
+#if DEBUG_LEVEL >= 1
+    const widget_stats_t &stats = rtc_widget_stats[i];
+    const unsigned total = stats.hits + stats.misses;
+    Serial.printf("[debug] Widget cache    : %s %s, %u/%u hits (%u%%), "
+                  "%ums saved\n", WIDGET_NAMES[i], slot.result,
+                  static_cast<unsigned>(stats.hits), total,
+                  100 * stats.hits / total,
+                  static_cast<unsigned>(stats.saved_us / 1000));
+#endif
+    slot.result = nullptr;
+  }
+  return;
+} // end storeWidgets
+#endif
+
+#if BACKGROUND_CACHE_ACTIVE
+#define BACKGROUND_FILE "/background.bin"
+
+typedef struct background_header
+{
+  uint32_t build;
+  int32_t  graph_right;
+  uint32_t size;          // of the compressed frame that follows
+} background_header_t;
+
+// Stored background, read by beginFrame() so that drawing it neither allocates
+// nor opens files, nullptr if there is none.
+static background_header_t backgroundHeader;
+static uint8_t *backgroundPacked = nullptr;
+// Right edge of the outlook graph of a background drawn because none was
+// stored for it, stored once the frame is shown, -1 if none.
+static int backgroundToStore = -1;
+
+static void drawBackgroundLayer(int graphRight);
+
+/* Reads the stored background, compressed, before the frame is drawn.
+ */
+static void readBackground()
+{
+  if (!mountFlashCache() || !LittleFS.exists(BACKGROUND_FILE))
+  {
+    return;
+  }
+  File f = LittleFS.open(BACKGROUND_FILE, "r");
+  if (!f)
+  {
+    return;
+  }
+  background_header_t &header = backgroundHeader;
+  if (f.read(reinterpret_cast<uint8_t *>(&header), sizeof(header))
+        == sizeof(header)
+   && header.build == widgetBuildId()
+   && f.size() == sizeof(header) + header.size)
+  {
+    backgroundPacked = static_cast<uint8_t *>(malloc(header.size));
+    if (backgroundPacked != nullptr
+     && f.read(backgroundPacked, header.size) != header.size)
+    {
+      free(backgroundPacked);
+      backgroundPacked = nullptr;
+    }
+  }
+  f.close();
+  return;
+} // end readBackground
+
+/* Frees the stored background read by readBackground().
+ */
+static void freeBackground()
+{
+  free(backgroundPacked);
+  backgroundPacked = nullptr;
+  return;
+} // end freeBackground
+
+/* Draws the stored background for this graph variant into the frame. Returns
+ * false if there is none. Each row is decoded and ANDed into the frame a byte at
+ * a time, which only adds black pixels, the frame is white when the background
+ * is drawn. The background is stored as captured, in panel orientation, so it
+ * is copied as is whatever the rotation.
+ */
+static bool loadBackground(int graphRight)
+{
+  if (backgroundPacked == nullptr || backgroundHeader.graph_right != graphRight)
+  {
+    return false;
+  }
+  const int stride = DISP_WIDTH / 8;
+  uint8_t row[stride];
+  size_t in = 0;
+  bool ok = true;
+  for (int y = 0; ok && y < DISP_HEIGHT; ++y)
+  {
+    const size_t used = packBitsDecode(backgroundPacked + in,
+                                       backgroundHeader.size - in, row, stride);
+    ok = used > 0;
+    in += used;
+    uint8_t *dst = display.capture + y * stride;
+    for (int b = 0; ok && b < stride; ++b)
+    {
+      dst[b] &= row[b];
+    }
+  }
+  return ok;
+} // end loadBackground
+
+/* Stores the captured frame, which only holds the background so far, for this
+ * graph variant.
+ */
+static void storeBackground(int graphRight)
+{
+  const int stride = DISP_WIDTH / 8;
+  uint8_t *packed = static_cast<uint8_t *>(
+                      malloc(PACKBITS_MAX_SIZE(stride) * DISP_HEIGHT));
+  if (packed == nullptr)
+  {
+    return;
+  }
+  background_header_t header = {widgetBuildId(), graphRight, 0};
+  for (int y = 0; y < DISP_HEIGHT; ++y)
+  {
+    header.size += packBitsEncode(display.capture + y * stride, stride,
+                                  packed + header.size);
+  }
+  File f = LittleFS.open(BACKGROUND_FILE, "w");
+  if (f)
+  {
+    f.write(reinterpret_cast<const uint8_t *>(&header), sizeof(header));
+    f.write(packed, header.size);
+    f.close();
+#if DEBUG_LEVEL >= 1
+    Serial.printf("[debug] Background      : stored %uB\n",
+                  static_cast<unsigned>(header.size));
+#endif
+  }
+  free(packed);
+  return;
+} // end storeBackground
+
+/* Stores the background drawn by drawBackground() because none was stored for
+ * its outlook graph. The frame holds more than the background by then, so the
+ * background is drawn again on its own into the captured frame, which must have
+ * been shown already.
+ */
+static void storeNewBackground()
+{
+  if (backgroundToStore < 0 || display.capture == nullptr)
+  {
+    return;
+  }
+  display.fillScreen(GxEPD_WHITE);
+  drawBackgroundLayer(backgroundToStore);
+  storeBackground(backgroundToStore);
+  backgroundToStore = -1;
+  return;
+} // end storeNewBackground
+#endif
+
+#define FRAME_FILE "/frame.bin"
+
+/* Reads the frame on the panel, stored by storeShownFrame(), into frame.
+ * Returns false if it is not known.
+ */
+static bool loadShownFrame(uint8_t *frame)
+{
+  if (!rtc_frame_valid || !mountFlashCache() || !LittleFS.exists(FRAME_FILE))
+  {
+    return false;
+  }
+  File f = LittleFS.open(FRAME_FILE, "r");
+  if (!f)
+  {
+    return false;
+  }
+  uint32_t size = 0;
+  if (f.read(reinterpret_cast<uint8_t *>(&size), sizeof(size)) != sizeof(size)
+   || f.size() != sizeof(size) + size)
+  {
+    f.close();
+    return false;
+  }
+  uint8_t *packed = static_cast<uint8_t *>(malloc(size));
+  bool ok = packed != nullptr && f.read(packed, size) == size;
+  f.close();
+
+  const int stride = DISP_WIDTH / 8;
+  size_t in = 0;
+  for (int y = 0; ok && y < DISP_HEIGHT; ++y)
+  {
+    const size_t used = packBitsDecode(packed + in, size - in,
+                                       frame + y * stride, stride);
+    ok = used > 0;
+    in += used;
+  }
+  free(packed);
+  return ok;
+} // end loadShownFrame
+
+/* Stores the frame that is now on the panel compressed in flash. The panel is
+ * powered off between updates, which loses the previous image the controller
+ * compares against in a partial refresh, so it is written back from here.
+ * Returns false if it could not be stored.
+ */
+static bool storeShownFrame(const uint8_t *frame)
+{
+  const int stride = DISP_WIDTH / 8;
+  if (!mountFlashCache())
+  {
+    return false;
+  }
+  uint8_t *packed = static_cast<uint8_t *>(
+                      malloc(PACKBITS_MAX_SIZE(stride) * DISP_HEIGHT));
+  if (packed == nullptr)
+  {
+    return false;
+  }
+  uint32_t size = 0;
+  for (int y = 0; y < DISP_HEIGHT; ++y)
+  {
+    size += packBitsEncode(frame + y * stride, stride, packed + size);
+  }
+  File f = LittleFS.open(FRAME_FILE, "w");
+  bool ok = static_cast<bool>(f);
+  if (ok)
+  {
+    ok = f.write(reinterpret_cast<const uint8_t *>(&size), sizeof(size))
+           == sizeof(size)
+      && f.write(packed, size) == size;
+    f.close();
+  }
+  free(packed);
+  return ok;
+} // end storeShownFrame
+#endif
+
+/* Logs how long the frame took to draw, not counting panel transfers and
+ * refreshes, and the heap and PSRAM left, with DEBUG_LEVEL >= 1. mode is how
+ * the frame was drawn.
+ */
+static void logFrameStats(const char *mode)
+{
+#if DEBUG_LEVEL >= 1
+  Serial.printf("[debug] Render          : %s, %lums drawing, heap %uKB free "
+                "(%uKB min)\n", mode, frameDrawMs,
+                static_cast<unsigned>(ESP.getFreeHeap() / 1024),
+                static_cast<unsigned>(ESP.getMinFreeHeap() / 1024));
+  if (psramFound())
+  {
+    Serial.printf("[debug] Free PSRAM      : %uKB\n",
+                  static_cast<unsigned>(ESP.getFreePsram() / 1024));
+  }
+#endif
+  return;
+} // end logFrameStats
+
+/* Starts drawing a full frame, to be used as
+ *   beginFrame();
+ *   do { draw... } while (nextFrame());
+ *
+ * On black and white panels the frame is drawn once into a frame buffer of its
+ * own (captured), through the frame backend, if it can be allocated. With
+ * FRAME_DIFF nextFrame() then refreshes only what changed. With PSRAM_FRAME
+ * the frame is drawn once into a full frame buffer in PSRAM, if the board has
+ * enough of it. Otherwise, with DISPLAY_LIST the frame is drawn once into a
+ * display list, which nextFrame() replays for each page. Otherwise this is a
+ * paged full refresh.
+ */
+void beginFrame()
+{
+#if FRAME_CAPTURE_ACTIVE
+  initDisplay(FRAME_DIFF_ACTIVE);
+  // without memory the frame is drawn into the pages of the display buffer
+  display.capture = static_cast<uint8_t *>(
+                      malloc((DISP_WIDTH / 8) * DISP_HEIGHT));
+  display.fillScreen(GxEPD_WHITE);
+#if FRAME_DIFF_ACTIVE
+  if (display.capture == nullptr)
+  { // the panel will be fully redrawn in pages without being tracked
+    rtc_frame_valid = false;
+    rtc_frame_partials = 0;
+  }
+#endif
+#if WIDGET_CACHE_ACTIVE
+  if (display.capture != nullptr)
+  {
+    loadWidgets();
+  }
+#endif
+#if BACKGROUND_CACHE_ACTIVE
+  if (display.capture != nullptr)
+  {
+    readBackground();
+  }
+#endif
+#else
+  initDisplay();
+#endif
+#if PSRAM_FRAME_ACTIVE
+  if (psramFound())
+  { // without PSRAM the frame is drawn in pages
+    display.frame = static_cast<uint8_t *>(ps_malloc(display.frameSize()));
+  }
+  if (display.frame != nullptr)
+  {
+    display.fillScreen(GxEPD_WHITE);
+  }
+  else
+#endif
+  {
+#if DISPLAY_LIST_ACTIVE
+    void *mem = malloc(dlMemSize());
+    if (mem != nullptr)
+    { // without memory each page is drawn in full
+      dlInit(frameList, mem);
+      display.list = &frameList;
+    }
+#endif
+  }
+  pageTop = 0;
+  pageBottom = display.pageHeight();
+#if PSRAM_FRAME_ACTIVE || DISPLAY_LIST_ACTIVE
+  if (display.frame != nullptr || display.list != nullptr)
+  {
+    pageBottom = DISP_HEIGHT;
+  }
+#endif
+  frameDrawMs = 0;
+  frameDrawStart = millis();
+  return;
+} // end beginFrame
+
+/* Finishes a page of a frame started by beginFrame(). Returns true if there is
+ * another page to draw.
+ *
+ * With FRAME_DIFF the captured frame is compared with the frame on the panel in
+ * tiles. Changed tiles are refreshed with partial windows, unless the previous
+ * frame is unknown, too many partial refreshes have been done since the last
+ * full refresh (ghosting) or too much of the display changed. The captured
+ * frame is what is shown, the display buffer is not drawn into. The frame is
+ * kept in flash, as the panel loses its previous image when powered off, and
+ * so is a new background with BACKGROUND_CACHE.
+ *
+ * Otherwise a captured frame is shown with a full refresh. A frame that could
+ * not be captured is drawn again for each page of the display buffer and
+ * refreshed in full. With PSRAM_FRAME the full frame is written to the panel
+ * at once.
+ *
+ * With DISPLAY_LIST the recorded frame is replayed for every page, skipping the
+ * commands that do not intersect it.
+ */
+bool nextFrame()
+{
+  frameDrawMs += millis() - frameDrawStart;
+#if FRAME_DIFF_ACTIVE
+  if (display.capture != nullptr)
+  {
+    logFrameStats("full frame");
+#if WIDGET_CACHE_ACTIVE
+    storeWidgets();
+#endif
+#if BACKGROUND_CACHE_ACTIVE
+    freeBackground();
+#endif
+#if DEBUG_LEVEL >= 1
+    const unsigned long refreshStart = millis();
+#endif
+    uint32_t hashes[FRAME_TILES_X * FRAME_TILES_Y];
+    frame_diff_t d = {};
+    frameHashTiles(display.capture, DISP_WIDTH, DISP_HEIGHT, hashes);
+    frameDiffTiles(rtc_frame_hashes, hashes, FRAME_TILES_X, FRAME_TILES_Y, d);
+    frame_policy_t policy = {FRAME_DIFF_MAX_AREA,
+                             FRAME_DIFF_FULL_REFRESH_CYCLES};
+    frame_refresh_t mode = frameRefreshPolicy(d, rtc_frame_valid,
+                                              rtc_frame_partials, policy);
+
+    // a partial refresh needs the frame on the panel as the previous image
+    uint8_t *shown = nullptr;
+    if (mode == FRAME_REFRESH_PARTIAL)
+    {
+      shown = static_cast<uint8_t *>(malloc((DISP_WIDTH / 8) * DISP_HEIGHT));
+      if (shown == nullptr || !loadShownFrame(shown))
+      {
+        mode = FRAME_REFRESH_FULL;
+      }
+    }
+
+    if (mode == FRAME_REFRESH_FULL)
+    {
+      display.displayCapture();
+      rtc_frame_partials = 0;
+    }
+    else if (mode == FRAME_REFRESH_PARTIAL)
+    {
+      for (int i = 0; i < d.num_rects; ++i)
+      {
+        display.displayCaptureWindow(shown, d.rects[i].x, d.rects[i].y,
+                                     d.rects[i].w, d.rects[i].h);
+      }
+      ++rtc_frame_partials;
+    }
+    free(shown);
+
+    // the stored frame is only rewritten when the panel changed
+    memcpy(rtc_frame_hashes, hashes, sizeof(rtc_frame_hashes));
+    rtc_frame_valid = (mode == FRAME_REFRESH_NONE && rtc_frame_valid)
+                   || storeShownFrame(display.capture);
+#if BACKGROUND_CACHE_ACTIVE
+    storeNewBackground();
+#endif
+    free(display.capture);
+    display.capture = nullptr;
+
+#if DEBUG_LEVEL >= 1
+    const char *modeStr[] = {"none", "partial", "full"};
+    const unsigned permille = 1000u * d.changed_tiles / d.total_tiles;
+    Serial.printf("[debug] Display refresh : %s, %d windows, %u.%u%% changed, "
+                  "%lums\n", modeStr[mode], d.num_rects, permille / 10,
+                  permille % 10, millis() - refreshStart);
+#endif
+    return false;
+  }
+#endif
+#if FRAME_CAPTURE_ACTIVE
+  if (display.capture != nullptr)
+  {
+    logFrameStats("full frame");
+    display.displayCapture();
+    free(display.capture);
+    display.capture = nullptr;
+    return false;
+  }
+#endif
+#if PSRAM_FRAME_ACTIVE
+  if (display.frame != nullptr)
+  {
+    logFrameStats("PSRAM frame");
+    display.writeFrame();
+    free(display.frame);
+    display.frame = nullptr;
+    return false;
+  }
+#endif
+#if DISPLAY_LIST_ACTIVE
+  if (display.list != nullptr)
+  {
+    display.list = nullptr;
+    if (frameList.overflow)
+    { // the frame did not fit, nothing has been drawn yet so draw it again for
+      // each page instead
+      Serial.println("Display list full, drawing each page in full");
+      free(frameList.cmds);
+      pageBottom = display.pageHeight();
+      frameDrawStart = millis();
+      return true;
+    }
+    dlFinish(frameList);
+#if DEBUG_LEVEL >= 1
+    Serial.println("[debug] Display list    : " + String(frameList.num_cmds)
+                   + " commands, " + String(frameList.text_len) + "B text");
+#endif
+    int16_t pageY = 0;
+    do
+    {
+      const unsigned long replayStart = millis();
+      display.replay(frameList, pageY, pageY + display.pageHeight() - 1);
+      frameDrawMs += millis() - replayStart;
+      pageY += display.pageHeight();
+    } while (display.nextPage());
+    logFrameStats("display list");
+    free(frameList.cmds);
+    return false;
+  }
+#endif
+  if (display.nextPage())
+  {
+    // GxEPD2_BW goes through the pages twice on panels with fast partial
+    // refresh, the second time to write them as the previous image
+    pageTop += display.pageHeight();
+    if (pageTop >= DISP_HEIGHT)
+    {
+      pageTop = 0;
+    }
+    pageBottom = pageTop + display.pageHeight();
+    frameDrawStart = millis();
+    return true;
+  }
+  logFrameStats("paged");
+  return false;
+} // end nextFrame
+
+/* Returns true if the area of id is on the page being drawn, that is always
+ * unless the frame is drawn in pages. Anything outside the page is clipped, so
+ * drawing it can be skipped.
+ */
+bool onPage(layout_id_t id)
+{
+  return layoutInRows(LAYOUT[id], pageTop, pageBottom);
+} // end onPage
+
+// Icon and label of each current conditions widget, which are part of the
+// background.
+typedef struct current_widget_frame
+{
+  layout_id_t        id;
+  const uint8_t     *icon;    // 48x48
+  const uint8_t     *badge;   // 24x24 in the icon's top right corner, or null
+  const char *const *label;
+} current_widget_frame_t;
+
+static const current_widget_frame_t CURRENT_WIDGET_FRAMES[] = {
+#ifdef POS_SUNRISE
+  {LAYOUT_SUNRISE,      wi_sunrise_48x48,        nullptr, &TXT_SUNRISE},
+#endif
+#ifdef POS_SUNSET
+  {LAYOUT_SUNSET,       wi_sunset_48x48,         nullptr, &TXT_SUNSET},
+#endif
+#ifdef POS_WIND
+  {LAYOUT_WIND,         wi_strong_wind_48x48,    nullptr, &TXT_WIND},
+#endif
+#ifdef POS_HUMIDITY
+  {LAYOUT_HUMIDITY,     wi_humidity_48x48,       nullptr, &TXT_HUMIDITY},
+#endif
+#ifdef POS_UVI
+  {LAYOUT_UVI,          wi_day_sunny_48x48,      nullptr, &TXT_UV_INDEX},
+#endif
+#ifdef POS_PRESSURE
+  {LAYOUT_PRESSURE,     wi_barometer_48x48,      nullptr, &TXT_PRESSURE},
+#endif
+#ifdef POS_VISIBILITY
+  {LAYOUT_VISIBILITY,   visibility_icon_48x48,   nullptr, &TXT_VISIBILITY},
+#endif
+#ifdef POS_AIR_QULITY
+  {LAYOUT_AIR_QUALITY,  air_filter_48x48,        nullptr, &TXT_AIR_QUALITY},
+#endif
+#ifdef POS_INTEMP
+  {LAYOUT_INTEMP,       house_thermometer_48x48, nullptr, &TXT_INDOOR_TEMPERATURE},
+#endif
+#ifdef POS_INHUMIDITY
+  {LAYOUT_INHUMIDITY,   house_humidity_48x48,    nullptr, &TXT_INDOOR_HUMIDITY},
+#endif
+#ifdef POS_DEWPOINT
+  {LAYOUT_DEWPOINT,     wi_thermometer_48x48,    wi_raindrops_24x24, &TXT_DEWPOINT},
+#endif
+};
+
+/* Draws the icon and label of a current conditions widget.
+ */
+static void drawCurrentWidgetFrame(const current_widget_frame_t &f)
+{
+  const layout_rect_t &r = LAYOUT[f.id];
+  display.drawInvertedBitmap(r.x, r.y, f.icon, 48, 48, GxEPD_BLACK);
+  if (f.badge != nullptr)
+  {
+    display.drawInvertedBitmap(r.x + 48 - 24, r.y + 4,
+                               f.badge, 24, 24, GxEPD_BLACK);
+  }
+  display.setFont(&FONT_7pt8b);
+  drawString(r.x + 48, r.y + 10, *f.label, LEFT);
+  return;
+} // end drawCurrentWidgetFrame
+
+/* Draws the icon and label of the current conditions widget id, unless the
+ * background with them has already been drawn.
+ */
+static void drawCurrentWidgetFrame(layout_id_t id)
+{
+  if (backgroundDrawn)
+  {
+    return;
+  }
+  for (const current_widget_frame_t &f : CURRENT_WIDGET_FRAMES)
+  {
+    if (f.id == id)
+    {
+      drawCurrentWidgetFrame(f);
+    }
+  }
+  return;
+} // end drawCurrentWidgetFrame
+
 /* These functions are responsible for drawing the current conditions and
  * associated icons on the left panel.
  */
@@ -271,24 +1078,19 @@ void powerOffDisplay()
 #ifdef POS_SUNRISE
 void drawCurrentSunrise(const om_current_t &current)
 {
-  String dataStr, unitStr;
-  int PosX = POS_SUNRISE % 2;
-  int PosY = static_cast<int>(POS_SUNRISE / 2);
-    // icons
-  display.drawInvertedBitmap(162 * PosX, 204 + (48 + 8) * PosY,
-                             wi_sunrise_48x48, 48, 48, GxEPD_BLACK);
+  const layout_rect_t &r = LAYOUT[LAYOUT_SUNRISE];
 
-  // labels
-  display.setFont(&FONT_7pt8b);
-  drawString(48 + (162 * PosX), 204 + 10 + (48 + 8) * PosY, TXT_SUNRISE, LEFT);
+  // icon and label
+  drawCurrentWidgetFrame(LAYOUT_SUNRISE);
 
   // sunrise
   display.setFont(&FONT_12pt8b);
   char timeBuffer[12] = {}; // big enough to accommodate "hh:mm:ss am"
   time_t ts = current.sunrise;
-  tm *timeInfo = localtime(&ts);
-  _strftime(timeBuffer, sizeof(timeBuffer), TIME_FORMAT, timeInfo);
-  drawString(48 + (162 * PosX), 204 + 17 / 2 + (48 + 8) * PosY + 48 / 2, timeBuffer, LEFT);
+  tm timeInfo;
+  localtime_r(&ts, &timeInfo);
+  _strftime(timeBuffer, sizeof(timeBuffer), TIME_FORMAT, &timeInfo);
+  drawString(r.x + 48, r.y + 17 / 2 + 48 / 2, timeBuffer, LEFT);
 
   return;
 }
@@ -297,133 +1099,98 @@ void drawCurrentSunrise(const om_current_t &current)
 
 // drawCurrentWind
 #ifdef POS_WIND
-void drawCurrentWind(const om_current_t &current)
+template<class Speed>
+void drawCurrentWind(const render_model_t &model, const om_current_t &current)
 {
-  String dataStr, unitStr;
-  int PosX = (POS_WIND % 2);
-  int PosY = static_cast<int>(POS_WIND / 2);
-
-  // icons
-  display.drawInvertedBitmap(162 * PosX, 204 + (48 + 8) * PosY,
-                             wi_strong_wind_48x48, 48, 48, GxEPD_BLACK);
+  char dataStr[12] = "";
+  char unitStr[24] = "";
+  const layout_rect_t &r = LAYOUT[LAYOUT_WIND];
 
-  // labels
-  display.setFont(&FONT_7pt8b);
-  drawString(48 + (162 * PosX), 204 + 10 + (48 + 8) * PosY, TXT_WIND, LEFT);
+  // icon and label
+  drawCurrentWidgetFrame(LAYOUT_WIND);
 
   // wind
   display.setFont(&FONT_12pt8b);
 #ifdef WIND_INDICATOR_ARROW
-  display.drawInvertedBitmap(48 + (162 * PosX), 204 + 24 / 2 + (48 + 8) * PosY,
-                             getWindBitmap24(current.wind_deg),
-                             24, 24, GxEPD_BLACK);
-#endif
-#ifdef UNITS_SPEED_METERSPERSECOND
-  dataStr = String(static_cast<int>(std::round(
-                   kilometersperhour_to_meterspersecond(current.wind_speed) )));
-  unitStr = String(" ") + TXT_UNITS_SPEED_METERSPERSECOND;
-#endif
-#ifdef UNITS_SPEED_FEETPERSECOND
-  dataStr = String(static_cast<int>(std::round(
-                   kilometersperhour_to_feetpersecond(current.wind_speed) )));
-  unitStr = String(" ") + TXT_UNITS_SPEED_FEETPERSECOND;
-#endif
-#ifdef UNITS_SPEED_KILOMETERSPERHOUR
-  dataStr = String(static_cast<int>(std::round(current.wind_speed)));
-  unitStr = String(" ") + TXT_UNITS_SPEED_KILOMETERSPERHOUR;
-#endif
-#ifdef UNITS_SPEED_MILESPERHOUR
-  dataStr = String(static_cast<int>(std::round(
-                   kilometersperhour_to_milesperhour(current.wind_speed) )));
-  unitStr = String(" ") + TXT_UNITS_SPEED_MILESPERHOUR;
-#endif
-#ifdef UNITS_SPEED_KNOTS
-  dataStr = String(static_cast<int>(std::round(
-                   kilometersperhour_to_knots(current.wind_speed) )));
-  unitStr = String(" ") + TXT_UNITS_SPEED_KNOTS;
-#endif
-#ifdef UNITS_SPEED_BEAUFORT
-  dataStr = String(kilometersperhour_to_beaufort(current.wind_speed));
-  unitStr = String(" ") + TXT_UNITS_SPEED_BEAUFORT;
+  display.drawInvertedBitmap(r.x + 48, r.y + 24 / 2,
+                             model.wind_icon, 24, 24, GxEPD_BLACK);
 #endif
+  appendUnits<Speed>(dataStr, sizeof(dataStr),
+                     Speed::convert(current.wind_speed));
+  appendUnitLabel<Speed>(unitStr, sizeof(unitStr));
 
 #ifdef WIND_INDICATOR_ARROW
-  drawString( (48 + 24)+ (162 * PosX), 204 + 17 / 2 + (48 + 8) * PosY + 48 / 2, dataStr, LEFT);
+  drawString(r.x + 48 + 24, r.y + 17 / 2 + 48 / 2, dataStr, LEFT);
 #else
-  drawString(48    + (162 * PosX) , 204 + 17 / 2 + (48 + 8) * PosY + 48 / 2, dataStr, LEFT);
+  drawString(r.x + 48, r.y + 17 / 2 + 48 / 2, dataStr, LEFT);
 #endif
   display.setFont(&FONT_8pt8b);
-  drawString(display.getCursorX(), 204 + 17 / 2 + (48 + 8) * PosY + 48 / 2,
+  drawString(display.getCursorX(), r.y + 17 / 2 + 48 / 2,
              unitStr, LEFT);
 
 #if defined(WIND_INDICATOR_NUMBER)
-  dataStr = String(current.wind_deg) + "\260";
+  dataStr[0] = '\0';
+  appendInt(dataStr, sizeof(dataStr), current.wind_deg);
+  appendStr(dataStr, sizeof(dataStr), "\260");
   display.setFont(&FONT_12pt8b);
-  drawString(display.getCursorX() + 6, 204 + 17 / 2 + (48 + 8) * PosY + 48 / 2,
+  drawString(display.getCursorX() + 6, r.y + 17 / 2 + 48 / 2,
              dataStr, LEFT);
 #endif
 #if defined(WIND_INDICATOR_CPN_CARDINAL)                \
  || defined(WIND_INDICATOR_CPN_INTERCARDINAL)           \
  || defined(WIND_INDICATOR_CPN_SECONDARY_INTERCARDINAL) \
  || defined(WIND_INDICATOR_CPN_TERTIARY_INTERCARDINAL)
-  dataStr = getCompassPointNotation(current.wind_deg);
   display.setFont(&FONT_12pt8b);
-  drawString(display.getCursorX() + 6, 204 + 17 / 2 + (48 + 8) * PosY + 48 / 2,
-             dataStr, LEFT);
+  drawString(display.getCursorX() + 6, r.y + 17 / 2 + 48 / 2,
+             model.wind_compass, LEFT);
 #endif
 
   return;
 }
+template void drawCurrentWind<SpeedUnits>(const render_model_t &model,
+                                          const om_current_t &current);
 #endif
 // end drawCurrentWind
 
 // drawCurrentUVI
 #ifdef POS_UVI
-void drawCurrentUVI(const om_current_t &current)
+void drawCurrentUVI(const render_model_t &model)
 {
-  String dataStr, unitStr;
-  int PosX = (POS_UVI % 2);
-  int PosY = static_cast<int>(POS_UVI / 2);
-
-  // icons
-  display.drawInvertedBitmap(162 * PosX, 204 + (48 + 8) * PosY,
-                             wi_day_sunny_48x48, 48, 48, GxEPD_BLACK);
+  char dataStr[12] = "";
+  const layout_rect_t &r = LAYOUT[LAYOUT_UVI];
 
-  // labels
-  display.setFont(&FONT_7pt8b);
-  drawString(48 + (162 * PosX), 204 + 10 + (48 + 8) * PosY, TXT_UV_INDEX, LEFT);
+  // icon and label
+  drawCurrentWidgetFrame(LAYOUT_UVI);
 
   // spacing between end of index value and start of descriptor text
   const int sp = 8;
 
   // uv index
   display.setFont(&FONT_12pt8b);
-  unsigned int uvi = static_cast<unsigned int>(
-                                std::max(std::round(current.uvi), 0.0f));
-  dataStr = String(uvi);
-  drawString(48 + (162 * PosX), 204 + 17 / 2 + (48 + 8) * PosY + 48 / 2, dataStr, LEFT);
+  appendInt(dataStr, sizeof(dataStr), model.uvi);
+  drawString(r.x + 48, r.y + 17 / 2 + 48 / 2, dataStr, LEFT);
   display.setFont(&FONT_7pt8b);
-  dataStr = String(getUVIdesc(uvi));
-  int max_w = (162 + (PosX * 162) - sp) - (display.getCursorX() + sp);
-  if (getStringWidth(dataStr) <= max_w)
+  const char *descStr = model.uvi_desc;
+  int max_w = (r.x + r.w - sp) - (display.getCursorX() + sp);
+  if (getStringWidth(descStr) <= max_w)
   { // Fits on a single line, draw along bottom
-    drawString(display.getCursorX() + sp, 204 + 17 / 2 + (48 + 8) * PosY + 48 / 2,
-               dataStr, LEFT);
+    drawString(display.getCursorX() + sp, r.y + 17 / 2 + 48 / 2,
+               descStr, LEFT);
   }
   else
   { // use smaller font
     display.setFont(&FONT_5pt8b);
-    if (getStringWidth(dataStr) <= max_w)
+    if (getStringWidth(descStr) <= max_w)
     { // Fits on a single line with smaller font, draw along bottom
       drawString(display.getCursorX() + sp,
-                 204 + 17 / 2 + (48 + 8) * PosY + 48 / 2,
-                 dataStr, LEFT);
+                 r.y + 17 / 2 + 48 / 2,
+                 descStr, LEFT);
     }
     else
     { // Does not fit on a single line, draw higher to allow room for 2nd line
       drawMultiLnString(display.getCursorX() + sp,
-                        204 + 17 / 2 + (48 + 8) * PosY + 48 / 2 - 10,
-                        dataStr, LEFT, max_w, 2, 10);
+                        r.y + 17 / 2 + 48 / 2 - 10,
+                        descStr, LEFT, max_w, 2, 10);
     }
   }
   return;
@@ -433,50 +1200,44 @@ void drawCurrentUVI(const om_current_t &current)
 
 // drawCurrentAirQuality
 #ifdef POS_AIR_QULITY
-void drawCurrentAirQuality(const om_resp_air_quality_t &air_quality)
+void drawCurrentAirQuality(const render_model_t &model,
+                           const om_resp_air_quality_t &air_quality)
 {
-  String dataStr, unitStr;
-  int PosX = (POS_AIR_QULITY % 2);
-  int PosY = static_cast<int>(POS_AIR_QULITY / 2);
+  char dataStr[12] = "";
+  const layout_rect_t &r = LAYOUT[LAYOUT_AIR_QUALITY];
 
-  // icons
-  display.drawInvertedBitmap(162 * PosX, 204 + (48 + 8) * PosY,
-                             air_filter_48x48, 48, 48, GxEPD_BLACK);
-
-  // labels
-  display.setFont(&FONT_7pt8b);
-  drawString(48 + (162 * PosX), 204 + 10 + (48 + 8) * PosY, TXT_AIR_QUALITY, LEFT);
+  // icon and label
+  drawCurrentWidgetFrame(LAYOUT_AIR_QUALITY);
 
   // spacing between end of index value and start of descriptor text
   const int sp = 8;
 
   // air quality index - Open-Meteo provides AQI directly
   display.setFont(&FONT_12pt8b);
-  int aqi = air_quality.aqi;
-  dataStr = String(aqi);
-  drawString(48 + (162 * PosX), 204 + 17 / 2 + (48 + 8) * PosY + 48 / 2, dataStr, LEFT);
+  appendInt(dataStr, sizeof(dataStr), air_quality.aqi);
+  drawString(r.x + 48, r.y + 17 / 2 + 48 / 2, dataStr, LEFT);
   display.setFont(&FONT_7pt8b);
-  dataStr = String(getAQIdesc(aqi));
-  int max_w = (162 + (PosX * 162) - sp) - (display.getCursorX() + sp);
-  if (getStringWidth(dataStr) <= max_w)
+  const char *descStr = model.aqi_desc;
+  int max_w = (r.x + r.w - sp) - (display.getCursorX() + sp);
+  if (getStringWidth(descStr) <= max_w)
   { // Fits on a single line, draw along bottom
-    drawString(display.getCursorX() + sp, 204 + 17 / 2 + (48 + 8) * PosY + 48 / 2,
-               dataStr, LEFT);
+    drawString(display.getCursorX() + sp, r.y + 17 / 2 + 48 / 2,
+               descStr, LEFT);
   }
   else
   { // use smaller font
     display.setFont(&FONT_5pt8b);
-    if (getStringWidth(dataStr) <= max_w)
+    if (getStringWidth(descStr) <= max_w)
     { // Fits on a single line with smaller font, draw along bottom
       drawString(display.getCursorX() + sp,
-                 204 + 17 / 2 + (48 + 8) * PosY + 48 / 2,
-                 dataStr, LEFT);
+                 r.y + 17 / 2 + 48 / 2,
+                 descStr, LEFT);
     }
     else
     { // Does not fit on a single line, draw higher to allow room for 2nd line
       drawMultiLnString(display.getCursorX() + sp,
-                        204 + 17 / 2 + (48 + 8) * PosY + 48 / 2 - 10,
-                        dataStr, LEFT, max_w, 2, 10);
+                        r.y + 17 / 2 + 48 / 2 - 10,
+                        descStr, LEFT, max_w, 2, 10);
     }
   }
 
@@ -487,45 +1248,30 @@ void drawCurrentAirQuality(const om_resp_air_quality_t &air_quality)
 
 // drawCurrentInTemp
 #ifdef POS_INTEMP
+template<class Temp>
 void drawCurrentInTemp(float inTemp)
 {
-  String dataStr, unitStr;
-  int PosX = (POS_INTEMP % 2);
-  int PosY = static_cast<int>(POS_INTEMP / 2);
-
-  // icons
-  display.drawInvertedBitmap(162 * PosX, 204 + (48 + 8) * PosY,
-                             house_thermometer_48x48, 48, 48, GxEPD_BLACK);
+  char dataStr[16] = "";
+  const layout_rect_t &r = LAYOUT[LAYOUT_INTEMP];
 
-  // labels
-  display.setFont(&FONT_7pt8b);
-  drawString(48 + (162 * PosX), 204 + 10 + (48 + 8) * PosY, TXT_INDOOR_TEMPERATURE, LEFT);
+  // icon and label
+  drawCurrentWidgetFrame(LAYOUT_INTEMP);
 
   // indoor temperature
   display.setFont(&FONT_12pt8b);
   if (!std::isnan(inTemp))
   {
-#ifdef UNITS_TEMP_KELVIN
-    dataStr = String(std::round(celsius_to_kelvin(inTemp) * 10) / 10.0f, 1);
-#endif
-#ifdef UNITS_TEMP_CELSIUS
-    dataStr = String(std::round(inTemp * 10) / 10.0f, 1);
-#endif
-#ifdef UNITS_TEMP_FAHRENHEIT
-    dataStr = String(static_cast<int>(
-              std::round(celsius_to_fahrenheit(inTemp))));
-#endif
+    appendUnits<Temp>(dataStr, sizeof(dataStr), Temp::convert(inTemp));
   }
   else
   {
-    dataStr = "--";
+    appendStr(dataStr, sizeof(dataStr), "--");
   }
-#if defined(UNITS_TEMP_CELSIUS) || defined(UNITS_TEMP_FAHRENHEIT)
-  dataStr += "\260";
-#endif
-  drawString(48 + (162 * PosX), 204 + 17 / 2 + (48 + 8) * PosY + 48 / 2, dataStr, LEFT);
+  appendStr(dataStr, sizeof(dataStr), Temp::symbol());
+  drawString(r.x + 48, r.y + 17 / 2 + 48 / 2, dataStr, LEFT);
   return;
 }
+template void drawCurrentInTemp<TempUnits>(float inTemp);
 #endif
 // end drawCurrentInTemp
 
@@ -533,24 +1279,19 @@ void drawCurrentInTemp(float inTemp)
 #ifdef POS_SUNSET
 void drawCurrentSunset(const om_current_t &current)
 {
-  String dataStr, unitStr;
-  int PosX = (POS_SUNSET % 2);
-  int PosY = static_cast<int>(POS_SUNSET / 2);
-  // icons
-  display.drawInvertedBitmap(162 * PosX, 204 + (48 + 8) * PosY,
-                             wi_sunset_48x48, 48, 48, GxEPD_BLACK);
+  const layout_rect_t &r = LAYOUT[LAYOUT_SUNSET];
 
-  // labels
-  display.setFont(&FONT_7pt8b);
-  drawString(48 + (162 * PosX), 204 + 10 + (48 + 8) * PosY, TXT_SUNSET, LEFT);
+  // icon and label
+  drawCurrentWidgetFrame(LAYOUT_SUNSET);
 
   // sunset
   display.setFont(&FONT_12pt8b);
   char timeBuffer[12] = {}; // big enough to accommodate "hh:mm:ss am"
   time_t ts = current.sunset;
-  tm *timeInfo = localtime(&ts);
-  _strftime(timeBuffer, sizeof(timeBuffer), TIME_FORMAT, timeInfo);
-  drawString(48 + (162 * PosX), 204 + 17 / 2 + (48 + 8) * PosY + 48 / 2, timeBuffer, LEFT);
+  tm timeInfo;
+  localtime_r(&ts, &timeInfo);
+  _strftime(timeBuffer, sizeof(timeBuffer), TIME_FORMAT, &timeInfo);
+  drawString(r.x + 48, r.y + 17 / 2 + 48 / 2, timeBuffer, LEFT);
 
   return;
 }
@@ -561,24 +1302,18 @@ void drawCurrentSunset(const om_current_t &current)
 #ifdef POS_HUMIDITY
 void drawCurrentHumidity(const om_current_t &current)
 {
-  String dataStr, unitStr;
-  int PosX = (POS_HUMIDITY % 2);
-  int PosY = static_cast<int>(POS_HUMIDITY / 2);
+  char dataStr[12] = "";
+  const layout_rect_t &r = LAYOUT[LAYOUT_HUMIDITY];
 
-  // icons
-  display.drawInvertedBitmap(162 * PosX, 204 + (48 + 8) * PosY,
-                             wi_humidity_48x48, 48, 48, GxEPD_BLACK);
-
-  // labels
-  display.setFont(&FONT_7pt8b);
-  drawString(48 + (162 * PosX), 204 + 10 + (48 + 8) * PosY, TXT_HUMIDITY, LEFT);
+  // icon and label
+  drawCurrentWidgetFrame(LAYOUT_HUMIDITY);
 
   // humidity
   display.setFont(&FONT_12pt8b);
-  dataStr = String(current.humidity);
-  drawString(48 + (162 * PosX), 204 + 17 / 2 + (48 + 8) * PosY + 48 / 2, dataStr, LEFT);
+  appendInt(dataStr, sizeof(dataStr), current.humidity);
+  drawString(r.x + 48, r.y + 17 / 2 + 48 / 2, dataStr, LEFT);
   display.setFont(&FONT_8pt8b);
-  drawString(display.getCursorX(), 204 + 17 / 2 + (48 + 8) * PosY + 48 / 2,
+  drawString(display.getCursorX(), r.y + 17 / 2 + 48 / 2,
              "%", LEFT);
   return;
 }
@@ -587,127 +1322,69 @@ void drawCurrentHumidity(const om_current_t &current)
 
 // drawCurrentPressure
 #ifdef POS_PRESSURE
+template<class Pres>
 void drawCurrentPressure(const om_current_t &current)
 {
-  String dataStr, unitStr;
-  int PosX = (POS_PRESSURE % 2);
-  int PosY = static_cast<int>(POS_PRESSURE / 2);
-  //  icons
-  display.drawInvertedBitmap(162 * PosX, 204 + (48 + 8) * PosY,
-                             wi_barometer_48x48, 48, 48, GxEPD_BLACK);
+  char dataStr[16] = "";
+  char unitStr[24] = "";
+  const layout_rect_t &r = LAYOUT[LAYOUT_PRESSURE];
 
-  //  labels
-  display.setFont(&FONT_7pt8b);
-  drawString(48 + (162 * PosX), 204 + 10 + (48 + 8) * PosY, TXT_PRESSURE, LEFT);
+  // icon and label
+  drawCurrentWidgetFrame(LAYOUT_PRESSURE);
 
   // pressure
-#ifdef UNITS_PRES_HECTOPASCALS
-  dataStr = String(current.pressure);
-  unitStr = String(" ") + TXT_UNITS_PRES_HECTOPASCALS;
-#endif
-#ifdef UNITS_PRES_PASCALS
-  dataStr = String(static_cast<int>(std::round(
-                   hectopascals_to_pascals(current.pressure) )));
-  unitStr = String(" ") + TXT_UNITS_PRES_PASCALS;
-#endif
-#ifdef UNITS_PRES_MILLIMETERSOFMERCURY
-  dataStr = String(static_cast<int>(std::round(
-                   hectopascals_to_millimetersofmercury(current.pressure) )));
-  unitStr = String(" ") + TXT_UNITS_PRES_MILLIMETERSOFMERCURY;
-#endif
-#ifdef UNITS_PRES_INCHESOFMERCURY
-  dataStr = String(std::round(1e1f *
-                   hectopascals_to_inchesofmercury(current.pressure)
-                   ) / 1e1f, 1);
-  unitStr = String(" ") + TXT_UNITS_PRES_INCHESOFMERCURY;
-#endif
-#ifdef UNITS_PRES_MILLIBARS
-  dataStr = String(static_cast<int>(std::round(
-                   hectopascals_to_millibars(current.pressure) )));
-  unitStr = String(" ") + TXT_UNITS_PRES_MILLIBARS;
-#endif
-#ifdef UNITS_PRES_ATMOSPHERES
-  dataStr = String(std::round(1e3f *
-                   hectopascals_to_atmospheres(current.pressure) )
-                   / 1e3f, 3);
-  unitStr = String(" ") + TXT_UNITS_PRES_ATMOSPHERES;
-#endif
-#ifdef UNITS_PRES_GRAMSPERSQUARECENTIMETER
-  dataStr = String(static_cast<int>(std::round(
-                   hectopascals_to_gramspersquarecentimeter(current.pressure)
-                   )));
-  unitStr = String(" ") + TXT_UNITS_PRES_GRAMSPERSQUARECENTIMETER;
-#endif
-#ifdef UNITS_PRES_POUNDSPERSQUAREINCH
-  dataStr = String(std::round(1e2f *
-                   hectopascals_to_poundspersquareinch(current.pressure)
-                   ) / 1e2f, 2);
-  unitStr = String(" ") + TXT_UNITS_PRES_POUNDSPERSQUAREINCH;
-#endif
+  appendUnits<Pres>(dataStr, sizeof(dataStr), Pres::convert(current.pressure));
+  appendUnitLabel<Pres>(unitStr, sizeof(unitStr));
   display.setFont(&FONT_12pt8b);
-  drawString(48 + (162 * PosX), 204 + 17 / 2 + (48 + 8) * PosY + 48 / 2, dataStr, LEFT);
+  drawString(r.x + 48, r.y + 17 / 2 + 48 / 2, dataStr, LEFT);
   display.setFont(&FONT_8pt8b);
-  drawString(display.getCursorX(), 204 + 17 / 2 + (48 + 8) * PosY + 48 / 2,
+  drawString(display.getCursorX(), r.y + 17 / 2 + 48 / 2,
              unitStr, LEFT);
 
   return;
 }
+template void drawCurrentPressure<PresUnits>(const om_current_t &current);
 #endif
 // end drawCurrentPressure
 
 // drawCurrentVisibility
 #ifdef POS_VISIBILITY
+template<class Dist>
 void drawCurrentVisibility(const om_current_t &current)
 {
-  String dataStr, unitStr;
-  int PosX = (POS_VISIBILITY % 2);
-  int PosY = static_cast<int>(POS_VISIBILITY / 2);
-
-  // icons
-  display.drawInvertedBitmap(162 * PosX, 204 + (48 + 8) * PosY,
-                             visibility_icon_48x48, 48, 48, GxEPD_BLACK);
+  char dataStr[16] = "";
+  char unitStr[24] = "";
+  const layout_rect_t &r = LAYOUT[LAYOUT_VISIBILITY];
 
-  // labels
-  display.setFont(&FONT_7pt8b);
-  drawString(48 + (162 * PosX), 204 + 10 + (48 + 8) * PosY, TXT_VISIBILITY, LEFT);
+  // icon and label
+  drawCurrentWidgetFrame(LAYOUT_VISIBILITY);
 
   // visibility
   display.setFont(&FONT_12pt8b);
-#ifdef UNITS_DIST_KILOMETERS
-  float vis = meters_to_kilometers(current.visibility);
-  unitStr = String(" ") + TXT_UNITS_DIST_KILOMETERS;
-#endif
-#ifdef UNITS_DIST_MILES
-  float vis = meters_to_miles(current.visibility);
-  unitStr = String(" ") + TXT_UNITS_DIST_MILES;
-#endif
+  float vis = Dist::convert(current.visibility);
+  appendUnitLabel<Dist>(unitStr, sizeof(unitStr));
+  if (vis >= Dist::cap)
+  {
+    appendStr(dataStr, sizeof(dataStr), "> ");
+  }
   // if visibility is less than 1.95, round to 1 decimal place
   // else round to int
-  if (vis < 1.95)
+  if (vis < 1.95f)
   {
-    dataStr = String(std::round(10 * vis) / 10.0, 1);
+    appendFixed(dataStr, sizeof(dataStr), roundDecimals(vis, 1), 1);
   }
   else
   {
-    dataStr = String(static_cast<int>(std::round(vis)));
-  }
-#ifdef UNITS_DIST_KILOMETERS
-  if (vis >= 10)
-  {
-#endif
-#ifdef UNITS_DIST_MILES
-  if (vis >= 6)
-  {
-#endif
-    dataStr = "> " + dataStr;
+    appendInt(dataStr, sizeof(dataStr), static_cast<int>(std::round(vis)));
   }
-  drawString(48 + (162 * PosX), 204 + 17 / 2 + (48 + 8) * PosY + 48 / 2, dataStr, LEFT);
+  drawString(r.x + 48, r.y + 17 / 2 + 48 / 2, dataStr, LEFT);
   display.setFont(&FONT_8pt8b);
-  drawString(display.getCursorX(), 204 + 17 / 2 + (48 + 8) * PosY + 48 / 2,
+  drawString(display.getCursorX(), r.y + 17 / 2 + 48 / 2,
              unitStr, LEFT);
 
   return;
 }
+template void drawCurrentVisibility<DistUnits>(const om_current_t &current);
 #endif
 // end drawCurrentVisibility
 
@@ -715,31 +1392,26 @@ void drawCurrentVisibility(const om_current_t &current)
 #ifdef POS_INHUMIDITY
 void drawCurrentInHumidity(float inHumidity)
 {
-  String dataStr, unitStr;
-  int PosX = (POS_INHUMIDITY % 2);
-  int PosY = static_cast<int>(POS_INHUMIDITY / 2);
+  char dataStr[12] = "";
+  const layout_rect_t &r = LAYOUT[LAYOUT_INHUMIDITY];
 
-  // current weather data icons
-  display.drawInvertedBitmap(162 * PosX, 204 + (48 + 8) * PosY,
-                             house_humidity_48x48, 48, 48, GxEPD_BLACK);
-
-  // current weather data labels
-  display.setFont(&FONT_7pt8b);
-  drawString(48 + (162 * PosX), 204 + 10 + (48 + 8) * PosY, TXT_INDOOR_HUMIDITY, LEFT);
+  // icon and label
+  drawCurrentWidgetFrame(LAYOUT_INHUMIDITY);
 
   // indoor humidity
   display.setFont(&FONT_12pt8b);
   if (!std::isnan(inHumidity))
   {
-    dataStr = String(static_cast<int>(std::round(inHumidity)));
+    appendInt(dataStr, sizeof(dataStr),
+              static_cast<int>(std::round(inHumidity)));
   }
   else
   {
-    dataStr = "--";
+    appendStr(dataStr, sizeof(dataStr), "--");
   }
-  drawString(48 + (162 * PosX), 204 + 17 / 2 + (48 + 8) * PosY + 48 / 2, dataStr, LEFT);
+  drawString(r.x + 48, r.y + 17 / 2 + 48 / 2, dataStr, LEFT);
   display.setFont(&FONT_8pt8b);
-  drawString(display.getCursorX(), 204 + 17 / 2 + (48 + 8) * PosY + 48 / 2,
+  drawString(display.getCursorX(), r.y + 17 / 2 + 48 / 2,
              "%", LEFT);
   return;
 }
@@ -748,162 +1420,257 @@ void drawCurrentInHumidity(float inHumidity)
 
 // drawCurrentDewpoint
 #ifdef POS_DEWPOINT
-void drawCurrentDewpoint(const om_current_t &current)
+template<class Temp>
+void drawCurrentDewpoint(const render_model_t &model)
 {
-  String dataStr, unitStr;
-  int PosX = (POS_DEWPOINT % 2);
-  int PosY = static_cast<int>(POS_DEWPOINT / 2);
-  
-  // icons
-  display.drawInvertedBitmap(162 * PosX, 204 + (48 + 8) * PosY,
-                             wi_thermometer_48x48, 48, 48, GxEPD_BLACK);
-  display.drawInvertedBitmap(162 * PosX + 48 - 24, 204 + (48 + 8) * PosY + 4,
-                             wi_raindrops_24x24, 24, 24, GxEPD_BLACK);
-  
-  // labels
-  display.setFont(&FONT_7pt8b);
-  drawString(48 + (162 * PosX), 204 + 10 + (48 + 8) * PosY, TXT_DEWPOINT, LEFT);
+  char dataStr[16] = "";
+  const layout_rect_t &r = LAYOUT[LAYOUT_DEWPOINT];
+
+  // icon and label
+  drawCurrentWidgetFrame(LAYOUT_DEWPOINT);
 
   // Dew point
   display.setFont(&FONT_12pt8b);
-  if (!std::isnan(current.dew_point))
+  if (!std::isnan(model.dew_point))
+  {
+    appendUnits<Temp>(dataStr, sizeof(dataStr),
+                      Temp::convert(model.dew_point));
+  }
+  else
+  {
+    appendStr(dataStr, sizeof(dataStr), "--");
+  }
+  appendStr(dataStr, sizeof(dataStr), Temp::symbol());
+  drawString(r.x + 48, r.y + 17 / 2 + 48 / 2, dataStr, LEFT);
+  return;
+} 
+template void drawCurrentDewpoint<TempUnits>(const render_model_t &model);
+#endif
+// end drawCurrentDewpoint
+
+//End defining functions for left panel.
+
+/* Draws the current weather icon, temperature and feels like.
+ */
+template<class Temp = TempUnits>
+static void drawCurrentHeader(const render_model_t &model,
+                              const om_current_t &current)
+{
+  char dataStr[40] = "";
+  // the temperatures are centered in the 164px to the right of the header,
+  // which overlaps the icon on narrow panels
+  const layout_rect_t &r = LAYOUT[LAYOUT_CURRENT_HEADER];
+  const int textX = r.x + r.w - 164;
+
+  // current weather icon
+  display.drawInvertedBitmap(r.x, r.y, model.current_icon, 196, 196,
+                             GxEPD_BLACK);
+
+  // current temp
+  appendInt(dataStr, sizeof(dataStr),
+            static_cast<int>(std::round(Temp::convert(current.temp))));
+  // FONT_**_temperature fonts only have the character set used for displaying
+  // temperature (0123456789.-\260)
+  display.setFont(&FONT_48pt8b_temperature);
+  drawString(textX + 164 / 2 - 20, r.y + 196 / 2 + 69 / 2, dataStr, CENTER);
+  display.setFont(&FONT_14pt8b);
+  drawString(display.getCursorX(), r.y + 196 / 2 - 69 / 2 + 20, Temp::label(),
+             LEFT);
+
+  // current feels like
+  dataStr[0] = '\0';
+  appendStr(dataStr, sizeof(dataStr), TXT_FEELS_LIKE);
+  appendStr(dataStr, sizeof(dataStr), " ");
+  appendInt(dataStr, sizeof(dataStr),
+            static_cast<int>(std::round(Temp::convert(current.feels_like))));
+  appendStr(dataStr, sizeof(dataStr), Temp::symbol());
+  display.setFont(&FONT_12pt8b);
+  drawString(textX + 164 / 2, r.y + 98 + 69 / 2 + 12 + 17, dataStr, CENTER);
+  return;
+} // end drawCurrentHeader
+
+#if WIDGET_CACHE_ACTIVE
+/* Copies the rectangle r of the captured frame into bits.
+ */
+static void copyCaptureRect(const layout_rect_t &r, uint8_t *bits)
+{
+  const int stride = DISP_WIDTH / 8;
+  for (int y = 0; y < r.h; ++y)
+  {
+    memcpy(bits + y * (r.w / 8),
+           display.capture + (r.y + y) * stride + r.x / 8, r.w / 8);
+  }
+  return;
+} // end copyCaptureRect
+#endif
+
+/* Draws a widget whose appearance only depends on the key returned by getKey.
+ *
+ * With WIDGET_CACHE the pixels the widget drew are stored in flash under its
+ * key. While the key stays the same, later frames blit the stored rectangle
+ * instead of running draw. Hits and time saved are kept per widget. The render
+ * is read and written by beginFrame() and nextFrame(), drawing it only uses the
+ * widget's slot.
+ */
+template<typename GetKey, typename Draw>
+static void drawWidget(widget_id_t id, GetKey getKey, Draw draw)
+{
+#if WIDGET_CACHE_ACTIVE
+  const unsigned long start = micros();
+  if (display.capture == nullptr || !mountFlashCache())
+  {
+    draw();
+    return;
+  }
+
+  const layout_rect_t &r = LAYOUT[WIDGET_AREAS[id]];
+  widget_slot_t &slot = widgetSlots[id];
+  widget_stats_t &stats = rtc_widget_stats[id];
+  const uint32_t key = getKey();
+  if (slot.valid && slot.key == key)
   {
-#ifdef UNITS_TEMP_KELVIN
-  dataStr = String(std::round(current.dew_point * 10) / 10.0f, 1);
-#endif
-#ifdef UNITS_TEMP_CELSIUS
-  dataStr = String(std::round((current.dew_point) * 10) / 10.0f, 1);
-#endif
-#ifdef UNITS_TEMP_FAHRENHEIT
-  dataStr = String(static_cast<int>(
-            std::round(celsius_to_fahrenheit(current.dew_point))));
-#endif
+    display.drawInvertedBitmap(r.x, r.y, slot.bits, r.w, r.h, GxEPD_BLACK);
+    const uint32_t elapsed = micros() - start;
+    ++stats.hits;
+    if (stats.draw_us > elapsed)
+    {
+      stats.saved_us += stats.draw_us - elapsed;
+    }
+    slot.result = "hit";
   }
   else
   {
-    dataStr = "--";
+    // draw the widget on white, so that pixels already black (eg. the hourly
+    // icons of the outlook graph) don't leave holes in its render, then put
+    // back what was drawn underneath
+    const int stride = DISP_WIDTH / 8;
+    uint8_t *before = slot.bits;
+    copyCaptureRect(r, before);
+    for (int y = 0; y < r.h; ++y)
+    {
+      memset(display.capture + (r.y + y) * stride + r.x / 8, 0xFF, r.w / 8);
+    }
+    draw();
+    for (int y = 0; y < r.h; ++y)
+    {
+      uint8_t *after = display.capture + (r.y + y) * stride + r.x / 8;
+      for (int b = 0; b < r.w / 8; ++b)
+      {
+        uint8_t &px = slot.bits[y * (r.w / 8) + b];
+        const uint8_t under = px;
+        px = after[b];
+        after[b] &= under;
+      }
+    }
+    stats.draw_us = micros() - start;
+    ++stats.misses;
+    slot.key = key;
+    slot.valid = true;
+    slot.dirty = true;
+    slot.result = "miss";
   }
-#if defined(UNITS_TEMP_CELSIUS) || defined(UNITS_TEMP_FAHRENHEIT)
-  dataStr += "\260";
+#else
+  draw();
 #endif
-  drawString(48 + (162 * PosX), 204 + 17 / 2 + (48 + 8) * PosY + 48 / 2, dataStr, LEFT);
   return;
-} 
-#endif
-// end drawCurrentDewpoint
-
-//End defining functions for left panel.
+} // end drawWidget
 
 /* This function is responsible for drawing the current conditions and
  * associated icons.
  */
-void drawCurrentConditions(const om_current_t &current,
-                           const om_daily_t &today,
+void drawCurrentConditions(const render_model_t &model,
+                           const om_current_t &current,
                            const om_resp_air_quality_t &air_quality,
                            float inTemp, float inHumidity)
 {
-  String dataStr, unitStr;
-  // current weather icon
-  display.drawInvertedBitmap(0, 0,
-                             getCurrentConditionsBitmap196(current, today),
-                             196, 196, GxEPD_BLACK);
-
-  // current temp
-#ifdef UNITS_TEMP_KELVIN
-  dataStr = String(static_cast<int>(std::round(celsius_to_kelvin(current.temp))));
-  unitStr = TXT_UNITS_TEMP_KELVIN;
-#endif
-#ifdef UNITS_TEMP_CELSIUS
-  dataStr = String(static_cast<int>(
-            std::round((current.temp))));
-  unitStr = TXT_UNITS_TEMP_CELSIUS;
-#endif
-#ifdef UNITS_TEMP_FAHRENHEIT
-  dataStr = String(static_cast<int>(
-            std::round(celsius_to_fahrenheit(current.temp))));
-  unitStr = TXT_UNITS_TEMP_FAHRENHEIT;
-#endif
-  // FONT_**_temperature fonts only have the character set used for displaying
-  // temperature (0123456789.-\260)
-  display.setFont(&FONT_48pt8b_temperature);
-#ifndef DISP_BW_V1
-    drawString(196 + 164 / 2 - 20, 196 / 2 + 69 / 2, dataStr, CENTER);
-#elif defined(DISP_BW_V1)
-    drawString(156 + 164 / 2 - 20, 196 / 2 + 69 / 2, dataStr, CENTER);
-#endif
-  display.setFont(&FONT_14pt8b);
-  drawString(display.getCursorX(), 196 / 2 - 69 / 2 + 20, unitStr, LEFT);
+  if (onPage(LAYOUT_CURRENT_HEADER))
+  {
+    drawWidget(WIDGET_CURRENT_HEADER,
+               [&]() { return hashCurrentHeaderState(model, current); },
+               [&]() { drawCurrentHeader(model, current); });
+  }
 
-  // current feels like
-#ifdef UNITS_TEMP_KELVIN
-  dataStr = String(TXT_FEELS_LIKE) + ' '
-            + String(static_cast<int>(std::round(celsius_to_kelvin(current.feels_like))));
-#endif
-#ifdef UNITS_TEMP_CELSIUS
-  dataStr = String(TXT_FEELS_LIKE) + ' '
-            + String(static_cast<int>(std::round(
-                     (current.feels_like))))
-            + '\260';
-#endif
-#ifdef UNITS_TEMP_FAHRENHEIT
-  dataStr = String(TXT_FEELS_LIKE) + ' '
-            + String(static_cast<int>(std::round(
-                     celsius_to_fahrenheit(current.feels_like))))
-            + '\260';
-#endif
-  display.setFont(&FONT_12pt8b);
-#ifndef DISP_BW_V1
-  drawString(196 + 164 / 2, 98 + 69 / 2 + 12 + 17, dataStr, CENTER);
-#elif defined(DISP_BW_V1)
-  drawString(156 + 164 / 2, 98 + 69 / 2 + 12 + 17, dataStr, CENTER);
-#endif
   // line dividing top and bottom display areas
   // display.drawLine(0, 196, DISP_WIDTH - 1, 196, GxEPD_BLACK);
 
-  // draw current data of the left panel
+  // draw current data of the left panel, the widgets off the page being drawn
+  // are skipped
 
     # ifdef POS_SUNRISE
-     drawCurrentSunrise(current);
+      if (onPage(LAYOUT_SUNRISE))
+      {
+        drawCurrentSunrise(current);
+      }
     # endif
 
     # ifdef POS_SUNSET
-      drawCurrentSunset(current);
+      if (onPage(LAYOUT_SUNSET))
+      {
+        drawCurrentSunset(current);
+      }
     # endif
 
     # ifdef POS_WIND
-      drawCurrentWind(current);
+      if (onPage(LAYOUT_WIND))
+      {
+        drawCurrentWind(model, current);
+      }
     # endif
 
     # ifdef POS_HUMIDITY
-      drawCurrentHumidity(current);
+      if (onPage(LAYOUT_HUMIDITY))
+      {
+        drawCurrentHumidity(current);
+      }
     # endif
 
     # ifdef POS_UVI
-      drawCurrentUVI(current);
+      if (onPage(LAYOUT_UVI))
+      {
+        drawCurrentUVI(model);
+      }
     # endif
 
     # ifdef POS_PRESSURE
-      drawCurrentPressure(current);
+      if (onPage(LAYOUT_PRESSURE))
+      {
+        drawCurrentPressure(current);
+      }
     # endif
 
     # ifdef POS_VISIBILITY
-      drawCurrentVisibility(current);
+      if (onPage(LAYOUT_VISIBILITY))
+      {
+        drawCurrentVisibility(current);
+      }
     # endif
 
     # ifdef POS_AIR_QULITY
-      drawCurrentAirQuality(air_quality);
+      if (onPage(LAYOUT_AIR_QUALITY))
+      {
+        drawCurrentAirQuality(model, air_quality);
+      }
     # endif
 
     # ifdef POS_INTEMP
-      drawCurrentInTemp(inTemp);
+      if (onPage(LAYOUT_INTEMP))
+      {
+        drawCurrentInTemp(inTemp);
+      }
     # endif
 
     # ifdef POS_INHUMIDITY
-      drawCurrentInHumidity(inHumidity);
+      if (onPage(LAYOUT_INHUMIDITY))
+      {
+        drawCurrentInHumidity(inHumidity);
+      }
     # endif
 
     # ifdef POS_DEWPOINT
-      drawCurrentDewpoint(current);
+      if (onPage(LAYOUT_DEWPOINT))
+      {
+        drawCurrentDewpoint(model);
+      }
     # endif
   
     // end drawing left panel
@@ -911,23 +1678,36 @@ void drawCurrentConditions(const om_current_t &current,
   return;
 } // end drawCurrentConditions
 
-/* This function is responsible for drawing the five day forecast.
+/* Returns the left edge of the ith day of the five day forecast.
+ */
+static int getForecastX(int i)
+{
+  return layoutForecastDay(i).x;
+} // end getForecastX
+
+/* Draws the separator between the high and low of a forecast day.
+ */
+static void drawForecastSeparator(int x)
+{
+  display.setFont(&FONT_8pt8b);
+  drawString(x + 31, 98 + 69 / 2 + 38 - 6 + 12, "|", CENTER);
+  return;
+} // end drawForecastSeparator
+
+/* Draws the five day forecast strip, starting on the day of timeInfo.
  */
-void drawForecast(const om_daily_t *daily, tm timeInfo)
+template<class Temp, class Precip>
+static void drawForecastStrip(const render_model_t &model,
+                              const om_daily_t *daily, tm timeInfo)
 {
   // 5 day, forecast
-  String hiStr, loStr;
-  String dataStr, unitStr;
   for (int i = 0; i < 5; ++i)
   {
-#ifndef DISP_BW_V1
-    int x = 398 + (i * 82);
-#elif defined(DISP_BW_V1)
-    int x = 318 + (i * 64);
-#endif
+    char hiStr[12] = "";
+    char loStr[12] = "";
+    int x = getForecastX(i);
     // icons
-    display.drawInvertedBitmap(x, 98 + 69 / 2 - 32 - 6,
-                               getDailyForecastBitmap64(daily[i]),
+    display.drawInvertedBitmap(x, 98 + 69 / 2 - 32 - 6, model.daily_icon[i],
                                64, 64, GxEPD_BLACK);
     // day of week label
     display.setFont(&FONT_11pt8b);
@@ -938,27 +1718,16 @@ void drawForecast(const om_daily_t *daily, tm timeInfo)
 
     // high | low
     display.setFont(&FONT_8pt8b);
-    drawString(x + 31, 98 + 69 / 2 + 38 - 6 + 12, "|", CENTER);
-#ifdef UNITS_TEMP_KELVIN
-    hiStr = String(static_cast<int>(std::round(celsius_to_kelvin(daily[i].temp_max))));
-    loStr = String(static_cast<int>(std::round(celsius_to_kelvin(daily[i].temp_min))));
-#endif
-#ifdef UNITS_TEMP_CELSIUS
-    hiStr = String(static_cast<int>(
-                std::round((daily[i].temp_max)))) +
-            "\260";
-    loStr = String(static_cast<int>(
-                std::round((daily[i].temp_min)))) +
-            "\260";
-#endif
-#ifdef UNITS_TEMP_FAHRENHEIT
-    hiStr = String(static_cast<int>(
-                std::round(celsius_to_fahrenheit(daily[i].temp_max)))) +
-            "\260";
-    loStr = String(static_cast<int>(
-                std::round(celsius_to_fahrenheit(daily[i].temp_min)))) +
-            "\260";
-#endif
+    if (!backgroundDrawn)
+    {
+      drawForecastSeparator(x);
+    }
+    appendInt(hiStr, sizeof(hiStr), static_cast<int>(
+              std::round(Temp::convert(daily[i].temp_max))));
+    appendInt(loStr, sizeof(loStr), static_cast<int>(
+              std::round(Temp::convert(daily[i].temp_min))));
+    appendStr(hiStr, sizeof(hiStr), Temp::symbol());
+    appendStr(loStr, sizeof(loStr), Temp::symbol());
 #ifdef TEMP_ORDER_HL
     drawString(x + 31 - 4, 98 + 69 / 2 + 38 - 6 + 12, hiStr, RIGHT);
     drawString(x + 31 + 5, 98 + 69 / 2 + 38 - 6 + 12, loStr, LEFT);
@@ -970,39 +1739,16 @@ void drawForecast(const om_daily_t *daily, tm timeInfo)
 
 // daily forecast precipitation
 #if DISPLAY_DAILY_PRECIP
-    float dailyPrecip;
-#if defined(UNITS_DAILY_PRECIP_POP)
-    dailyPrecip = daily[i].pop; // Open-Meteo uses 0-100 scale
-    dataStr = String(static_cast<int>(dailyPrecip));
-    unitStr = "%";
-#else
-    dailyPrecip = daily[i].precipitation;
-#if defined(UNITS_DAILY_PRECIP_MILLIMETERS)
-    // Round up to nearest mm
-    dailyPrecip = std::round(dailyPrecip);
-    dataStr = String(static_cast<int>(dailyPrecip));
-    unitStr = String(" ") + TXT_UNITS_PRECIP_MILLIMETERS;
-#elif defined(UNITS_DAILY_PRECIP_CENTIMETERS)
-    // Round up to nearest 0.1 cm
-    dailyPrecip = millimeters_to_centimeters(dailyPrecip);
-    dailyPrecip = std::round(dailyPrecip * 10) / 10.0f;
-    dataStr = String(dailyPrecip, 1);
-    unitStr = String(" ") + TXT_UNITS_PRECIP_CENTIMETERS;
-#elif defined(UNITS_DAILY_PRECIP_INCHES)
-    // Round up to nearest 0.1 inch
-    dailyPrecip = millimeters_to_inches(dailyPrecip);
-    dailyPrecip = std::round(dailyPrecip * 10) / 10.0f;
-    dataStr = String(dailyPrecip, 1);
-    unitStr = String(" ") + TXT_UNITS_PRECIP_INCHES;
-#endif
-#endif
+    const float dailyPrecip = roundUnits<Precip>(Precip::convert(daily[i]));
+    char precipStr[24] = "";
+    appendUnits<Precip>(precipStr, sizeof(precipStr), dailyPrecip);
+    appendUnitLabel<Precip>(precipStr, sizeof(precipStr));
 #if (DISPLAY_DAILY_PRECIP == 2) // smart
       if (dailyPrecip > 0.0f)
       {
 #endif
         display.setFont(&FONT_6pt8b);
-        drawString(x + 31, 98 + 69 / 2 + 38 - 6 + 26,
-                   dataStr + unitStr, CENTER);
+        drawString(x + 31, 98 + 69 / 2 + 38 - 6 + 26, precipStr, CENTER);
 #if (DISPLAY_DAILY_PRECIP == 2) // smart
       }
 #endif
@@ -1010,7 +1756,26 @@ void drawForecast(const om_daily_t *daily, tm timeInfo)
     }
 
     return;
-  } // end drawForecast
+  } // end drawForecastStrip
+
+/* This function is responsible for drawing the five day forecast.
+ */
+template<class Temp, class Precip>
+void drawForecast(const render_model_t &model, const om_daily_t *daily,
+                  tm timeInfo)
+{
+  drawWidget(WIDGET_FORECAST,
+             [&]() {
+               return hashForecastState<Temp, Precip>(model, daily,
+                                                      timeInfo.tm_wday);
+             },
+             [&]() {
+               drawForecastStrip<Temp, Precip>(model, daily, timeInfo);
+             });
+  return;
+} // end drawForecast
+template void drawForecast<TempUnits, DailyPrecipUnits>(
+  const render_model_t &model, const om_daily_t *daily, tm timeInfo);
 
 /* This function is responsible for drawing the city string and date
  * information in the top right corner.
@@ -1025,261 +1790,126 @@ void drawLocationDate(const String &city, const String &date)
   return;
 } // end drawLocationDate
 
-/* The % operator in C++ is not a true modulo operator but it instead a
- * remainder operator. The remainder operator and modulo operator are equivalent
- * for positive numbers, but not for negatives. The follow implementation of the
- * modulo operator works for +/-a and +b.
+/* Returns the right edge of the outlook graph, which leaves room for the
+ * precipitation axis labels.
  */
-inline int modulo(int a, int b)
+template<class Precip = HourlyPrecipUnits>
+static int getOutlookGraphRight(float precipBoundMax)
 {
-  const int result = a % b;
-  return result >= 0 ? result : result + b;
-}
+  int xPos1 = DISP_WIDTH - Precip::labelWidth(precipBoundMax);
+  if (precipBoundMax > 0)
+  { // fill need extra room for labels
+    xPos1 -= 23;
+  }
+  return xPos1;
+} // end getOutlookGraphRight
 
-/* Convert temperature in Celsius to the display y coordinate to be plotted.
+/* Draws the parts of the outlook graph that only depend on its right edge:
+ * axes, dotted gridlines and x tick marks.
  */
-int temp_to_plot_y(float celsius, int tempBoundMin, float yPxPerUnit,
-                   int yBoundMin)
+static void drawOutlookGraphFrame(int xPos1)
 {
-#ifdef UNITS_TEMP_KELVIN
-  return static_cast<int>(std::round(
-    yBoundMin - (yPxPerUnit * (celsius_to_kelvin(celsius) - tempBoundMin)) ));
-#endif
-#ifdef UNITS_TEMP_CELSIUS
-  return static_cast<int>(std::round(
-    yBoundMin - (yPxPerUnit * (celsius - tempBoundMin)) ));
-#endif
-#ifdef UNITS_TEMP_FAHRENHEIT
-  return static_cast<int>(std::round(
-    yBoundMin - (yPxPerUnit * (celsius_to_fahrenheit(celsius) - tempBoundMin)) ));
-#endif
-}
+  const int xPos0 = GRAPH_X0;
+  const int yPos0 = GRAPH_Y0;
+  const int yPos1 = GRAPH_Y1;
+  const int yMajorTicks = GRAPH_Y_MAJOR_TICKS;
 
-/* This function is responsible for drawing the outlook graph for the specified
- * number of hours(up to 48).
- */
-void drawOutlookGraph(const om_hourly_t *hourly, const om_daily_t *daily,
-                      tm timeInfo)
-{
-  const int xPos0 = 350;
-  int xPos1 = DISP_WIDTH;
-  const int yPos0 = 216;
-  const int yPos1 = DISP_HEIGHT - 46;
+  // draw x axis
+  display.drawLine(xPos0, yPos1    , xPos1, yPos1    , GxEPD_BLACK);
+  display.drawLine(xPos0, yPos1 - 1, xPos1, yPos1 - 1, GxEPD_BLACK);
 
-  // calculate y max/min and intervals
-  int yMajorTicks = 5;
-#ifdef UNITS_TEMP_KELVIN
-  float tempMin = celsius_to_kelvin(hourly[0].temp);
-#endif
-#ifdef UNITS_TEMP_CELSIUS
-  float tempMin = (hourly[0].temp);
-#endif
-#ifdef UNITS_TEMP_FAHRENHEIT
-  float tempMin = celsius_to_fahrenheit(hourly[0].temp);
-#endif
-  float tempMax = tempMin;
-#ifdef UNITS_HOURLY_PRECIP_POP
-  float precipMax = hourly[0].pop;
-#else
-  float precipMax = hourly[0].precipitation;
-#endif
-  int yTempMajorTicks = 5;
-  float newTemp = 0;
-  for (int i = 1; i < HOURLY_GRAPH_MAX; ++i)
+  // draw dotted lines
+  float yInterval = (yPos1 - yPos0) / static_cast<float>(yMajorTicks);
+  for (int i = 0; i < yMajorTicks; ++i)
   {
-#ifdef UNITS_TEMP_KELVIN
-    newTemp = celsius_to_kelvin(hourly[i].temp);
-#endif
-#ifdef UNITS_TEMP_CELSIUS
-    newTemp = (hourly[i].temp);
-#endif
-#ifdef UNITS_TEMP_FAHRENHEIT
-    newTemp = celsius_to_fahrenheit(hourly[i].temp);
-#endif
-    tempMin = std::min(tempMin, newTemp);
-    tempMax = std::max(tempMax, newTemp);
-#ifdef UNITS_HOURLY_PRECIP_POP
-    precipMax = std::max<float>(precipMax, hourly[i].pop);
-#else
-    precipMax = std::max<float>(
-                precipMax, hourly[i].precipitation);
-#endif
+    int yTick = static_cast<int>(yPos0 + (i * yInterval));
+    display.drawDottedHLine(xPos0, xPos1 + 1, yTick + (yTick % 2), 3,
+                            GxEPD_BLACK);
   }
-  int tempBoundMin = static_cast<int>(tempMin - 1)
-                      - modulo(static_cast<int>(tempMin - 1), yTempMajorTicks);
-  int tempBoundMax = static_cast<int>(tempMax + 1)
-   + (yTempMajorTicks - modulo(static_cast<int>(tempMax + 1), yTempMajorTicks));
 
-  // while we have to many major ticks then increase the step
-  while ((tempBoundMax - tempBoundMin) / yTempMajorTicks > yMajorTicks)
-  {
-    yTempMajorTicks += 5;
-    tempBoundMin = static_cast<int>(tempMin - 1)
-                      - modulo(static_cast<int>(tempMin - 1), yTempMajorTicks);
-    tempBoundMax = static_cast<int>(tempMax + 1) + (yTempMajorTicks
-                      - modulo(static_cast<int>(tempMax + 1), yTempMajorTicks));
-  }
-  // while we have not enough major ticks, add to either bound
-  while ((tempBoundMax - tempBoundMin) / yTempMajorTicks < yMajorTicks)
+  // draw x tick marks, including the last one
+  int hourInterval = ceilDiv(HOURLY_GRAPH_MAX, GRAPH_X_MAX_TICKS);
+  float xInterval = (xPos1 - xPos0 - 1) / static_cast<float>(HOURLY_GRAPH_MAX);
+  for (int i = 0; i <= HOURLY_GRAPH_MAX; i += hourInterval)
   {
-    // add to whatever bound is closer to the actual min/max
-    if (tempMin - tempBoundMin <= tempBoundMax - tempMax)
-    {
-      tempBoundMin -= yTempMajorTicks;
-    }
-    else
+    int xTick = static_cast<int>(xPos0 + (i * xInterval));
+    if (i == HOURLY_GRAPH_MAX)
     {
-      tempBoundMax += yTempMajorTicks;
+      xTick = static_cast<int>(std::round(xPos0 + (i * xInterval)));
     }
+    display.drawLine(xTick    , yPos1 + 1, xTick    , yPos1 + 4, GxEPD_BLACK);
+    display.drawLine(xTick + 1, yPos1 + 1, xTick + 1, yPos1 + 4, GxEPD_BLACK);
   }
+  return;
+} // end drawOutlookGraphFrame
 
-#ifdef UNITS_HOURLY_PRECIP_POP
-  xPos1 = DISP_WIDTH - 23;
-  float precipBoundMax;
-  if (precipMax > 0)
-  {
-    precipBoundMax = 100.0f;
-  }
-  else
-  {
-    precipBoundMax = 0.0f;
-  }
-#else
-#ifdef UNITS_HOURLY_PRECIP_MILLIMETERS
-  xPos1 = DISP_WIDTH - 24;
-  float precipBoundMax = std::ceil(precipMax); // Round up to nearest mm
-  int yPrecipMajorTickDecimals = (precipBoundMax < 10);
-#endif
-#ifdef UNITS_HOURLY_PRECIP_CENTIMETERS
-  xPos1 = DISP_WIDTH - 25;
-  precipMax = millimeters_to_centimeters(precipMax);
-  // Round up to nearest 0.1 cm
-  float precipBoundMax = std::ceil(precipMax * 10) / 10.0f;
-  int yPrecipMajorTickDecimals;
-  if (precipBoundMax < 1)
-  {
-    yPrecipMajorTickDecimals = 2;
-    if (precipBoundMax > 0)
-    {
-      xPos1 -= 6; // needs extra room
-    }
-  }
-  else if (precipBoundMax < 10)
-  {
-    yPrecipMajorTickDecimals = 1;
-  }
-  else
-  {
-    yPrecipMajorTickDecimals = 0;
-  }
-#endif
-#ifdef UNITS_HOURLY_PRECIP_INCHES
-  xPos1 = DISP_WIDTH - 25;
-  precipMax = millimeters_to_inches(precipMax);
-  // Round up to nearest 0.1 inch
-  float precipBoundMax = std::ceil(precipMax * 10) / 10.0f;
-  int yPrecipMajorTickDecimals;
-  if (precipBoundMax < 1)
-  {
-    yPrecipMajorTickDecimals = 2;
-  }
-  else if (precipBoundMax < 10)
-  {
-    yPrecipMajorTickDecimals = 1;
-  }
-  else
+/* This function is responsible for drawing the outlook graph for the specified
+ * number of hours(up to 48).
+ */
+template<class Temp, class Precip>
+void drawOutlookGraph(const render_model_t &model, const om_hourly_t *hourly,
+                      tm timeInfo)
+{
+  const int xPos0 = GRAPH_X0;
+  const int yPos0 = GRAPH_Y0;
+  const int yPos1 = GRAPH_Y1;
+  const float precipBoundMax = model.precip_bound_max;
+  const int xPos1 = getOutlookGraphRight<Precip>(precipBoundMax);
+  if (!backgroundDrawn)
   {
-    yPrecipMajorTickDecimals = 0;
-  }
-#endif
-  float yPrecipMajorTickValue = precipBoundMax / yMajorTicks;
-  float precipRoundingMultiplier = std::pow(10.f, yPrecipMajorTickDecimals);
-#endif
-
-  if (precipBoundMax > 0)
-  { // fill need extra room for labels
-    xPos1 -= 23;
+    drawOutlookGraphFrame(xPos1);
   }
 
-  // draw x axis
-  display.drawLine(xPos0, yPos1    , xPos1, yPos1    , GxEPD_BLACK);
-  display.drawLine(xPos0, yPos1 - 1, xPos1, yPos1 - 1, GxEPD_BLACK);
+  // y max/min and intervals
+  const int yMajorTicks = GRAPH_Y_MAJOR_TICKS;
+  const int tempBoundMax = model.temp_bound_max;
+  const int yTempMajorTicks = model.temp_tick;
+  const int yPrecipMajorTickDecimals = Precip::tickDecimals(precipBoundMax);
+  float yPrecipMajorTickValue = precipBoundMax / yMajorTicks;
 
   // draw y axis
   float yInterval = (yPos1 - yPos0) / static_cast<float>(yMajorTicks);
   for (int i = 0; i <= yMajorTicks; ++i)
   {
-    String dataStr;
+    char dataStr[16] = "";
     int yTick = static_cast<int>(yPos0 + (i * yInterval));
     display.setFont(&FONT_8pt8b);
     // Temperature
-    dataStr = String(tempBoundMax - (i * yTempMajorTicks));
-#if defined(UNITS_TEMP_CELSIUS) || defined(UNITS_TEMP_FAHRENHEIT)
-    dataStr += "\260";
-#endif
+    appendInt(dataStr, sizeof(dataStr), tempBoundMax - (i * yTempMajorTicks));
+    appendStr(dataStr, sizeof(dataStr), Temp::symbol());
     drawString(xPos0 - 8, yTick + 4, dataStr, RIGHT, ACCENT_COLOR);
 
     if (precipBoundMax > 0)
     { // don't labels if precip is 0
-#ifdef UNITS_HOURLY_PRECIP_POP
-      // PoP
-      dataStr = String(100 - (i * 20));
-      String precipUnit = "%";
-#else
-      // Precipitation volume
+      char precipUnit[24] = "";
       float precipTick = precipBoundMax - (i * yPrecipMajorTickValue);
-      precipTick = std::round(precipTick * precipRoundingMultiplier)
-                              / precipRoundingMultiplier;
-      dataStr = String(precipTick, yPrecipMajorTickDecimals);
-#ifdef UNITS_HOURLY_PRECIP_MILLIMETERS
-      String precipUnit = String(" ") + TXT_UNITS_PRECIP_MILLIMETERS;
-#endif
-#ifdef UNITS_HOURLY_PRECIP_CENTIMETERS
-      String precipUnit = String(" ") + TXT_UNITS_PRECIP_CENTIMETERS;
-#endif
-#ifdef UNITS_HOURLY_PRECIP_INCHES
-      String precipUnit = String(" ") + TXT_UNITS_PRECIP_INCHES;
-#endif
-#endif
+      precipTick = roundDecimals(precipTick, yPrecipMajorTickDecimals);
+      dataStr[0] = '\0';
+      appendFixed(dataStr, sizeof(dataStr), precipTick,
+                  yPrecipMajorTickDecimals);
+      appendUnitLabel<Precip>(precipUnit, sizeof(precipUnit));
 
       drawString(xPos1 + 8, yTick + 4, dataStr, LEFT);
       display.setFont(&FONT_5pt8b);
       drawString(display.getCursorX(), yTick + 4, precipUnit, LEFT);
     } // end draw labels if precip is >0
-
-    // draw dotted line
-    if (i < yMajorTicks)
-    {
-      for (int x = xPos0; x <= xPos1 + 1; x += 3)
-      {
-        display.drawPixel(x, yTick + (yTick % 2), GxEPD_BLACK);
-      }
-    }
   }
 
-  int xMaxTicks = 8;
-  int hourInterval = static_cast<int>(ceil(HOURLY_GRAPH_MAX
-                                           / static_cast<float>(xMaxTicks)));
+  const int hourInterval = model.hour_interval;
   float xInterval = (xPos1 - xPos0 - 1) / static_cast<float>(HOURLY_GRAPH_MAX);
   display.setFont(&FONT_8pt8b);
 
   // precalculate all x and y coordinates for temperature values
-  float yPxPerUnit = (yPos1 - yPos0)
-                     / static_cast<float>(tempBoundMax - tempBoundMin);
-  std::vector<int> x_t;
-  std::vector<int> y_t;
-  x_t.reserve(HOURLY_GRAPH_MAX);
-  y_t.reserve(HOURLY_GRAPH_MAX);
-    for (int i = 0; i < HOURLY_GRAPH_MAX; ++i)
+  int x_t[OM_NUM_HOURLY];
+  int y_t[OM_NUM_HOURLY];
+  for (int i = 0; i < HOURLY_GRAPH_MAX; ++i)
   {
-    y_t[i] = temp_to_plot_y(hourly[i].temp, tempBoundMin, yPxPerUnit, yPos1);
-    x_t[i] = static_cast<int>(std::round(xPos0 + (i * xInterval)
-                                          + (0.5 * xInterval) ));
+    y_t[i] = model.temp_y[i];
+    // centre of hour i, (i + 0.5) * xInterval rounded, in integers
+    x_t[i] = xPos0 + roundDiv((2 * i + 1) * (xPos1 - xPos0 - 1),
+                              2 * HOURLY_GRAPH_MAX);
   }
 
-#if DISPLAY_HOURLY_ICONS
-  int day_idx = 0;
-#endif
   display.setFont(&FONT_8pt8b);
   for (int i = 0; i < HOURLY_GRAPH_MAX; ++i)
   {
@@ -1288,22 +1918,9 @@ void drawOutlookGraph(const om_hourly_t *hourly, const om_daily_t *daily,
 
     if (i > 0)
     {
-      // temperature
-      x0_t = x_t[i - 1];
-      x1_t = x_t[i    ];
-      y0_t = y_t[i - 1];
-      y1_t = y_t[i    ];
-      // graph temperature
-      display.drawLine(x0_t    , y0_t    , x1_t    , y1_t    , ACCENT_COLOR);
-      display.drawLine(x0_t    , y0_t + 1, x1_t    , y1_t + 1, ACCENT_COLOR);
-      display.drawLine(x0_t - 1, y0_t    , x1_t - 1, y1_t    , ACCENT_COLOR);
-
       // draw hourly bitmap
 #if DISPLAY_HOURLY_ICONS
-      if (daily[day_idx].dt + 86400 <= hourly[i].dt) {
-        ++day_idx;
-      }
-      if ((i % hourInterval) == 0) // skip first and last tick
+      if (model.hourly_icon[i] != nullptr) // skip first and last tick
       {
         int y_b = INT_MAX;
         // find the highest (lowest in coordinate value) temperature point that
@@ -1329,82 +1946,146 @@ void drawOutlookGraph(const om_hourly_t *hourly, const om_daily_t *daily,
         {
           y_b = std::min(y_t[idx], y_b);
         }
-        const uint8_t *bitmap = getHourlyForecastBitmap32(hourly[i],
-                                                          daily[day_idx]);
         display.drawInvertedBitmap(xTick - 16, y_b - 32,
-                                   bitmap, 32, 32, GxEPD_BLACK);
+                                   model.hourly_icon[i], 32, 32, GxEPD_BLACK);
       }
 #endif
     }
 
-#ifdef UNITS_HOURLY_PRECIP_POP
-    float precipVal = hourly[i].pop; // Open-Meteo uses 0-100 scale
-#else
-    float precipVal = hourly[i].precipitation;
-#ifdef UNITS_HOURLY_PRECIP_CENTIMETERS
-    precipVal = millimeters_to_centimeters(precipVal);
-#endif
-#ifdef UNITS_HOURLY_PRECIP_INCHES
-    precipVal = millimeters_to_inches(precipVal);
-#endif
-#endif
-
     x0_t = static_cast<int>(std::round( xPos0 + 1 + (i * xInterval)));
     x1_t = static_cast<int>(std::round( xPos0 + 1 + ((i + 1) * xInterval) ));
-    yPxPerUnit = (yPos1 - yPos0) / precipBoundMax;
-    y0_t = static_cast<int>(std::round( yPos1 - (yPxPerUnit * (precipVal)) ));
+    y0_t = model.precip_y[i];
     y1_t = yPos1;
 
-    // graph Precipitation
-    for (int y = y1_t - 1; y > y0_t; y -= 2)
-    {
-      for (int x = x0_t + (x0_t % 2); x < x1_t; x += 2)
-      {
-        display.drawPixel(x, y, GxEPD_BLACK);
-      }
-    }
+    // graph Precipitation, hatched from the bottom row up
+    display.fillPattern(x0_t, y0_t + 1, x1_t - x0_t, y1_t - 1 - y0_t,
+                        (y1_t - 1) % 2 ? PRECIP_HATCH_ODD : PRECIP_HATCH_EVEN,
+                        GxEPD_BLACK);
 
     if ((i % hourInterval) == 0)
     {
-      // draw x tick marks
-      display.drawLine(xTick    , yPos1 + 1, xTick    , yPos1 + 4, GxEPD_BLACK);
-      display.drawLine(xTick + 1, yPos1 + 1, xTick + 1, yPos1 + 4, GxEPD_BLACK);
       // draw x axis labels
       char timeBuffer[12] = {}; // big enough to accommodate "hh:mm:ss am"
       time_t ts = hourly[i].dt;
-      tm *timeInfo = localtime(&ts);
-      _strftime(timeBuffer, sizeof(timeBuffer), HOUR_FORMAT, timeInfo);
+      tm timeInfo;
+      localtime_r(&ts, &timeInfo);
+      _strftime(timeBuffer, sizeof(timeBuffer), HOUR_FORMAT, &timeInfo);
       drawString(xTick, yPos1 + 1 + 12 + 4 + 3, timeBuffer, CENTER);
     }
 
   }
 
-  // draw the last tick mark
+  // graph temperature, one span per column
+  static int16_t tempLo[DISP_WIDTH + GRAPH_TEMP_LINE_WIDTH];
+  static int16_t tempHi[DISP_WIDTH + GRAPH_TEMP_LINE_WIDTH];
+  const uint16_t tempCols = thickPolylineSpans(x_t, y_t,
+                                               HOURLY_GRAPH_MAX,
+                                               GRAPH_TEMP_LINE_WIDTH,
+                                               tempLo, tempHi);
+  for (uint16_t i = 0; i < tempCols; ++i)
+  {
+    if (tempLo[i] <= tempHi[i])
+    {
+      display.drawFastVLine(x_t[0] - (GRAPH_TEMP_LINE_WIDTH - 1) + i,
+                            tempLo[i], tempHi[i] - tempLo[i] + 1,
+                            ACCENT_COLOR);
+    }
+  }
+
+  // label the last tick mark
   if ((HOURLY_GRAPH_MAX % hourInterval) == 0)
   {
     int xTick = static_cast<int>(
                 std::round(xPos0 + (HOURLY_GRAPH_MAX * xInterval)));
-    // draw x tick marks
-    display.drawLine(xTick    , yPos1 + 1, xTick    , yPos1 + 4, GxEPD_BLACK);
-    display.drawLine(xTick + 1, yPos1 + 1, xTick + 1, yPos1 + 4, GxEPD_BLACK);
     // draw x axis labels
     char timeBuffer[12] = {}; // big enough to accommodate "hh:mm:ss am"
     time_t ts = hourly[HOURLY_GRAPH_MAX - 1].dt + 3600;
-    tm *timeInfo = localtime(&ts);
-    _strftime(timeBuffer, sizeof(timeBuffer), HOUR_FORMAT, timeInfo);
+    tm timeInfo;
+    localtime_r(&ts, &timeInfo);
+    _strftime(timeBuffer, sizeof(timeBuffer), HOUR_FORMAT, &timeInfo);
     drawString(xTick, yPos1 + 1 + 12 + 4 + 3, timeBuffer, CENTER);
   }
 
   return;
 } // end drawOutlookGraph
+template void drawOutlookGraph<TempUnits, HourlyPrecipUnits>(
+  const render_model_t &model, const om_hourly_t *hourly, tm timeInfo);
+
+/* Draws everything in the background of the dashboard, for an outlook graph
+ * with the given right edge.
+ */
+static void drawBackgroundLayer(int graphRight)
+{
+  for (const current_widget_frame_t &f : CURRENT_WIDGET_FRAMES)
+  {
+    if (onPage(f.id))
+    {
+      drawCurrentWidgetFrame(f);
+    }
+  }
+  if (onPage(LAYOUT_FORECAST))
+  {
+    for (int i = 0; i < 5; ++i)
+    {
+      drawForecastSeparator(getForecastX(i));
+    }
+  }
+  if (onPage(LAYOUT_OUTLOOK_GRAPH))
+  {
+    drawOutlookGraphFrame(graphRight);
+  }
+  return;
+} // end drawBackgroundLayer
+
+/* Draws the parts of the dashboard that are the same on every update: the
+ * icons and labels of the current conditions, the forecast separators and the
+ * outlook graph axes, gridlines and tick marks. The other draw functions leave
+ * these out afterwards. Must be drawn first.
+ *
+ * The graph's right edge moves with the precipitation axis labels, so the
+ * background depends on the hourly forecast as well.
+ *
+ * With BACKGROUND_CACHE the background is rendered once, stored compressed in
+ * flash and copied into later frames. It is read by beginFrame() and a new one
+ * is stored by nextFrame(), drawing neither allocates nor opens files.
+ */
+void drawBackground(const render_model_t &model)
+{
+  const int graphRight = getOutlookGraphRight(model.precip_bound_max);
+#if BACKGROUND_CACHE_ACTIVE
+#if DEBUG_LEVEL >= 1
+  const unsigned long start = micros();
+#endif
+  if (display.capture != nullptr && mountFlashCache())
+  {
+    if (!loadBackground(graphRight))
+    {
+      drawBackgroundLayer(graphRight);
+      backgroundToStore = graphRight;
+    }
+#if DEBUG_LEVEL >= 1
+    else
+    {
+      Serial.printf("[debug] Background      : loaded in %ums\n",
+                    static_cast<unsigned>((micros() - start) / 1000));
+    }
+#endif
+    backgroundDrawn = true;
+    return;
+  }
+#endif
+  drawBackgroundLayer(graphRight);
+  backgroundDrawn = true;
+  return;
+} // end drawBackground
 
 /* This function is responsible for drawing the status bar along the bottom of
  * the display.
  */
 void drawStatusBar(const String &statusStr, const String &refreshTimeStr,
-                   int rssi, uint32_t batVoltage)
+                   int rssi, uint32_t batVoltage, float batDaysLeft)
 {
-  String dataStr;
+  char dataStr[48];
   uint16_t dataColor = GxEPD_BLACK;
   display.setFont(&FONT_6pt8b);
   int pos = DISP_WIDTH - 2;
@@ -1421,13 +2102,28 @@ void drawStatusBar(const String &statusStr, const String &refreshTimeStr,
     dataColor = ACCENT_COLOR;
   }
 #endif
-#if STATUS_BAR_EXTRAS_BAT_PERCENTAGE || STATUS_BAR_EXTRAS_BAT_VOLTAGE
-  dataStr = "";
+#if STATUS_BAR_EXTRAS_BAT_PERCENTAGE || STATUS_BAR_EXTRAS_BAT_VOLTAGE \
+ || STATUS_BAR_EXTRAS_BAT_DAYS_LEFT
+  dataStr[0] = '\0';
 #if STATUS_BAR_EXTRAS_BAT_PERCENTAGE
-  dataStr += String(batPercent) + "%";
+  appendInt(dataStr, sizeof(dataStr), batPercent);
+  appendStr(dataStr, sizeof(dataStr), "%");
 #endif
 #if STATUS_BAR_EXTRAS_BAT_VOLTAGE
-  dataStr += " (" + String( std::round(batVoltage / 10.f) / 100.f, 2 ) + "v)";
+  appendStr(dataStr, sizeof(dataStr), " (");
+  appendFixed(dataStr, sizeof(dataStr),
+              std::round(batVoltage / 10.f) / 100.f, 2);
+  appendStr(dataStr, sizeof(dataStr), "v)");
+#endif
+#if STATUS_BAR_EXTRAS_BAT_DAYS_LEFT
+  if (!std::isnan(batDaysLeft))
+  {
+    appendStr(dataStr, sizeof(dataStr), " (~");
+    appendInt(dataStr, sizeof(dataStr),
+              static_cast<int>(std::fmin(batDaysLeft, 999.f)));
+    appendStr(dataStr, sizeof(dataStr), TXT_UNITS_TIME_DAYS);
+    appendStr(dataStr, sizeof(dataStr), ")");
+  }
 #endif
   drawString(pos, DISP_HEIGHT - 1 - 2, dataStr, RIGHT, dataColor);
   pos -= getStringWidth(dataStr) + 1;
@@ -1441,14 +2137,16 @@ void drawStatusBar(const String &statusStr, const String &refreshTimeStr,
   // WiFi
   dataColor = rssi >= -70 ? GxEPD_BLACK : ACCENT_COLOR;
 #if STATUS_BAR_EXTRAS_WIFI_STRENGTH || STATUS_BAR_EXTRAS_WIFI_RSSI
-  dataStr = "";
+  dataStr[0] = '\0';
 #if STATUS_BAR_EXTRAS_WIFI_STRENGTH
-  dataStr += String(getWiFidesc(rssi));
+  appendStr(dataStr, sizeof(dataStr), getWiFidesc(rssi));
 #endif
 #if STATUS_BAR_EXTRAS_WIFI_RSSI
   if (rssi != 0)
   {
-    dataStr += " (" + String(rssi) + "dBm)";
+    appendStr(dataStr, sizeof(dataStr), " (");
+    appendInt(dataStr, sizeof(dataStr), rssi);
+    appendStr(dataStr, sizeof(dataStr), "dBm)");
   }
 #endif
   drawString(pos, DISP_HEIGHT - 1 - 2, dataStr, RIGHT, dataColor);
@@ -1480,6 +2178,127 @@ void drawStatusBar(const String &statusStr, const String &refreshTimeStr,
   return;
 } // end drawStatusBar
 
+/* Returns true if the display can update a window without a full refresh.
+ */
+bool hasFastPartialRefresh()
+{
+  return display.epd2.hasFastPartialUpdate;
+} // end hasFastPartialRefresh
+
+/* Starts redrawing windows of the frame on the panel, with
+ * redrawIndoorConditions() and redrawStatusBar(), ended by endWindows(). They
+ * are drawn into a captured frame. Returns false, without powering the
+ * display, if the panel has no fast partial refresh or there is no memory for
+ * the frame.
+ */
+bool beginWindows()
+{
+#if FRAME_CAPTURE_ACTIVE
+  if (!hasFastPartialRefresh())
+  {
+    return false;
+  }
+  uint8_t *frame = static_cast<uint8_t *>(
+                     malloc((DISP_WIDTH / 8) * DISP_HEIGHT));
+  if (frame == nullptr)
+  {
+    return false;
+  }
+  initDisplay(true);
+  display.capture = frame;
+  pageTop = 0;
+  pageBottom = DISP_HEIGHT;
+  return true;
+#else
+  return false;
+#endif
+} // end beginWindows
+
+/* Ends redrawing windows started by beginWindows() and powers off the display.
+ */
+void endWindows()
+{
+#if FRAME_CAPTURE_ACTIVE
+  free(display.capture);
+  display.capture = nullptr;
+#endif
+  powerOffDisplay();
+  return;
+} // end endWindows
+
+#if FRAME_CAPTURE_ACTIVE
+/* Redraws the area of id with a partial refresh of its window. The panel lost
+ * the image it shows when it was powered off, and a partial refresh only
+ * drives the pixels that differ from that image, so drawShown() first draws
+ * what the panel shows there, which is written back to the panel. Then draw()
+ * draws the window as it is to be shown.
+ */
+template<typename DrawShown, typename Draw>
+static void redrawWindow(layout_id_t id, DrawShown drawShown, Draw draw)
+{
+  const layout_rect_t &r = LAYOUT[id];
+  // windows are written in whole bytes, the pixels added are white in both
+  // images and left as they are
+  const int16_t x = r.x & ~7;
+  const int16_t w = ((r.x + r.w + 7) & ~7) - x;
+  display.fillRect(x, r.y, w, r.h, GxEPD_WHITE);
+  drawShown();
+  display.writeCaptureWindowAgain(x, r.y, w, r.h);
+  display.fillRect(x, r.y, w, r.h, GxEPD_WHITE);
+  draw();
+  display.displayCaptureWindow(nullptr, x, r.y, w, r.h);
+#if FRAME_DIFF_ACTIVE
+  // the panel no longer shows the stored frame, the next update is a full
+  // refresh
+  rtc_frame_valid = false;
+#endif
+  return;
+} // end redrawWindow
+#endif
+
+/* Redraws only the indoor temperature and humidity widgets, from the values
+ * shown to values, with partial refreshes. Must be called between
+ * beginWindows() and endWindows().
+ */
+void redrawIndoorConditions(const interim_values_t &shown,
+                            const interim_values_t &values)
+{
+#if FRAME_CAPTURE_ACTIVE
+#ifdef POS_INTEMP
+  redrawWindow(LAYOUT_INTEMP,
+               [&]() { drawCurrentInTemp(shown.in_temp); },
+               [&]() { drawCurrentInTemp(values.in_temp); });
+#endif
+#ifdef POS_INHUMIDITY
+  redrawWindow(LAYOUT_INHUMIDITY,
+               [&]() { drawCurrentInHumidity(shown.in_humidity); },
+               [&]() { drawCurrentInHumidity(values.in_humidity); });
+#endif
+#endif
+  return;
+} // end redrawIndoorConditions
+
+/* Redraws only the status bar, from the values shown to values, with a partial
+ * refresh. Must be called between beginWindows() and endWindows().
+ */
+void redrawStatusBar(const String &statusStr, int rssi,
+                     const interim_values_t &shown,
+                     const interim_values_t &values)
+{
+#if FRAME_CAPTURE_ACTIVE
+  redrawWindow(LAYOUT_STATUS_BAR,
+               [&]() {
+                 drawStatusBar(statusStr, String(shown.refresh_time), rssi,
+                               shown.bat_voltage, shown.bat_days_left);
+               },
+               [&]() {
+                 drawStatusBar(statusStr, String(values.refresh_time), rssi,
+                               values.bat_voltage, values.bat_days_left);
+               });
+#endif
+  return;
+} // end redrawStatusBar
+
 /* This function is responsible for drawing prominent error messages to the
  * screen.
  *
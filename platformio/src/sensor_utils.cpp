@@ -0,0 +1,379 @@
+/* Indoor environment sensor utilities for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <Arduino.h>
+#include <Adafruit_Sensor.h>
+#include <Wire.h>
+
+#include "config.h"
+#include "sensor_utils.h"
+
+#if defined(SENSOR_BME280)
+  #include <Adafruit_BME280.h>
+#endif
+#if defined(SENSOR_BME680)
+  #include <Adafruit_BME680.h>
+#endif
+
+// The sensor is only ever read once per wake, so the bus can run at fast-mode
+// speed to shorten the transfers.
+#define SENSOR_I2C_FREQ 400000 // 400kHz
+
+static TwoWire I2C_bme = TwoWire(0);
+
+#if defined(SENSOR_BME280)
+// The calibration coefficients are factory trimmed and never change, so they
+// are read once and kept in RTC memory. (~33 bytes)
+RTC_DATA_ATTR static bool              rtc_bme280_calib_valid = false;
+RTC_DATA_ATTR static bme280_calib_data rtc_bme280_calib;
+
+/* Adafruit_BME280 always soft resets the sensor and re-reads the calibration
+ * registers in begin(), then places it in normal (continuous) mode. This
+ * subclass reuses the cached calibration and takes a single forced-mode
+ * measurement instead.
+ */
+class BME280Forced : public Adafruit_BME280
+{
+public:
+  bool beginForced(uint8_t addr, TwoWire *theWire)
+  {
+    delete i2c_dev;
+    i2c_dev = new Adafruit_I2CDevice(addr, theWire);
+    if (!i2c_dev->begin())
+    {
+      return false;
+    }
+    _sensorID = read8(BME280_REGISTER_CHIPID);
+    if (_sensorID != 0x60)
+    {
+      return false;
+    }
+
+    if (rtc_bme280_calib_valid)
+    {
+      _bme280_calib = rtc_bme280_calib;
+    }
+    else
+    {
+      // the sensor is power cycled every wake, so there is no need for a soft
+      // reset, but the NVM must have finished copying into the image registers
+      unsigned long timeout = millis();
+      while (isReadingCalibration() && millis() - timeout < 50)
+      {
+        delay(1);
+      }
+      readCoefficients();
+      rtc_bme280_calib       = _bme280_calib;
+      rtc_bme280_calib_valid = true;
+    }
+    return true;
+  } // end beginForced
+
+  /* Triggers one forced-mode conversion. Returns immediately, the result is
+   * collected with waitForced().
+   *
+   * Oversampling follows the datasheet's "weather monitoring" recommendation
+   * (1x temperature/humidity, IIR filter off). Pressure is not displayed so it
+   * is skipped entirely, which brings a conversion down to ~6ms.
+   */
+  void startForced()
+  {
+    _humReg.osrs_h     = SAMPLING_X1;
+    _configReg.filter  = FILTER_OFF;
+    _configReg.t_sb    = STANDBY_MS_0_5;
+    _measReg.osrs_t    = SAMPLING_X1;
+    _measReg.osrs_p    = SAMPLING_NONE;
+    _measReg.mode      = MODE_FORCED;
+
+    // ctrl_hum only takes effect after a write to ctrl_meas, and writing
+    // ctrl_meas in forced mode starts the conversion.
+    write8(BME280_REGISTER_CONTROLHUMID, _humReg.get());
+    write8(BME280_REGISTER_CONFIG, _configReg.get());
+    write8(BME280_REGISTER_CONTROL, _measReg.get());
+  } // end startForced
+
+  /* Waits for the conversion started by startForced() to complete.
+   */
+  bool waitForced()
+  {
+    unsigned long timeout = millis();
+    while (read8(BME280_REGISTER_STATUS) & 0x08)
+    {
+      if (millis() - timeout > 100)
+      {
+        return false;
+      }
+      delay(1);
+    }
+    return true;
+  } // end waitForced
+};
+
+static BME280Forced bme;
+#endif
+
+#if defined(SENSOR_BME680)
+// Adafruit_BME680 keeps its calibration private, so it is re-read each wake.
+static Adafruit_BME680 bme(&I2C_bme);
+
+// Gas heater profile. The hot plate only needs to reach temperature for the
+// gas phase, which runs after the temperature/humidity conversion, so heating
+// does not bias the indoor temperature reading.
+#define BME680_HEATER_TEMP 320 // °C
+#define BME680_HEATER_TIME 150 // ms
+#endif
+
+#if INDOOR_HISTORY_SIZE > 0
+// Ring buffer of indoor readings, one per wake. (8 bytes per sample)
+RTC_DATA_ATTR static indoor_sample_t rtc_indoor_history[INDOOR_HISTORY_SIZE];
+RTC_DATA_ATTR static uint16_t        rtc_indoor_head  = 0;
+RTC_DATA_ATTR static uint16_t        rtc_indoor_count = 0;
+#endif
+
+// state of the measurement started by startIndoorSensor()
+static bool          sensorStarted  = false;
+static bool          sensorFound    = false;
+static unsigned long sensorStartMs  = 0;
+static unsigned long sensorReadyMs  = 0;
+
+/* Powers the sensor and starts a single forced-mode measurement.
+ *
+ * This returns as soon as the measurement is triggered so that the conversion
+ * (and for the BME680, the gas heater profile) runs in the background while
+ * other work is done. Collect the result with finishIndoorSensor().
+ */
+void startIndoorSensor()
+{
+  sensorStarted = true;
+  sensorFound   = false;
+  sensorStartMs = millis();
+
+  pinMode(PIN_BME_PWR, OUTPUT);
+  digitalWrite(PIN_BME_PWR, HIGH);
+#if defined(SENSOR_INIT_DELAY_MS) && SENSOR_INIT_DELAY_MS > 0
+  delay(SENSOR_INIT_DELAY_MS);
+#else
+  delay(2); // power-on start-up time
+#endif
+  I2C_bme.begin(PIN_BME_SDA, PIN_BME_SCL, SENSOR_I2C_FREQ);
+
+#if defined(SENSOR_BME280)
+  if (bme.beginForced(BME_ADDRESS, &I2C_bme))
+  {
+    bme.startForced();
+    sensorFound   = true;
+    sensorReadyMs = millis() + 6;
+  }
+#endif
+#if defined(SENSOR_BME680)
+  if (bme.begin(BME_ADDRESS, false))
+  {
+    bme.setTemperatureOversampling(BME68X_OS_2X);
+    bme.setHumidityOversampling(BME68X_OS_1X);
+    bme.setPressureOversampling(BME68X_OS_NONE);
+    bme.setIIRFilterSize(BME68X_FILTER_OFF);
+    bme.setGasHeater(BME680_HEATER_TEMP, BME680_HEATER_TIME);
+    sensorReadyMs = bme.beginReading();
+    sensorFound   = sensorReadyMs != 0;
+  }
+#endif
+  return;
+} // end startIndoorSensor
+
+/* Collects the measurement started by startIndoorSensor() and powers the
+ * sensor down. Blocks only if the conversion has not yet completed.
+ *
+ * Readings are in °C, % and Ω. On failure the values are set to NAN. Gas
+ * resistance is NAN for sensors without a gas sensor.
+ */
+sensor_status_t finishIndoorSensor(float &temp, float &humidity,
+                                   float &gasResistance)
+{
+  temp          = NAN;
+  humidity      = NAN;
+  gasResistance = NAN;
+  if (!sensorStarted)
+  {
+    startIndoorSensor();
+  }
+  sensorStarted = false;
+
+  if (!sensorFound)
+  {
+    I2C_bme.end();
+    digitalWrite(PIN_BME_PWR, LOW);
+    return SENSOR_NOT_FOUND;
+  }
+
+#if DEBUG_LEVEL >= 1
+  const unsigned long finishMs = millis();
+#endif
+#if defined(SENSOR_BME280)
+  if (bme.waitForced())
+  {
+    temp     = bme.readTemperature(); // Celsius
+    humidity = bme.readHumidity();    // %
+  }
+#endif
+#if defined(SENSOR_BME680)
+  if (bme.endReading())
+  {
+    temp     = bme.temperature; // Celsius
+    humidity = bme.humidity;    // %
+    gasResistance = bme.gas_resistance; // Ohms
+  }
+#endif
+  I2C_bme.end();
+  digitalWrite(PIN_BME_PWR, LOW);
+
+#if DEBUG_LEVEL >= 1
+  const long conversionMs = (long) (sensorReadyMs - sensorStartMs);
+  const long waitedMs = std::max(0L, (long) (sensorReadyMs - finishMs));
+  Serial.println("[debug] Sensor conversion : " + String(conversionMs)
+                 + "ms, overlapped " + String(conversionMs - waitedMs)
+                 + "ms, waited " + String(waitedMs) + "ms");
+#endif
+
+  // check if BME readings are valid
+  // note: readings are checked again before drawing to screen. If a reading
+  //       is not a number (NAN) then an error occurred, a dash '-' will be
+  //       displayed.
+  if (std::isnan(temp) || std::isnan(humidity))
+  {
+    return SENSOR_READ_FAILED;
+  }
+  return SENSOR_OK;
+} // end finishIndoorSensor
+
+/* Abandons the measurement started by startIndoorSensor(), if any, and powers
+ * the sensor down. Called before deep sleep so that an early exit (e.g. WiFi or
+ * API failure) does not leave the sensor powered and the bus up.
+ */
+void stopIndoorSensor()
+{
+  if (!sensorStarted)
+  {
+    return;
+  }
+  sensorStarted = false;
+  I2C_bme.end();
+  digitalWrite(PIN_BME_PWR, LOW);
+  return;
+} // end stopIndoorSensor
+
+/* Powers the sensor, takes a single forced-mode reading and powers it down.
+ *
+ * Readings are in °C and %. On failure the values are set to NAN.
+ */
+sensor_status_t readIndoorSensor(float &temp, float &humidity)
+{
+  float gasResistance;
+  startIndoorSensor();
+  return finishIndoorSensor(temp, humidity, gasResistance);
+} // end readIndoorSensor
+
+/* Appends a reading to the RTC history, overwriting the oldest sample once the
+ * ring is full. Invalid readings are not recorded.
+ */
+void recordIndoorSample(int64_t dt, float temp, float humidity)
+{
+#if INDOOR_HISTORY_SIZE > 0
+  if (std::isnan(temp) || std::isnan(humidity) || dt <= 0)
+  {
+    return;
+  }
+  // time went backwards, the history can no longer be trusted
+  if (rtc_indoor_count > 0)
+  {
+    uint16_t newest = (rtc_indoor_head + INDOOR_HISTORY_SIZE - 1)
+                      % INDOOR_HISTORY_SIZE;
+    if (dt < (int64_t) rtc_indoor_history[newest].dt)
+    {
+      rtc_indoor_head  = 0;
+      rtc_indoor_count = 0;
+    }
+  }
+
+  indoor_sample_t &s = rtc_indoor_history[rtc_indoor_head];
+  s.dt       = (uint32_t) dt;
+  s.temp     = (int16_t) lroundf(temp * 100.f);
+  s.humidity = (uint16_t) lroundf(humidity * 100.f);
+  rtc_indoor_head = (rtc_indoor_head + 1) % INDOOR_HISTORY_SIZE;
+  if (rtc_indoor_count < INDOOR_HISTORY_SIZE)
+  {
+    ++rtc_indoor_count;
+  }
+#endif
+  return;
+} // end recordIndoorSample
+
+/* Computes min/max and a least-squares trend over the samples recorded within
+ * window seconds of now.
+ *
+ * Returns false if no samples fall within the window.
+ */
+bool getIndoorStats(indoor_stats_t &stats, int64_t now, int64_t window)
+{
+  stats = {};
+#if INDOOR_HISTORY_SIZE > 0
+  // sums for the regression are taken relative to now (in hours) to keep
+  // float precision
+  float st = 0.f, stt = 0.f;
+  float sT = 0.f, stT = 0.f;
+  float sH = 0.f, stH = 0.f;
+  for (uint16_t i = 0; i < rtc_indoor_count; ++i)
+  {
+    const indoor_sample_t &s = rtc_indoor_history[i];
+    const int64_t age = now - (int64_t) s.dt;
+    if (age < 0 || age > window)
+    {
+      continue;
+    }
+    const float t = -age / 3600.f;
+    const float T = s.temp / 100.f;
+    const float H = s.humidity / 100.f;
+    if (stats.count == 0)
+    {
+      stats.temp_min     = stats.temp_max     = T;
+      stats.humidity_min = stats.humidity_max = H;
+    }
+    stats.temp_min     = std::min(stats.temp_min, T);
+    stats.temp_max     = std::max(stats.temp_max, T);
+    stats.humidity_min = std::min(stats.humidity_min, H);
+    stats.humidity_max = std::max(stats.humidity_max, H);
+    st  += t;
+    stt += t * t;
+    sT  += T;
+    stT += t * T;
+    sH  += H;
+    stH += t * H;
+    ++stats.count;
+  }
+
+  const float n     = (float) stats.count;
+  const float denom = n * stt - st * st;
+  if (stats.count >= 2 && denom > 1e-6f)
+  {
+    stats.temp_trend     = (n * stT - st * sT) / denom;
+    stats.humidity_trend = (n * stH - st * sH) / denom;
+  }
+#endif
+  return stats.count > 0;
+} // end getIndoorStats
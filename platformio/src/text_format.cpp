@@ -0,0 +1,140 @@
+/* Text formatting for esp32-weather-epd.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "text_format.h"
+
+#include <cmath>
+#include <cstring>
+
+/* Appends str to the string in buf, a buffer of size bytes. The result is
+ * truncated to fit and always NUL terminated. Returns its length.
+ *
+ * These functions build the strings the renderer draws in fixed size buffers
+ * on the stack, in place of String concatenation, which allocates on the heap.
+ */
+size_t appendStr(char *buf, size_t size, const char *str)
+{
+  size_t len = strnlen(buf, size - 1);
+  while (*str != '\0' && len < size - 1)
+  {
+    buf[len++] = *str++;
+  }
+  buf[len] = '\0';
+  return len;
+} // end appendStr
+
+/* Appends value in decimal to the string in buf (see appendStr()), as
+ * String(value) formats it.
+ */
+size_t appendInt(char *buf, size_t size, long value)
+{
+  char digits[21]; // "-9223372036854775808"
+  char *p = digits + sizeof(digits);
+  *--p = '\0';
+  // negated as unsigned, so that LONG_MIN works too
+  unsigned long v = value < 0 ? 0UL - static_cast<unsigned long>(value)
+                              : static_cast<unsigned long>(value);
+  do
+  {
+    *--p = '0' + v % 10;
+    v /= 10;
+  } while (v != 0);
+  if (value < 0)
+  {
+    *--p = '-';
+  }
+  return appendStr(buf, size, p);
+} // end appendInt
+
+/* Appends value with decimals (0 to 6) digits after the point to the string in
+ * buf (see appendStr()), as String(value, decimals) formats it, except that a
+ * value that rounds to zero has no sign. NaN and infinity are "nan" and "inf".
+ *
+ * The float is rounded exactly, from its mantissa and exponent in integer
+ * arithmetic, so ties go to even like printf() and no double math is needed.
+ * |value| should be below 2^31.
+ */
+size_t appendFixed(char *buf, size_t size, float value, uint8_t decimals)
+{
+  if (std::isnan(value))
+  {
+    return appendStr(buf, size, "nan");
+  }
+  if (std::isinf(value))
+  {
+    return appendStr(buf, size, value < 0 ? "-inf" : "inf");
+  }
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  // value = mantissa * 2^-shift
+  const int exponent = (bits >> 23) & 0xFF;
+  uint64_t mantissa = bits & 0x7FFFFF;
+  if (exponent != 0)
+  {
+    mantissa |= 0x800000;
+  }
+  const int shift = 150 - (exponent != 0 ? exponent : 1);
+
+  uint32_t scale = 1;
+  for (uint8_t i = 0; i < decimals; ++i)
+  {
+    scale *= 10;
+  }
+  uint64_t n = mantissa * scale;
+  if (shift <= 0)
+  {
+    n <<= -shift;
+  }
+  else if (shift < 64)
+  {
+    const uint64_t rem  = n & ((1ULL << shift) - 1);
+    const uint64_t half = 1ULL << (shift - 1);
+    n >>= shift;
+    if (rem > half || (rem == half && (n & 1)))
+    {
+      ++n;
+    }
+  }
+  else
+  {
+    n = 0;
+  }
+
+  char digits[32];
+  char *p = digits + sizeof(digits);
+  *--p = '\0';
+  const bool negative = (bits & 0x80000000) && n != 0;
+  for (uint8_t i = 0; i < decimals; ++i)
+  {
+    *--p = '0' + n % 10;
+    n /= 10;
+  }
+  if (decimals > 0)
+  {
+    *--p = '.';
+  }
+  do
+  {
+    *--p = '0' + n % 10;
+    n /= 10;
+  } while (n != 0);
+  if (negative)
+  {
+    *--p = '-';
+  }
+  return appendStr(buf, size, p);
+} // end appendFixed
@@ -0,0 +1,103 @@
+/* Text measurement for esp32-weather-epd.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "text_metrics.h"
+
+#include <algorithm>
+
+/* The glyph tables of the fonts (generated by fontconvert) already hold the
+ * advance and the bitmap box of every character, and are memory mapped on the
+ * ESP32. Text is measured straight from them, without the per character
+ * checks for wrapping, text size and the classic font of
+ * Adafruit_GFX::getTextBounds().
+ */
+
+/* Returns the bounds of len chars of text printed in font at (0, 0).
+ * Characters the font doesn't have are skipped, '\n' starts a new line.
+ */
+text_bounds_t fontTextBounds(const GFXfont *font, const char *text, size_t len)
+{
+  const GFXglyph *glyphs = font->glyph;
+  const uint16_t first = font->first;
+  const uint16_t last  = font->last;
+  int16_t x = 0, y = 0;
+  int16_t minx = INT16_MAX, miny = INT16_MAX, maxx = -1, maxy = -1;
+  for (size_t i = 0; i < len; ++i)
+  {
+    const uint8_t c = static_cast<uint8_t>(text[i]);
+    if (c == '\n')
+    {
+      x = 0;
+      y += font->yAdvance;
+      continue;
+    }
+    if (c < first || c > last)
+    {
+      continue;
+    }
+    const GFXglyph &g = glyphs[c - first];
+    const int16_t x1 = x + g.xOffset;
+    const int16_t y1 = y + g.yOffset;
+    const int16_t x2 = x1 + g.width - 1;
+    const int16_t y2 = y1 + g.height - 1;
+    minx = std::min(minx, x1);
+    miny = std::min(miny, y1);
+    maxx = std::max(maxx, x2);
+    maxy = std::max(maxy, y2);
+    x += g.xAdvance;
+  }
+
+  text_bounds_t b = {0, 0, 0, 0};
+  if (maxx >= minx)
+  {
+    b.x = minx;
+    b.w = maxx - minx + 1;
+  }
+  if (maxy >= miny)
+  {
+    b.y = miny;
+    b.h = maxy - miny + 1;
+  }
+  return b;
+} // end fontTextBounds
+
+/* Returns the width of len chars of text printed in font, the same as
+ * fontTextBounds().w for text without '\n'.
+ */
+uint16_t fontTextWidth(const GFXfont *font, const char *text, size_t len)
+{
+  const GFXglyph *glyphs = font->glyph;
+  const uint16_t first = font->first;
+  const uint16_t last  = font->last;
+  int16_t x = 0;
+  int16_t minx = INT16_MAX, maxx = -1;
+  for (size_t i = 0; i < len; ++i)
+  {
+    const uint8_t c = static_cast<uint8_t>(text[i]);
+    if (c < first || c > last)
+    {
+      continue;
+    }
+    const GFXglyph &g = glyphs[c - first];
+    const int16_t x1 = x + g.xOffset;
+    const int16_t x2 = x1 + g.width - 1;
+    minx = std::min(minx, x1);
+    maxx = std::max(maxx, x2);
+    x += g.xAdvance;
+  }
+  return maxx >= minx ? maxx - minx + 1 : 0;
+} // end fontTextWidth
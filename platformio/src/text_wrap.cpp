@@ -0,0 +1,144 @@
+/* Word wrapping for esp32-weather-epd.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "text_wrap.h"
+
+#include <algorithm>
+
+// Horizontal extent of the glyphs of a text, and the cursor after it.
+typedef struct text_extent
+{
+  int16_t x;
+  int16_t minx;
+  int16_t maxx;
+} text_extent_t;
+
+/* Extends e by character c printed in font at the cursor.
+ */
+static void extend(const GFXfont *font, text_extent_t &e, uint8_t c)
+{
+  if (c < font->first || c > font->last)
+  {
+    return;
+  }
+  const GFXglyph &g = font->glyph[c - font->first];
+  const int16_t x1 = e.x + g.xOffset;
+  e.minx = std::min(e.minx, x1);
+  e.maxx = std::max(e.maxx, static_cast<int16_t>(x1 + g.width - 1));
+  e.x += g.xAdvance;
+  return;
+} // end extend
+
+/* Returns the width of e in pixels, the same as fontTextWidth().
+ */
+static uint16_t width(const text_extent_t &e)
+{
+  return e.maxx >= e.minx ? e.maxx - e.minx + 1 : 0;
+}
+
+/* Returns the width of the text of e followed by an ellipsis.
+ */
+static uint16_t widthWithEllipsis(const GFXfont *font, text_extent_t e)
+{
+  extend(font, e, '.');
+  extend(font, e, '.');
+  extend(font, e, '.');
+  return width(e);
+}
+
+/* Breaks the first line off len chars of text, so that it is at most
+ * max_width pixels wide. Returns the number of chars the line uses up, where
+ * the next line starts.
+ *
+ * Lines break after the last dash ('-') or at the last space (' ') that leaves
+ * the line narrow enough. The space is dropped, the dash is kept. The last line
+ * (last_line) only breaks at spaces and ends with an ellipsis where it is
+ * broken, if that still fits. If no break leaves the line narrow enough, it is
+ * broken at the first space or dash, which is dropped either way. Without any,
+ * the line is all of text and may be wider than max_width.
+ *
+ * Widths only grow as a line gets longer, so once the line is too wide no later
+ * break can fit and the text is scanned only up to there (or up to the first
+ * break). Each char is measured once.
+ */
+size_t wrapLine(const GFXfont *font, const char *text, size_t len,
+                uint16_t max_width, bool last_line, text_line_t &line)
+{
+  text_extent_t e = {0, INT16_MAX, -1};
+  bool tooWide = false;
+  // last break that fits, and the first break
+  bool fits = false;
+  text_line_t fit = {};
+  size_t fitNext = 0;
+  bool broken = false;
+  text_line_t first = {};
+  size_t firstNext = 0;
+
+  for (size_t i = 0; i < len; ++i)
+  {
+    const char c = text[i];
+    const bool isBreak = c == ' ' || (c == '-' && !last_line);
+    if (isBreak && !broken)
+    {
+      broken = true;
+      first = {i, false, width(e)};
+      firstNext = i + 1;
+    }
+    if (c == ' ' && !tooWide)
+    { // break before the space
+      const uint16_t w = last_line ? widthWithEllipsis(font, e) : width(e);
+      if (w <= max_width)
+      {
+        fits = true;
+        fit = {i, last_line, w};
+        fitNext = i + 1;
+      }
+    }
+
+    extend(font, e, static_cast<uint8_t>(c));
+    tooWide = tooWide || width(e) > max_width;
+
+    if (isBreak && c == '-' && !tooWide)
+    { // break after the dash
+      fits = true;
+      fit = {i + 1, false, width(e)};
+      fitNext = i + 1;
+    }
+    if (tooWide && broken)
+    {
+      break;
+    }
+  }
+
+  if (!tooWide)
+  { // all of it fits
+    line = {len, false, width(e)};
+    return len;
+  }
+  if (fits)
+  {
+    line = fit;
+    return fitNext;
+  }
+  if (broken)
+  {
+    line = first;
+    return firstNext;
+  }
+  line = {len, false, width(e)};
+  return len;
+} // end wrapLine
@@ -0,0 +1,134 @@
+/* Wake planner for esp32-weather-epd.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "wake_planner.h"
+
+#include <cmath>
+
+// Precipitation probability (%) at which rain is considered to start.
+#define WAKE_PRECIP_POP       50.f
+// Change in temperature (°C) from the hour shown at wake that is worth a wake.
+#define WAKE_TEMP_DELTA       1.5f
+
+/* Returns true if precipitation starts between two consecutive hours.
+ */
+static bool isPrecipOnset(const om_hourly_t &prev, const om_hourly_t &cur)
+{
+  return (cur.pop >= WAKE_PRECIP_POP && prev.pop < WAKE_PRECIP_POP)
+      || (cur.precipitation > 0.f && prev.precipitation <= 0.f);
+} // end isPrecipOnset
+
+/* Returns the temperature of the hour now falls in, the one the outlook graph
+ * shows at wake.
+ */
+static float shownHourTemp(const om_hourly_t *hourly, int64_t now)
+{
+  int i = 0;
+  while (i + 1 < OM_NUM_HOURLY && hourly[i + 1].dt <= now)
+  {
+    ++i;
+  }
+  return hourly[i].temp;
+} // end shownHourTemp
+
+/* Plans the next wake from the forecast that is about to be displayed.
+ *
+ * The hourly and daily series are scanned for the first visually significant
+ * transition no sooner than minSeconds from now: precipitation onset, an icon
+ * change, sunrise or sunset, or the temperature drifting from the hour shown at
+ * wake. The current conditions are not compared against, as they usually
+ * differ from the hourly series by a steady offset. Transitions before
+ * minSeconds are skipped, they are shown by the wake anyway. If nothing changes
+ * within maxSeconds, the wake is placed on the last top of the hour in range so
+ * the outlook graph shifts with it.
+ *
+ * maxSeconds is the regular sleep interval. The top of the hour is not an event
+ * of its own: the outlook graph shifts every hour, so it would cap every sleep
+ * at an hour and override a longer interval chosen for the energy budget. When
+ * the interval is an hour or less, the only top of the hour in range is the
+ * next one, and it is already chosen unless an earlier transition comes first.
+ */
+wake_plan_t planNextWake(const om_hourly_t *hourly, const om_daily_t *daily,
+                         int64_t now, int64_t minSeconds, int64_t maxSeconds)
+{
+  const int64_t minWake = now + minSeconds;
+  const int64_t maxWake = now + maxSeconds;
+  const float shownTemp = shownHourTemp(hourly, now);
+  wake_plan_t plan = {maxWake, WAKE_EVENT_NONE};
+
+  // hourly transitions, the hours are in order so the first one found is the
+  // earliest
+  for (int i = 1; i < OM_NUM_HOURLY && hourly[i].dt <= plan.dt; ++i)
+  {
+    const om_hourly_t &prev = hourly[i - 1];
+    const om_hourly_t &cur  = hourly[i];
+    if (cur.dt < minWake)
+    {
+      continue;
+    }
+    wake_event_t event = WAKE_EVENT_NONE;
+    if (isPrecipOnset(prev, cur))
+    {
+      event = WAKE_EVENT_PRECIP;
+    }
+    else if (cur.weather_code != prev.weather_code
+          || cur.is_day != prev.is_day)
+    {
+      event = WAKE_EVENT_ICON;
+    }
+    else if (std::fabs(cur.temp - shownTemp) >= WAKE_TEMP_DELTA)
+    {
+      event = WAKE_EVENT_TEMP;
+    }
+    if (event != WAKE_EVENT_NONE)
+    {
+      plan = {cur.dt, event};
+      break;
+    }
+  }
+
+  // sunrise and sunset fall between hours
+  for (int i = 0; i < OM_NUM_DAILY; ++i)
+  {
+    const int64_t sun[2] = {daily[i].sunrise, daily[i].sunset};
+    for (int64_t t : sun)
+    {
+      if (t >= minWake && t < plan.dt)
+      {
+        plan = {t, WAKE_EVENT_SUN};
+      }
+    }
+  }
+
+  if (plan.event == WAKE_EVENT_NONE)
+  { // routine wake on the last top of the hour in range
+    for (int i = OM_NUM_HOURLY - 1; i >= 0; --i)
+    {
+      if (hourly[i].dt >= minWake && hourly[i].dt <= maxWake)
+      {
+        plan = {hourly[i].dt, WAKE_EVENT_HOUR};
+        break;
+      }
+    }
+  }
+
+  if (plan.dt < minWake)
+  {
+    plan.dt = minWake;
+  }
+  return plan;
+} // end planNextWake
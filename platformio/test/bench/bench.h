@@ -0,0 +1,76 @@
+/* Timing of the benchmarks, on the host and on the board.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __BENCH_H__
+#define __BENCH_H__
+
+#include <cstdint>
+#include <cstdio>
+#include <unity.h>
+#ifdef ARDUINO
+  #include <Arduino.h>
+#else
+  #include <chrono>
+#endif
+
+// Runs of a benchmark, the host being some 100 times faster than the board.
+#ifdef ARDUINO
+  #define BENCH_RUNS(n) (n)
+#else
+  #define BENCH_RUNS(n) (100 * (n))
+#endif
+
+// Microseconds since an arbitrary start.
+static inline uint32_t benchMicros()
+{
+#ifdef ARDUINO
+  return micros();
+#else
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+           std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+/* Returns the microseconds taken to call fn() runs times.
+ */
+template<class Fn>
+uint32_t benchTime(uint32_t runs, Fn fn)
+{
+  const uint32_t start = benchMicros();
+  for (uint32_t i = 0; i < runs; ++i)
+  {
+    fn();
+  }
+  return benchMicros() - start;
+} // end benchTime
+
+/* Prints the time per run of the code a change replaced (before) and of the
+ * code that replaced it (after), each taking the given total microseconds for
+ * runs runs.
+ */
+static inline void benchReport(const char *name, uint32_t runs,
+                               uint32_t before, uint32_t after)
+{
+  char msg[128];
+  snprintf(msg, sizeof(msg), "%s: %.2f us before, %.2f us after, %.1fx",
+           name, static_cast<double>(before) / runs,
+           static_cast<double>(after) / runs,
+           static_cast<double>(before) / (after > 0 ? after : 1));
+  TEST_MESSAGE(msg);
+} // end benchReport
+
+#endif
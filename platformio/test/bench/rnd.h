@@ -0,0 +1,46 @@
+/* Pseudo random numbers of the tests and benchmarks.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __RND_H__
+#define __RND_H__
+
+#include <cstdint>
+
+// State of rnd(), a linear congruential generator. Each test starts it from
+// the same seed in setUp(), so every run sees the same numbers.
+static uint32_t rndState = 1;
+
+// Starts the numbers of rnd() over from seed.
+static inline void rndSeed(uint32_t seed)
+{
+  rndState = seed;
+}
+
+// Returns the next number, 24 bits.
+static inline uint32_t rnd()
+{
+  rndState = rndState * 1664525u + 1013904223u;
+  return rndState >> 8;
+}
+
+// Returns a number from lo to hi, inclusive.
+static inline int16_t rndIn(int16_t lo, int16_t hi)
+{
+  return lo + rnd() % (hi - lo + 1);
+}
+
+#endif
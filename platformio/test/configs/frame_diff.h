@@ -0,0 +1,35 @@
+/* config.h with FRAME_DIFF and its caches, for the renderer tests.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __TEST_CONFIG_FRAME_DIFF_H__
+#define __TEST_CONFIG_FRAME_DIFF_H__
+
+// Force included (-include) into every file of the build, the C++ ones start
+// from config.h.
+#ifdef __cplusplus
+#include "config.h"
+
+#undef FRAME_DIFF
+#define FRAME_DIFF 1
+#undef WIDGET_CACHE
+#define WIDGET_CACHE 1
+#undef BACKGROUND_CACHE
+#define BACKGROUND_CACHE 1
+
+#endif // __cplusplus
+
+#endif
@@ -0,0 +1,299 @@
+/* Host stand-in for Adafruit_GFX, for the unit tests.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _ADAFRUIT_GFX_H
+#define _ADAFRUIT_GFX_H
+
+#include <Arduino.h>
+#include <gfxfont.h>
+#include <utility>
+
+// The parts of Adafruit_GFX the renderer uses, with the same algorithms, for
+// GFX fonts only.
+class Adafruit_GFX : public Print
+{
+public:
+  Adafruit_GFX(int16_t w, int16_t h)
+    : WIDTH(w), HEIGHT(h), _width(w), _height(h) {}
+
+  virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+
+  virtual void startWrite() {}
+  virtual void endWrite() {}
+  virtual void writePixel(int16_t x, int16_t y, uint16_t color)
+  {
+    drawPixel(x, y, color);
+  }
+  virtual void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                             uint16_t color)
+  {
+    fillRect(x, y, w, h, color);
+  }
+  virtual void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+  {
+    drawFastVLine(x, y, h, color);
+  }
+  virtual void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+  {
+    drawFastHLine(x, y, w, color);
+  }
+  virtual void writeLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                         uint16_t color)
+  {
+    const bool steep = abs(y1 - y0) > abs(x1 - x0);
+    if (steep)
+    {
+      std::swap(x0, y0);
+      std::swap(x1, y1);
+    }
+    if (x0 > x1)
+    {
+      std::swap(x0, x1);
+      std::swap(y0, y1);
+    }
+    const int16_t dx = x1 - x0;
+    const int16_t dy = abs(y1 - y0);
+    const int16_t ystep = (y0 < y1) ? 1 : -1;
+    int16_t err = dx / 2;
+    for (; x0 <= x1; ++x0)
+    {
+      if (steep)
+      {
+        writePixel(y0, x0, color);
+      }
+      else
+      {
+        writePixel(x0, y0, color);
+      }
+      err -= dy;
+      if (err < 0)
+      {
+        y0 += ystep;
+        err += dx;
+      }
+    }
+  }
+
+  virtual void setRotation(uint8_t r)
+  {
+    rotation = r & 3;
+    _width = (rotation & 1) ? HEIGHT : WIDTH;
+    _height = (rotation & 1) ? WIDTH : HEIGHT;
+  }
+  virtual void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+  {
+    startWrite();
+    writeLine(x, y, x, y + h - 1, color);
+    endWrite();
+  }
+  virtual void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+  {
+    startWrite();
+    writeLine(x, y, x + w - 1, y, color);
+    endWrite();
+  }
+  virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                        uint16_t color)
+  {
+    startWrite();
+    for (int16_t i = x; i < x + w; ++i)
+    {
+      writeFastVLine(i, y, h, color);
+    }
+    endWrite();
+  }
+  virtual void fillScreen(uint16_t color)
+  {
+    fillRect(0, 0, _width, _height, color);
+  }
+  virtual void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                        uint16_t color)
+  {
+    if (x0 == x1)
+    {
+      drawFastVLine(x0, std::min(y0, y1), abs(y1 - y0) + 1, color);
+    }
+    else if (y0 == y1)
+    {
+      drawFastHLine(std::min(x0, x1), y0, abs(x1 - x0) + 1, color);
+    }
+    else
+    {
+      startWrite();
+      writeLine(x0, y0, x1, y1, color);
+      endWrite();
+    }
+  }
+  void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+  {
+    drawFastHLine(x, y, w, color);
+    drawFastHLine(x, y + h - 1, w, color);
+    drawFastVLine(x, y, h, color);
+    drawFastVLine(x + w - 1, y, h, color);
+  }
+
+  void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color,
+                uint16_t bg, uint8_t size_x, uint8_t size_y)
+  {
+    const GFXglyph &g = gfxFont->glyph[c - gfxFont->first];
+    const uint8_t *bitmap = gfxFont->bitmap + g.bitmapOffset;
+    uint8_t bits = 0;
+    uint16_t bit = 0;
+    startWrite();
+    for (int16_t yy = 0; yy < g.height; ++yy)
+    {
+      for (int16_t xx = 0; xx < g.width; ++xx, ++bit)
+      {
+        if (!(bit & 7))
+        {
+          bits = *bitmap++;
+        }
+        if (bits & 0x80)
+        {
+          if (size_x == 1 && size_y == 1)
+          {
+            writePixel(x + g.xOffset + xx, y + g.yOffset + yy, color);
+          }
+          else
+          {
+            writeFillRect(x + (g.xOffset + xx) * size_x,
+                          y + (g.yOffset + yy) * size_y, size_x, size_y,
+                          color);
+          }
+        }
+        bits <<= 1;
+      }
+    }
+    endWrite();
+  }
+
+  using Print::write;
+  size_t write(uint8_t c) override
+  {
+    if (c == '\n')
+    {
+      cursor_x = 0;
+      cursor_y += textsize_y * gfxFont->yAdvance;
+    }
+    else if (c != '\r' && c >= gfxFont->first && c <= gfxFont->last)
+    {
+      const GFXglyph &g = gfxFont->glyph[c - gfxFont->first];
+      if (g.width > 0 && g.height > 0)
+      {
+        if (wrap && cursor_x + textsize_x * (g.xOffset + g.width) > _width)
+        {
+          cursor_x = 0;
+          cursor_y += textsize_y * gfxFont->yAdvance;
+        }
+        drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize_x,
+                 textsize_y);
+      }
+      cursor_x += g.xAdvance * textsize_x;
+    }
+    return 1;
+  }
+
+  void getTextBounds(const char *str, int16_t x, int16_t y, int16_t *x1,
+                     int16_t *y1, uint16_t *w, uint16_t *h)
+  {
+    int16_t minx = 0x7FFF, miny = 0x7FFF, maxx = -1, maxy = -1;
+    *x1 = x;
+    *y1 = y;
+    *w = *h = 0;
+    for (; *str; ++str)
+    {
+      charBounds(*str, &x, &y, &minx, &miny, &maxx, &maxy);
+    }
+    if (maxx >= minx)
+    {
+      *x1 = minx;
+      *w = maxx - minx + 1;
+    }
+    if (maxy >= miny)
+    {
+      *y1 = miny;
+      *h = maxy - miny + 1;
+    }
+  }
+  void getTextBounds(const String &str, int16_t x, int16_t y, int16_t *x1,
+                     int16_t *y1, uint16_t *w, uint16_t *h)
+  {
+    getTextBounds(str.c_str(), x, y, x1, y1, w, h);
+  }
+
+  void setTextSize(uint8_t s) { textsize_x = textsize_y = s ? s : 1; }
+  void setFont(const GFXfont *f) { gfxFont = const_cast<GFXfont *>(f); }
+  void setCursor(int16_t x, int16_t y)
+  {
+    cursor_x = x;
+    cursor_y = y;
+  }
+  void setTextColor(uint16_t c) { textcolor = textbgcolor = c; }
+  void setTextColor(uint16_t c, uint16_t bg)
+  {
+    textcolor = c;
+    textbgcolor = bg;
+  }
+  void setTextWrap(bool w) { wrap = w; }
+  int16_t width() const { return _width; }
+  int16_t height() const { return _height; }
+  uint8_t getRotation() const { return rotation; }
+  int16_t getCursorX() const { return cursor_x; }
+  int16_t getCursorY() const { return cursor_y; }
+
+protected:
+  int16_t WIDTH, HEIGHT;
+  int16_t _width, _height;
+  int16_t cursor_x = 0, cursor_y = 0;
+  uint16_t textcolor = 0xFFFF, textbgcolor = 0xFFFF;
+  uint8_t textsize_x = 1, textsize_y = 1;
+  uint8_t rotation = 0;
+  bool wrap = true;
+  GFXfont *gfxFont = nullptr;
+
+  void charBounds(unsigned char c, int16_t *x, int16_t *y, int16_t *minx,
+                  int16_t *miny, int16_t *maxx, int16_t *maxy)
+  {
+    if (c == '\n')
+    {
+      *x = 0;
+      *y += textsize_y * gfxFont->yAdvance;
+      return;
+    }
+    if (c == '\r' || c < gfxFont->first || c > gfxFont->last)
+    {
+      return;
+    }
+    const GFXglyph &g = gfxFont->glyph[c - gfxFont->first];
+    if (wrap && *x + (g.xOffset + g.width) * textsize_x > _width)
+    {
+      *x = 0;
+      *y += textsize_y * gfxFont->yAdvance;
+    }
+    const int16_t bx1 = *x + g.xOffset * textsize_x;
+    const int16_t by1 = *y + g.yOffset * textsize_y;
+    const int16_t bx2 = bx1 + g.width * textsize_x - 1;
+    const int16_t by2 = by1 + g.height * textsize_y - 1;
+    *minx = std::min(*minx, bx1);
+    *miny = std::min(*miny, by1);
+    *maxx = std::max(*maxx, bx2);
+    *maxy = std::max(*maxy, by2);
+    *x += g.xAdvance * textsize_x;
+  }
+};
+
+#endif
@@ -0,0 +1,316 @@
+/* Host stand-in for the Arduino core, for the unit tests.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <sys/time.h>
+#include <esp_attr.h>
+
+// Only what the renderer and the modules it uses need. Hardware calls do
+// nothing, the heap is the host's.
+using std::isnan;
+using std::max;
+using std::min;
+using std::round;
+
+#define PROGMEM
+#define pgm_read_byte(a)    (*(const uint8_t *)(a))
+#define pgm_read_word(a)    (*(const uint16_t *)(a))
+#define pgm_read_dword(a)   (*(const uint32_t *)(a))
+#define pgm_read_pointer(a) (*(void *const *)(a))
+
+#define LED_BUILTIN 2
+#define A2          2
+#define INPUT       0
+#define OUTPUT      1
+#define LOW         0
+#define HIGH        1
+#define DEC         10
+#define HEX         16
+
+typedef bool boolean;
+typedef uint8_t byte;
+typedef int gpio_num_t;
+
+inline void pinMode(int, int) {}
+inline void digitalWrite(int, int) {}
+inline int analogReadMilliVolts(int) { return 0; }
+inline void gpio_hold_en(gpio_num_t) {}
+inline void gpio_deep_sleep_hold_en() {}
+inline void delay(unsigned long) {}
+// defined by the test
+unsigned long millis();
+unsigned long micros();
+
+// boards have PSRAM unless a test takes it away
+inline bool psramPresent = true;
+inline bool psramFound() { return psramPresent; }
+inline void *ps_malloc(size_t size) { return malloc(size); }
+
+inline char toUpperCase(char c) { return toupper(c); }
+inline char toLowerCase(char c) { return tolower(c); }
+
+template<class T>
+T constrain(T v, T lo, T hi)
+{
+  return v < lo ? lo : (v > hi ? hi : v);
+}
+
+inline long map(long x, long inMin, long inMax, long outMin, long outMax)
+{
+  return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+// Arduino String on a std::string. Like the String of the ESP32 core it keeps
+// short strings inline and allocates longer ones.
+class String
+{
+public:
+  String() {}
+  String(const char *c) : s(c ? c : "") {}
+  String(const std::string &c) : s(c) {}
+  String(char c) : s(1, c) {}
+  String(int v, unsigned char base = 10) { format(v, base); }
+  String(unsigned int v, unsigned char base = 10) { formatU(v, base); }
+  String(long v, unsigned char base = 10) { format(v, base); }
+  String(unsigned long v, unsigned char base = 10) { formatU(v, base); }
+  String(long long v) : s(std::to_string(v)) {}
+  String(unsigned long long v) : s(std::to_string(v)) {}
+  String(float v, unsigned char decimals = 2) { formatF(v, decimals); }
+  String(double v, unsigned char decimals = 2) { formatF(v, decimals); }
+
+  const char *c_str() const { return s.c_str(); }
+  unsigned int length() const { return s.size(); }
+  bool isEmpty() const { return s.empty(); }
+  bool reserve(unsigned int n) { s.reserve(n); return true; }
+
+  String &operator+=(const String &o) { s += o.s; return *this; }
+  String &operator+=(const char *o) { s += o; return *this; }
+  String &operator+=(char o) { s += o; return *this; }
+  String &operator+=(int o) { return *this += String(o); }
+  bool concat(const String &o) { s += o.s; return true; }
+  bool concat(const char *o) { s += o; return true; }
+  bool concat(char o) { s += o; return true; }
+  friend String operator+(const String &a, const String &b)
+  {
+    return String(a.s + b.s);
+  }
+  friend String operator+(const String &a, const char *b)
+  {
+    return String(a.s + b);
+  }
+  friend String operator+(const char *a, const String &b)
+  {
+    return String(a + b.s);
+  }
+  friend String operator+(const String &a, char b) { return String(a.s + b); }
+
+  bool operator==(const String &o) const { return s == o.s; }
+  bool operator==(const char *o) const { return s == o; }
+  bool operator!=(const String &o) const { return s != o.s; }
+  bool operator!=(const char *o) const { return s != o; }
+  char operator[](unsigned int i) const { return i < s.size() ? s[i] : 0; }
+  char &operator[](unsigned int i) { return s[i]; }
+  char charAt(unsigned int i) const { return (*this)[i]; }
+  void setCharAt(unsigned int i, char c)
+  {
+    if (i < s.size())
+    {
+      s[i] = c;
+    }
+  }
+
+  String substring(unsigned int from) const
+  {
+    return from > s.size() ? String() : String(s.substr(from));
+  }
+  String substring(unsigned int from, unsigned int to) const
+  {
+    if (from > to)
+    {
+      std::swap(from, to);
+    }
+    return from > s.size() ? String() : String(s.substr(from, to - from));
+  }
+  int indexOf(char c, unsigned int from = 0) const
+  {
+    return position(s.find(c, from));
+  }
+  int indexOf(const String &str, unsigned int from = 0) const
+  {
+    return position(s.find(str.s, from));
+  }
+  int lastIndexOf(char c) const { return position(s.rfind(c)); }
+  int lastIndexOf(char c, unsigned int from) const
+  {
+    return position(s.rfind(c, from));
+  }
+  bool startsWith(const String &p) const { return s.rfind(p.s, 0) == 0; }
+  bool endsWith(const String &p) const
+  {
+    return s.size() >= p.s.size()
+        && s.compare(s.size() - p.s.size(), p.s.size(), p.s) == 0;
+  }
+
+  void toUpperCase()
+  {
+    for (char &c : s)
+    {
+      c = toupper(c);
+    }
+  }
+  void toLowerCase()
+  {
+    for (char &c : s)
+    {
+      c = tolower(c);
+    }
+  }
+  void trim()
+  {
+    const size_t first = s.find_first_not_of(" \t\r\n");
+    const size_t last = s.find_last_not_of(" \t\r\n");
+    s = (first == std::string::npos) ? "" : s.substr(first, last - first + 1);
+  }
+  void remove(unsigned int i)
+  {
+    if (i < s.size())
+    {
+      s.erase(i);
+    }
+  }
+  void remove(unsigned int i, unsigned int n)
+  {
+    if (i < s.size())
+    {
+      s.erase(i, n);
+    }
+  }
+  void replace(const String &from, const String &to)
+  {
+    if (from.s.empty())
+    {
+      return;
+    }
+    for (size_t p = s.find(from.s); p != std::string::npos;
+         p = s.find(from.s, p + to.s.size()))
+    {
+      s.replace(p, from.s.size(), to.s);
+    }
+  }
+  long toInt() const { return atol(s.c_str()); }
+  float toFloat() const { return atof(s.c_str()); }
+
+private:
+  std::string s;
+
+  static int position(size_t p)
+  {
+    return p == std::string::npos ? -1 : static_cast<int>(p);
+  }
+  void format(long v, int base)
+  {
+    char buf[24];
+    snprintf(buf, sizeof(buf), base == 16 ? "%lx" : "%ld", v);
+    s = buf;
+  }
+  void formatU(unsigned long v, int base)
+  {
+    char buf[24];
+    snprintf(buf, sizeof(buf), base == 16 ? "%lx" : "%lu", v);
+    s = buf;
+  }
+  void formatF(double v, int decimals)
+  {
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%.*f", decimals, v);
+    s = buf;
+  }
+};
+
+class Print
+{
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buf, size_t size)
+  {
+    size_t n = 0;
+    while (size--)
+    {
+      n += write(*buf++);
+    }
+    return n;
+  }
+  size_t write(const char *str)
+  {
+    return str ? write(reinterpret_cast<const uint8_t *>(str), strlen(str))
+               : 0;
+  }
+  size_t print(const char *str) { return write(str); }
+  size_t print(const String &str) { return write(str.c_str()); }
+  size_t print(char c) { return write(static_cast<uint8_t>(c)); }
+  size_t print(int v) { return print(String(v)); }
+  size_t println(const char *str = "") { return print(str) + print("\n"); }
+  size_t println(const String &str) { return print(str) + print("\n"); }
+  size_t printf(const char *, ...) { return 0; }
+};
+
+// the log goes nowhere
+class HardwareSerial : public Print
+{
+public:
+  using Print::write;
+  size_t write(uint8_t) override { return 1; }
+  void begin(unsigned long) {}
+  void flush() {}
+};
+
+class EspClass
+{
+public:
+  uint32_t getFreeHeap() { return 0; }
+  uint32_t getMinFreeHeap() { return 0; }
+  uint32_t getFreePsram() { return 0; }
+  uint32_t getHeapSize() { return 0; }
+  uint32_t getMaxAllocHeap() { return 0; }
+};
+
+class SPIClass
+{
+public:
+  void begin(int, int, int, int) {}
+  void end() {}
+};
+
+// defined by the test
+extern HardwareSerial Serial;
+extern EspClass ESP;
+extern SPIClass SPI;
+
+#endif
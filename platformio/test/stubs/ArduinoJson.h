@@ -0,0 +1,44 @@
+/* Host stand-in for ArduinoJson, for the unit tests.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ARDUINOJSON_H
+#define ARDUINOJSON_H
+
+// Only the error type of the parsers, the responses aren't parsed on the host.
+class DeserializationError
+{
+public:
+  enum Code
+  {
+    Ok,
+    EmptyInput,
+    IncompleteInput,
+    InvalidInput,
+    NoMemory,
+    TooDeep
+  };
+
+  DeserializationError(Code c = Ok) : c(c) {}
+  Code code() const { return c; }
+  explicit operator bool() const { return c != Ok; }
+  const char *c_str() const { return ""; }
+
+private:
+  Code c;
+};
+
+#endif
@@ -0,0 +1,61 @@
+/* Host stand-in for GxEPD2.h, for the unit tests.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _GxEPD2_H_
+#define _GxEPD2_H_
+
+#include <cstdint>
+
+// The colors of GxEPD2, as RGB565.
+#define GxEPD_BLACK     0x0000
+#define GxEPD_DARKGREY  0x7BEF
+#define GxEPD_LIGHTGREY 0xC618
+#define GxEPD_WHITE     0xFFFF
+#define GxEPD_RED       0xF800
+#define GxEPD_YELLOW    0xFFE0
+#define GxEPD_ORANGE    0xFC00
+#define GxEPD_GREEN     0x07E0
+#define GxEPD_BLUE      0x001F
+
+// A panel that ignores what is written to it.
+template<int16_t W, int16_t H>
+class HostPanel
+{
+public:
+  static const int16_t WIDTH = W;
+  static const int16_t WIDTH_VISIBLE = W;
+  static const int16_t HEIGHT = H;
+  static const bool hasFastPartialUpdate = true;
+
+  HostPanel(int16_t, int16_t, int16_t, int16_t) {}
+  void writeImage(const uint8_t *, int16_t, int16_t, int16_t, int16_t) {}
+  void writeImage(const uint8_t *, const uint8_t *, int16_t, int16_t, int16_t,
+                  int16_t) {}
+  void writeImageForFullRefresh(const uint8_t *, int16_t, int16_t, int16_t,
+                                int16_t) {}
+  void writeImageAgain(const uint8_t *, int16_t, int16_t, int16_t, int16_t) {}
+  void writeImagePart(const uint8_t *, int16_t, int16_t, int16_t, int16_t,
+                      int16_t, int16_t, int16_t, int16_t) {}
+  void writeImagePartAgain(const uint8_t *, int16_t, int16_t, int16_t,
+                           int16_t, int16_t, int16_t, int16_t, int16_t) {}
+  void refresh(bool) {}
+  void refresh(int16_t, int16_t, int16_t, int16_t) {}
+  void powerOff() {}
+  void hibernate() {}
+};
+
+#endif
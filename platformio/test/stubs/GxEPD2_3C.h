@@ -0,0 +1,136 @@
+/* Host stand-in for GxEPD2_3C, for the unit tests.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _GxEPD2_3C_H_
+#define _GxEPD2_3C_H_
+
+#include <Adafruit_GFX.h>
+#include <GxEPD2.h>
+
+typedef HostPanel<800, 480> GxEPD2_750c_Z08;
+
+// GxEPD2_3C drawing into the black and the color plane of its page buffer,
+// with the same pixel format and paging, the pages going to the panel.
+template<typename GxEPD2_Type, const uint16_t page_height>
+class GxEPD2_3C : public Adafruit_GFX
+{
+public:
+  GxEPD2_Type epd2;
+
+  GxEPD2_3C(GxEPD2_Type epd2_instance)
+    : Adafruit_GFX(GxEPD2_Type::WIDTH, GxEPD2_Type::HEIGHT),
+      epd2(epd2_instance) {}
+
+  void init(uint32_t, bool, uint16_t, bool) {}
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override
+  {
+    if (x < 0 || x >= width() || y < 0 || y >= height())
+    {
+      return;
+    }
+    switch (rotation)
+    {
+    case 1: std::swap(x, y); x = WIDTH - x - 1;  break;
+    case 2: x = WIDTH - x - 1; y = HEIGHT - y - 1; break;
+    case 3: std::swap(x, y); y = HEIGHT - y - 1; break;
+    default:                                     break;
+    }
+    y -= page_y;
+    if (y < 0 || y >= page_height)
+    {
+      return;
+    }
+    const size_t i = x / 8 + y * (WIDTH / 8);
+    const uint8_t mask = 0x80 >> (x & 7);
+    const bool red = (color == GxEPD_RED || color == GxEPD_YELLOW);
+    black_buffer[i] = (color != GxEPD_BLACK) ? (black_buffer[i] | mask)
+                                              : (black_buffer[i] & ~mask);
+    color_buffer[i] = !red ? (color_buffer[i] | mask)
+                           : (color_buffer[i] & ~mask);
+  }
+
+  void fillScreen(uint16_t color) override
+  {
+    const bool red = (color == GxEPD_RED || color == GxEPD_YELLOW);
+    memset(black_buffer, color != GxEPD_BLACK ? 0xFF : 0x00,
+           sizeof(black_buffer));
+    memset(color_buffer, !red ? 0xFF : 0x00, sizeof(color_buffer));
+  }
+
+  void drawInvertedBitmap(int16_t x, int16_t y, const uint8_t bitmap[],
+                          int16_t w, int16_t h, uint16_t color)
+  {
+    const int16_t stride = (w + 7) / 8;
+    for (int16_t j = 0; j < h; ++j)
+    {
+      for (int16_t i = 0; i < w; ++i)
+      {
+        if (!(bitmap[j * stride + i / 8] & (0x80 >> (i & 7))))
+        {
+          drawPixel(x + i, y + j, color);
+        }
+      }
+    }
+  }
+
+  void writeImage(const uint8_t *black, const uint8_t *color, int16_t x,
+                  int16_t y, int16_t w, int16_t h)
+  {
+    epd2.writeImage(black, color, x, y, w, h);
+  }
+
+  void refresh(bool partial_update_mode = false)
+  {
+    epd2.refresh(partial_update_mode);
+  }
+
+  void setFullWindow() {}
+
+  void setPartialWindow(int16_t, int16_t, int16_t, int16_t) {}
+
+  void firstPage()
+  {
+    page_y = 0;
+    fillScreen(GxEPD_WHITE);
+  }
+
+  bool nextPage()
+  {
+    epd2.writeImage(black_buffer, color_buffer, 0, page_y, WIDTH,
+                    page_height);
+    page_y += page_height;
+    if (page_y >= HEIGHT)
+    {
+      epd2.refresh(false);
+      return false;
+    }
+    fillScreen(GxEPD_WHITE);
+    return true;
+  }
+
+  uint16_t pageHeight() const { return page_height; }
+  void hibernate() {}
+  void powerOff() {}
+
+protected:
+  uint8_t black_buffer[(GxEPD2_Type::WIDTH / 8) * page_height];
+  uint8_t color_buffer[(GxEPD2_Type::WIDTH / 8) * page_height];
+  int16_t page_y = 0;
+};
+
+#endif
@@ -0,0 +1,135 @@
+/* Host stand-in for GxEPD2_BW, for the unit tests.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _GxEPD2_BW_H_
+#define _GxEPD2_BW_H_
+
+#include <Adafruit_GFX.h>
+#include <GxEPD2.h>
+
+typedef HostPanel<800, 480> GxEPD2_750_T7;
+typedef HostPanel<640, 384> GxEPD2_750;
+
+// GxEPD2_BW drawing into its page buffer, with the same pixel format and
+// paging, the pages going to the panel.
+template<typename GxEPD2_Type, const uint16_t page_height>
+class GxEPD2_BW : public Adafruit_GFX
+{
+public:
+  GxEPD2_Type epd2;
+
+  GxEPD2_BW(GxEPD2_Type epd2_instance)
+    : Adafruit_GFX(GxEPD2_Type::WIDTH, GxEPD2_Type::HEIGHT),
+      epd2(epd2_instance) {}
+
+  void init(uint32_t, bool, uint16_t, bool) {}
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override
+  {
+    if (x < 0 || x >= width() || y < 0 || y >= height())
+    {
+      return;
+    }
+    switch (rotation)
+    {
+    case 1: std::swap(x, y); x = WIDTH - x - 1;  break;
+    case 2: x = WIDTH - x - 1; y = HEIGHT - y - 1; break;
+    case 3: std::swap(x, y); y = HEIGHT - y - 1; break;
+    default:                                     break;
+    }
+    x -= pw_x;
+    y -= pw_y + page_y;
+    if (x < 0 || x >= pw_w || y < 0 || y >= page_height || y >= pw_h)
+    {
+      return;
+    }
+    uint8_t &b = buffer[x / 8 + y * (pw_w / 8)];
+    const uint8_t mask = 0x80 >> (x & 7);
+    b = (color == GxEPD_WHITE) ? (b | mask) : (b & ~mask);
+  }
+
+  void fillScreen(uint16_t color) override
+  {
+    memset(buffer, color == GxEPD_WHITE ? 0xFF : 0x00, sizeof(buffer));
+  }
+
+  void drawInvertedBitmap(int16_t x, int16_t y, const uint8_t bitmap[],
+                          int16_t w, int16_t h, uint16_t color)
+  {
+    const int16_t stride = (w + 7) / 8;
+    for (int16_t j = 0; j < h; ++j)
+    {
+      for (int16_t i = 0; i < w; ++i)
+      {
+        if (!(bitmap[j * stride + i / 8] & (0x80 >> (i & 7))))
+        {
+          drawPixel(x + i, y + j, color);
+        }
+      }
+    }
+  }
+
+  void setFullWindow()
+  {
+    setPartialWindow(0, 0, WIDTH, HEIGHT);
+  }
+
+  void setPartialWindow(int16_t x, int16_t y, int16_t w, int16_t h)
+  {
+    pw_x = x & ~7;
+    pw_y = y;
+    pw_w = ((x + w + 7) & ~7) - pw_x;
+    pw_h = h;
+  }
+
+  void firstPage()
+  {
+    page_y = 0;
+    fillScreen(GxEPD_WHITE);
+  }
+
+  bool nextPage()
+  {
+    epd2.writeImage(buffer, pw_x, pw_y + page_y, pw_w, page_height);
+    page_y += page_height;
+    if (page_y >= pw_h)
+    {
+      epd2.refresh(false);
+      return false;
+    }
+    fillScreen(GxEPD_WHITE);
+    return true;
+  }
+
+  void display(bool = false)
+  {
+    epd2.writeImage(buffer, 0, 0, WIDTH, HEIGHT);
+    epd2.refresh(false);
+  }
+
+  uint16_t pageHeight() const { return page_height; }
+  void hibernate() {}
+  void powerOff() {}
+
+protected:
+  uint8_t buffer[(GxEPD2_Type::WIDTH / 8) * page_height];
+  int16_t pw_x = 0, pw_y = 0;
+  int16_t pw_w = GxEPD2_Type::WIDTH, pw_h = GxEPD2_Type::HEIGHT;
+  int16_t page_y = 0;
+};
+
+#endif
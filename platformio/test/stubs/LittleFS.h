@@ -0,0 +1,93 @@
+/* Host stand-in for LittleFS, for the unit tests.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _LITTLEFS_H_
+#define _LITTLEFS_H_
+
+#include <Arduino.h>
+#include <map>
+#include <string>
+#include <vector>
+
+// Files kept in memory for as long as the test runs.
+class File
+{
+public:
+  File(std::vector<uint8_t> *data = nullptr) : data(data) {}
+
+  operator bool() const { return data != nullptr; }
+
+  size_t read(uint8_t *buf, size_t size)
+  {
+    if (data == nullptr)
+    {
+      return 0;
+    }
+    size = std::min(size, data->size() - pos);
+    memcpy(buf, data->data() + pos, size);
+    pos += size;
+    return size;
+  }
+
+  size_t write(const uint8_t *buf, size_t size)
+  {
+    if (data == nullptr)
+    {
+      return 0;
+    }
+    data->insert(data->end(), buf, buf + size);
+    return size;
+  }
+
+  size_t size() const { return data != nullptr ? data->size() : 0; }
+  void close() { data = nullptr; }
+
+private:
+  std::vector<uint8_t> *data;
+  size_t pos = 0;
+};
+
+class LittleFSFS
+{
+public:
+  bool begin(bool) { return true; }
+
+  bool exists(const char *path) const { return files.count(path) > 0; }
+
+  File open(const char *path, const char *mode)
+  {
+    if (mode[0] == 'w')
+    {
+      files[path].clear();
+    }
+    else if (!exists(path))
+    {
+      return File();
+    }
+    return File(&files[path]);
+  }
+
+  bool remove(const char *path) { return files.erase(path) > 0; }
+
+private:
+  std::map<std::string, std::vector<uint8_t>> files;
+};
+
+// defined by the test
+extern LittleFSFS LittleFS;
+
+#endif
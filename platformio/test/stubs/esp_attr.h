@@ -0,0 +1,25 @@
+/* Host stand-in for the ESP-IDF esp_attr.h, for the unit tests.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __ESP_ATTR_H__
+#define __ESP_ATTR_H__
+
+// RTC memory is ordinary memory on the host
+#define RTC_DATA_ATTR
+#define RTC_NOINIT_ATTR
+
+#endif
@@ -0,0 +1,36 @@
+/* Host stand-in for the ESP-IDF esp_ota_ops.h, for the unit tests.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _OTA_OPS_H
+#define _OTA_OPS_H
+
+#include <cstdint>
+
+typedef struct
+{
+  uint32_t magic_word;
+  uint8_t  app_elf_sha256[32];
+} esp_app_desc_t;
+
+// the same firmware for as long as the test runs
+inline const esp_app_desc_t *esp_ota_get_app_description()
+{
+  static const esp_app_desc_t desc = {};
+  return &desc;
+}
+
+#endif
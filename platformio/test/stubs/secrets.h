@@ -0,0 +1,32 @@
+/* Host stand-in for secrets.h, for the unit tests.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __SECRETS_H__
+#define __SECRETS_H__
+
+#include <Arduino.h>
+
+// The values of secrets.h.template. A secrets.h in src/ is found first.
+const char *WIFI_SSID     = "your_wifi_ssid";
+const char *WIFI_PASSWORD = "your_wifi_password";
+const String LAT = "000.0000";
+const String LON = "000.0000";
+const String CITY_STRING = "Your City";
+const char *TIMEZONE = "EST5EDT,M3.2.0,M11.1.0";
+const char *API_TIMEZONE = "auto";
+
+#endif
@@ -0,0 +1,305 @@
+/* Unit tests for the battery discharge model.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include <unity.h>
+#include "battery_model.h"
+
+// LOW, VERY_LOW and CRIT_LOW, as in config.cpp
+static const uint32_t THRESHOLDS[] = {0, 3462, 3442, 3404};
+#define HYSTERESIS 15
+
+#define T0   1700000000u
+#define HOUR 3600u
+#define DAY  86400u
+
+static bat_history_t h;
+
+void setUp()
+{
+  h = {};
+}
+
+void tearDown()
+{
+}
+
+static void test_filter_constant()
+{
+  uint16_t s[32];
+  for (uint16_t &v : s)
+  {
+    v = 1850;
+  }
+  TEST_ASSERT_EQUAL_UINT32(1850, filterAdcSamples(s, 32));
+}
+
+static void test_filter_rejects_spikes()
+{
+  // a trace with RF spikes, the interquartile mean ignores 8 at each end
+  uint16_t s[32] = {
+    1849, 1852, 4095, 1850, 1851, 1848, 1850,    0, 1853, 1849,
+    1851, 1850, 3900, 1847, 1852, 1850, 1849,  120, 1851, 1850,
+    1848, 1852, 1850, 4095, 1849, 1851, 1850, 1850,    7, 1852,
+    1849, 1851
+  };
+  const uint32_t v = filterAdcSamples(s, 32);
+  TEST_ASSERT_UINT32_WITHIN(1, 1850, v);
+}
+
+static void test_filter_rounds_to_nearest()
+{
+  uint16_t s[4] = {10, 11, 11, 40};
+  // trims 10 and 40, mean of 11 and 11
+  TEST_ASSERT_EQUAL_UINT32(11, filterAdcSamples(s, 4));
+  uint16_t t[2] = {10, 11};
+  // nothing to trim, 10.5 rounds up
+  TEST_ASSERT_EQUAL_UINT32(11, filterAdcSamples(t, 2));
+}
+
+static void test_filter_sorts_in_place()
+{
+  uint16_t s[5] = {5, 1, 4, 2, 3};
+  filterAdcSamples(s, 5);
+  for (int i = 0; i < 5; ++i)
+  {
+    TEST_ASSERT_EQUAL_UINT16(i + 1, s[i]);
+  }
+}
+
+static void test_filter_empty()
+{
+  TEST_ASSERT_EQUAL_UINT32(0, filterAdcSamples(nullptr, 0));
+}
+
+static void test_level_thresholds()
+{
+  TEST_ASSERT_EQUAL(BATTERY_OK,
+                    batLevel(3463, BATTERY_OK, THRESHOLDS, HYSTERESIS));
+  TEST_ASSERT_EQUAL(BATTERY_LOW,
+                    batLevel(3462, BATTERY_OK, THRESHOLDS, HYSTERESIS));
+  TEST_ASSERT_EQUAL(BATTERY_VERY_LOW,
+                    batLevel(3442, BATTERY_OK, THRESHOLDS, HYSTERESIS));
+  TEST_ASSERT_EQUAL(BATTERY_CRIT_LOW,
+                    batLevel(3404, BATTERY_OK, THRESHOLDS, HYSTERESIS));
+  TEST_ASSERT_EQUAL(BATTERY_CRIT_LOW,
+                    batLevel(3000, BATTERY_OK, THRESHOLDS, HYSTERESIS));
+}
+
+static void test_level_hysteresis()
+{
+  // left only more than 15mV above the threshold
+  TEST_ASSERT_EQUAL(BATTERY_LOW,
+                    batLevel(3477, BATTERY_LOW, THRESHOLDS, HYSTERESIS));
+  TEST_ASSERT_EQUAL(BATTERY_OK,
+                    batLevel(3478, BATTERY_LOW, THRESHOLDS, HYSTERESIS));
+  // recovering from CRIT_LOW steps through the levels
+  TEST_ASSERT_EQUAL(BATTERY_CRIT_LOW,
+                    batLevel(3419, BATTERY_CRIT_LOW, THRESHOLDS, HYSTERESIS));
+  TEST_ASSERT_EQUAL(BATTERY_VERY_LOW,
+                    batLevel(3420, BATTERY_CRIT_LOW, THRESHOLDS, HYSTERESIS));
+  TEST_ASSERT_EQUAL(BATTERY_LOW,
+                    batLevel(3458, BATTERY_CRIT_LOW, THRESHOLDS, HYSTERESIS));
+}
+
+static void test_level_hovering_does_not_flap()
+{
+  // noise of a few mV around the LOW threshold
+  const uint32_t trace[] = {3465, 3461, 3464, 3460, 3466, 3463, 3468, 3462};
+  battery_level_t level = BATTERY_OK;
+  int changes = 0;
+  for (uint32_t v : trace)
+  {
+    const battery_level_t next = batLevel(v, level, THRESHOLDS, HYSTERESIS);
+    changes += next != level;
+    level = next;
+  }
+  TEST_ASSERT_EQUAL(1, changes);
+  TEST_ASSERT_EQUAL(BATTERY_LOW, level);
+}
+
+/* Sum of the charge (10μAh) of the history, what the fit is based on.
+ */
+static uint32_t totalCharge()
+{
+  uint32_t total = 0;
+  for (int i = 0; i < h.count; ++i)
+  {
+    total += h.samples[i].charge;
+  }
+  return total;
+}
+
+/* Discharge at a constant mahPerDay, the voltage falling mvPerMah, sampled
+ * every interval seconds for days.
+ */
+static void discharge(uint16_t mv0, float mvPerMah, float mahPerDay,
+                      uint32_t interval, uint32_t days)
+{
+  const float mahPerSample = mahPerDay * interval / DAY;
+  for (uint32_t t = 0; t <= days * DAY; t += interval)
+  {
+    const float used = mahPerDay * t / DAY;
+    batHistoryAppend(h, T0 + t,
+                     static_cast<uint16_t>(std::round(mv0 - mvPerMah * used)),
+                     mahPerSample);
+  }
+}
+
+static void test_first_sample_has_no_charge()
+{
+  batHistoryAppend(h, T0, 4000, 5.f);
+  TEST_ASSERT_EQUAL(1, h.count);
+  TEST_ASSERT_EQUAL(0, h.samples[0].charge);
+  batHistoryAppend(h, T0 + HOUR, 3999, 1.234f);
+  TEST_ASSERT_EQUAL(2, h.count);
+  TEST_ASSERT_EQUAL(123, h.samples[1].charge);
+}
+
+static void test_recharge_resets_history()
+{
+  batHistoryAppend(h, T0, 3800, 0.f);
+  batHistoryAppend(h, T0 + HOUR, 3790, 1.f);
+  batHistoryAppend(h, T0 + 2 * HOUR, 4100, 1.f);
+  TEST_ASSERT_EQUAL(1, h.count);
+  TEST_ASSERT_EQUAL(4100, h.samples[0].mv);
+}
+
+static void test_clock_going_back_resets_history()
+{
+  batHistoryAppend(h, T0, 3800, 0.f);
+  batHistoryAppend(h, T0 + HOUR, 3790, 1.f);
+  batHistoryAppend(h, T0 + HOUR / 2, 3790, 1.f);
+  TEST_ASSERT_EQUAL(1, h.count);
+  TEST_ASSERT_EQUAL_UINT32(T0 + HOUR / 2, h.samples[0].dt);
+}
+
+static void test_compaction_keeps_span_and_charge()
+{
+  for (uint32_t i = 0; i < BAT_HISTORY_SIZE; ++i)
+  {
+    batHistoryAppend(h, T0 + i * HOUR, 4000 - i, 1.01f);
+  }
+  const uint32_t charge = totalCharge();
+  const uint32_t first = h.samples[0].dt;
+  const uint32_t last = h.samples[h.count - 1].dt;
+
+  batHistoryCompact(h);
+  TEST_ASSERT_EQUAL(BAT_HISTORY_SIZE - BAT_HISTORY_SIZE / 4, h.count);
+  TEST_ASSERT_EQUAL_UINT32(charge, totalCharge());
+  TEST_ASSERT_EQUAL_UINT32(last, h.samples[h.count - 1].dt);
+  TEST_ASSERT_LESS_OR_EQUAL(first + HOUR, h.samples[0].dt);
+  for (int i = 1; i < h.count; ++i)
+  {
+    TEST_ASSERT_TRUE(h.samples[i].dt > h.samples[i - 1].dt);
+  }
+}
+
+static void test_full_history_compacts_on_append()
+{
+  for (uint32_t i = 0; i <= BAT_HISTORY_SIZE; ++i)
+  {
+    batHistoryAppend(h, T0 + i * HOUR, 4000 - i, 1.f);
+  }
+  TEST_ASSERT_EQUAL(BAT_HISTORY_SIZE - BAT_HISTORY_SIZE / 4 + 1, h.count);
+  TEST_ASSERT_EQUAL_UINT32(T0 + BAT_HISTORY_SIZE * HOUR,
+                           h.samples[h.count - 1].dt);
+}
+
+static void test_no_estimate_without_history()
+{
+  bat_estimate_t e;
+  TEST_ASSERT_FALSE(batEstimate(h, 3500, e));
+  discharge(4000, 0.5f, 20.f, HOUR, 0);
+  TEST_ASSERT_FALSE(batEstimate(h, 3500, e));
+  // enough samples, but less than a day
+  discharge(4000, 0.5f, 20.f, HOUR / 4, 0);
+  for (uint32_t i = 1; i < 8; ++i)
+  {
+    batHistoryAppend(h, T0 + i * HOUR, 4000 - i, 1.f);
+  }
+  TEST_ASSERT_FALSE(batEstimate(h, 3500, e));
+}
+
+static void test_no_estimate_while_voltage_flat()
+{
+  bat_estimate_t e;
+  for (uint32_t i = 0; i < 16; ++i)
+  {
+    batHistoryAppend(h, T0 + i * 6 * HOUR, 4000, 2.f);
+  }
+  TEST_ASSERT_FALSE(batEstimate(h, 3500, e));
+}
+
+static void test_linear_discharge()
+{
+  // 0.5mV per mAh, 20mAh per day, sampled every 6 hours for 10 days
+  discharge(4000, 0.5f, 20.f, 6 * HOUR, 10);
+  bat_estimate_t e;
+  TEST_ASSERT_TRUE(batEstimate(h, 3500, e));
+  TEST_ASSERT_FLOAT_WITHIN(0.02f, -0.5f, e.mv_per_mah);
+  TEST_ASSERT_FLOAT_WITHIN(0.5f, 20.f, e.mah_per_day);
+  // 3900mV now, 400mV left to go
+  TEST_ASSERT_FLOAT_WITHIN(25.f, 800.f, e.mah_left);
+  TEST_ASSERT_FLOAT_WITHIN(2.f, 40.f, e.days_left);
+}
+
+static void test_below_critical_has_nothing_left()
+{
+  discharge(3550, 0.5f, 20.f, 6 * HOUR, 10);
+  bat_estimate_t e;
+  TEST_ASSERT_TRUE(batEstimate(h, 3500, e));
+  TEST_ASSERT_EQUAL_FLOAT(0.f, e.mah_left);
+  TEST_ASSERT_EQUAL_FLOAT(0.f, e.days_left);
+}
+
+static void test_tiny_rate_is_bounded()
+{
+  // 10μAh per sample, the voltage falling 1mV every 10 samples
+  for (uint32_t i = 0; i < 40; ++i)
+  {
+    batHistoryAppend(h, T0 + i * 6 * HOUR, 4000 - i / 10, 0.01f);
+  }
+  bat_estimate_t e;
+  TEST_ASSERT_TRUE(batEstimate(h, 0, e));
+  TEST_ASSERT_TRUE(std::isfinite(e.days_left));
+  TEST_ASSERT_EQUAL_FLOAT(9999.f, e.days_left);
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_filter_constant);
+  RUN_TEST(test_filter_rejects_spikes);
+  RUN_TEST(test_filter_rounds_to_nearest);
+  RUN_TEST(test_filter_sorts_in_place);
+  RUN_TEST(test_filter_empty);
+  RUN_TEST(test_level_thresholds);
+  RUN_TEST(test_level_hysteresis);
+  RUN_TEST(test_level_hovering_does_not_flap);
+  RUN_TEST(test_first_sample_has_no_charge);
+  RUN_TEST(test_recharge_resets_history);
+  RUN_TEST(test_clock_going_back_resets_history);
+  RUN_TEST(test_compaction_keeps_span_and_charge);
+  RUN_TEST(test_full_history_compacts_on_append);
+  RUN_TEST(test_no_estimate_without_history);
+  RUN_TEST(test_no_estimate_while_voltage_flat);
+  RUN_TEST(test_linear_discharge);
+  RUN_TEST(test_below_critical_has_nothing_left);
+  RUN_TEST(test_tiny_rate_is_bounded);
+  return UNITY_END();
+}
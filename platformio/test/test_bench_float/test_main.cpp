@@ -0,0 +1,175 @@
+/* Benchmarks of the single precision math helpers.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include <unity.h>
+#include "bench.h"
+#include "conversions.h"
+#include "float_math.h"
+#include "rnd.h"
+
+// inputs of each benchmark
+#define NUM_VALUES 256
+// the outlook graph: 24 hours
+#define GRAPH_HOURS 24
+
+static float values[NUM_VALUES];
+static int before[NUM_VALUES];
+static int after[NUM_VALUES];
+// left and right of the outlook graph, read at run time so that the positions
+// aren't computed at compile time
+static volatile int graphX0 = 350;
+static volatile int graphX1 = 770;
+
+void setUp()
+{
+  rndSeed(1);
+}
+
+void tearDown()
+{
+}
+
+/* Fills values with random values from lo to hi.
+ */
+static void randomValues(float lo, float hi)
+{
+  for (int i = 0; i < NUM_VALUES; ++i)
+  {
+    values[i] = lo + (hi - lo) * (rnd() % 10000) / 10000.f;
+  }
+}
+
+/* The Beaufort number as it was computed, with powf().
+ */
+static int beaufortPowf(float kilometersperhour)
+{
+  float meterspersecond = kilometersperhour / 3.6f;
+  int beaufort = (int) ((powf( 1 / 0.836f, 2.f/3.f)
+                         * powf(meterspersecond, 2.f/3.f))
+                        + .5f);
+  return beaufort > 12 ? 12 : beaufort;
+}
+
+static void test_beaufort()
+{
+  randomValues(0.f, 140.f);
+  const uint32_t runs = BENCH_RUNS(20);
+  const uint32_t t0 = benchTime(runs, [] {
+    for (int i = 0; i < NUM_VALUES; ++i)
+    {
+      before[i] = beaufortPowf(values[i]);
+    }
+  });
+  const uint32_t t1 = benchTime(runs, [] {
+    for (int i = 0; i < NUM_VALUES; ++i)
+    {
+      after[i] = kilometersperhour_to_beaufort(values[i]);
+    }
+  });
+  benchReport("Beaufort numbers", runs, t0, t1);
+  TEST_ASSERT_EQUAL_INT_ARRAY(before, after, NUM_VALUES);
+  TEST_ASSERT_LESS_THAN(t0, t1);
+}
+
+/* Values quantized to 1 decimal for the frame hash, through the double
+ * std::pow(10.f, decimals) against powerOfTen().
+ */
+static void test_quantize()
+{
+  randomValues(-40.f, 40.f);
+  const uint32_t runs = BENCH_RUNS(20);
+  const uint32_t t0 = benchTime(runs, [] {
+    for (int i = 0; i < NUM_VALUES; ++i)
+    {
+      before[i] = static_cast<int>(std::round(values[i]
+                                              * std::pow(10.f, 1 + i % 2)));
+    }
+  });
+  const uint32_t t1 = benchTime(runs, [] {
+    for (int i = 0; i < NUM_VALUES; ++i)
+    {
+      after[i] = static_cast<int>(std::round(values[i]
+                                             * powerOfTen(1 + i % 2)));
+    }
+  });
+  benchReport("quantized values", runs, t0, t1);
+  for (int i = 0; i < NUM_VALUES; ++i)
+  {
+    // may differ at ties, the float product being rounded
+    TEST_ASSERT_INT_WITHIN(1, before[i], after[i]);
+  }
+  TEST_ASSERT_LESS_THAN(t0, t1);
+}
+
+/* The hourly x positions of the outlook graph in double against integers.
+ */
+static void test_graph_positions()
+{
+  const uint32_t runs = BENCH_RUNS(100);
+  const uint32_t t0 = benchTime(runs, [] {
+    const int xPos0 = graphX0, xPos1 = graphX1;
+    const float xInterval = (xPos1 - xPos0 - 1)
+                            / static_cast<float>(GRAPH_HOURS);
+    for (int i = 0; i < GRAPH_HOURS; ++i)
+    {
+      before[i] = static_cast<int>(std::round(xPos0 + (i * xInterval)
+                                              + (0.5 * xInterval)));
+    }
+  });
+  const uint32_t t1 = benchTime(runs, [] {
+    const int xPos0 = graphX0, xPos1 = graphX1;
+    for (int i = 0; i < GRAPH_HOURS; ++i)
+    {
+      after[i] = xPos0 + roundDiv((2 * i + 1) * (xPos1 - xPos0 - 1),
+                                  2 * GRAPH_HOURS);
+    }
+  });
+  benchReport("graph positions", runs, t0, t1);
+  for (int i = 0; i < GRAPH_HOURS; ++i)
+  {
+    // may differ at exact half pixel ties
+    TEST_ASSERT_INT_WITHIN(1, before[i], after[i]);
+  }
+}
+
+static int runBenchmarks()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_beaufort);
+  RUN_TEST(test_quantize);
+  RUN_TEST(test_graph_positions);
+  return UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup()
+{
+  // time for the serial monitor to connect
+  delay(2000);
+  runBenchmarks();
+}
+
+void loop()
+{
+}
+#else
+int main()
+{
+  return runBenchmarks();
+}
+#endif
@@ -0,0 +1,417 @@
+/* Benchmarks of drawing into the 1bpp frame.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+#include <unity.h>
+#include <Adafruit_GFX.h>
+#include "bench.h"
+#include "frame_backend.h"
+#include "polyline.h"
+#include "rnd.h"
+#include "fonts/FreeSans/FreeSans_12pt8b.h"
+#include "fonts/FreeSans/FreeSans_48pt8b_temperature.h"
+#include "icons/196x196/wi_day_cloudy_196x196.h"
+#include "icons/48x48/wi_day_rain_48x48.h"
+#include "icons/24x24/wi_humidity_24x24.h"
+#include "icons/24x24/wi_sunrise_24x24.h"
+#include "icons/16x16/wifi_16x16.h"
+
+// the 7.5in panel
+#define W 800
+#define H 480
+// random draw calls of the primitives benchmark
+#define NUM_OPS 400
+// the outlook graph: 24 precipitation bars and 5 dotted lines
+#define GRAPH_X0 350
+#define GRAPH_X1 770
+#define GRAPH_Y0 300
+#define GRAPH_Y1 460
+#define GRAPH_BARS 24
+#define GRAPH_TICKS 5
+
+/* The frame as GxEPD2_BW draws it, every pixel through the virtual
+ * drawPixel(), rotated and clipped to the panel and to the partial window.
+ */
+class PixelPanel : public Adafruit_GFX
+{
+public:
+  uint8_t buffer[(W / 8) * H];
+
+  PixelPanel() : Adafruit_GFX(W, H) {}
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override
+  {
+    if (x < 0 || x >= width() || y < 0 || y >= height())
+    {
+      return;
+    }
+    switch (getRotation())
+    {
+    case 1: std::swap(x, y); x = W - x - 1;      break;
+    case 2: x = W - x - 1; y = H - y - 1;        break;
+    case 3: std::swap(x, y); y = H - y - 1;      break;
+    default:                                     break;
+    }
+    x -= pwX;
+    y -= pwY;
+    if (x < 0 || x >= pwW || y < 0 || y >= pwH)
+    {
+      return;
+    }
+    uint8_t &b = buffer[x / 8 + y * (pwW / 8)];
+    const uint8_t mask = 0x80 >> (x & 7);
+    b = (color == GxEPD_WHITE) ? (b | mask) : (b & ~mask);
+  }
+
+  // as GxEPD2_BW, pixel by pixel
+  void drawInvertedBitmap(int16_t x, int16_t y, const uint8_t bitmap[],
+                          int16_t w, int16_t h, uint16_t color)
+  {
+    const int16_t stride = (w + 7) / 8;
+    for (int16_t j = 0; j < h; ++j)
+    {
+      for (int16_t i = 0; i < w; ++i)
+      {
+        if (!(pgm_read_byte(&bitmap[j * stride + i / 8]) & (0x80 >> (i & 7))))
+        {
+          drawPixel(x + i, y + j, color);
+        }
+      }
+    }
+  }
+
+private:
+  int16_t pwX = 0, pwY = 0, pwW = W, pwH = H;
+};
+
+typedef struct draw_op
+{
+  uint8_t  kind;
+  int16_t  x;
+  int16_t  y;
+  int16_t  w;
+  int16_t  h;
+  uint16_t color;
+} draw_op_t;
+
+static PixelPanel panel;
+static uint8_t frame[MonoFrame<W, H>::size];
+static MonoFrame<W, H> mono(frame);
+static draw_op_t ops[NUM_OPS];
+static int16_t barTops[GRAPH_BARS];
+static int curveX[GRAPH_BARS + 1];
+static int curveY[GRAPH_BARS + 1];
+static int16_t curveLo[W + 2];
+static int16_t curveHi[W + 2];
+static const uint8_t hatchEven[8] = {0xAA, 0x00, 0xAA, 0x00,
+                                     0xAA, 0x00, 0xAA, 0x00};
+static const uint8_t hatchOdd[8]  = {0x00, 0xAA, 0x00, 0xAA,
+                                     0x00, 0xAA, 0x00, 0xAA};
+
+void setUp()
+{
+  rndSeed(1);
+  memset(panel.buffer, 0xFF, sizeof(panel.buffer));
+  memset(frame, 0xFF, sizeof(frame));
+}
+
+void tearDown()
+{
+}
+
+/* Makes draw calls like those of a frame: lines of the graphs, borders and
+ * separators, filled rectangles of the bars and single pixels, some of them
+ * partly off the panel.
+ */
+static void makeOps()
+{
+  for (int i = 0; i < NUM_OPS; ++i)
+  {
+    draw_op_t &op = ops[i];
+    op.kind  = rnd() % 5;
+    op.x     = rndIn(-20, W + 20);
+    op.y     = rndIn(-20, H + 20);
+    op.w     = (op.kind == 0) ? rndIn(-20, W + 20) : rndIn(1, 120);
+    op.h     = (op.kind == 0) ? rndIn(-20, H + 20) : rndIn(1, 120);
+    op.color = (rnd() % 4 == 0) ? GxEPD_WHITE : GxEPD_BLACK;
+  }
+}
+
+template<class GFX>
+static void drawOps(GFX &gfx)
+{
+  for (int i = 0; i < NUM_OPS; ++i)
+  {
+    const draw_op_t &op = ops[i];
+    switch (op.kind)
+    {
+    case 0: gfx.drawLine(op.x, op.y, op.w, op.h, op.color);    break;
+    case 1: gfx.drawFastHLine(op.x, op.y, 4 * op.w, op.color); break;
+    case 2: gfx.drawFastVLine(op.x, op.y, 4 * op.h, op.color); break;
+    case 3: gfx.fillRect(op.x, op.y, op.w, op.h, op.color);    break;
+    default: gfx.drawPixel(op.x, op.y, op.color);             break;
+    }
+  }
+}
+
+/* Prints lines of text at (x, y) and below as GxEPD2_BW did, through
+ * Adafruit_GFX::drawChar(), which draws a glyph pixel by pixel.
+ */
+static void printPixels(const GFXfont *font, const char *const *lines, int n,
+                        int16_t x, int16_t y)
+{
+  panel.setFont(font);
+  panel.setTextColor(GxEPD_BLACK);
+  panel.setTextWrap(false);
+  for (int i = 0; i < n; ++i)
+  {
+    panel.setCursor(x, y + i * font->yAdvance);
+    panel.print(lines[i]);
+  }
+}
+
+/* Prints the same lines into the frame a glyph row at a time, as the capturing
+ * display's write() does.
+ */
+static void printGlyphs(const GFXfont *font, const char *const *lines, int n,
+                        int16_t x, int16_t y)
+{
+  for (int i = 0; i < n; ++i)
+  {
+    int16_t cursor = x;
+    for (const char *c = lines[i]; *c != '\0'; ++c)
+    {
+      cursor += mono.drawGlyph(font, *c, cursor, y + i * font->yAdvance,
+                               GxEPD_BLACK);
+    }
+  }
+}
+
+/* Draws the icons of a frame: the current conditions, the forecast, the
+ * current condition details and the status bar.
+ */
+template<class GFX>
+static void drawIcons(GFX &gfx)
+{
+  gfx.drawInvertedBitmap(0, 0, wi_day_cloudy_196x196, 196, 196, GxEPD_BLACK);
+  for (int16_t i = 0; i < 5; ++i)
+  {
+    gfx.drawInvertedBitmap(398 + i * 82, 98, wi_day_rain_48x48, 48, 48,
+                           GxEPD_BLACK);
+  }
+  for (int16_t i = 0; i < 4; ++i)
+  {
+    gfx.drawInvertedBitmap(3 + i * 84, 204, wi_sunrise_24x24, 24, 24,
+                           GxEPD_BLACK);
+    gfx.drawInvertedBitmap(3 + i * 84, 252, wi_humidity_24x24, 24, 24,
+                           GxEPD_BLACK);
+  }
+  gfx.drawInvertedBitmap(701, 462, wifi_16x16, 16, 16, GxEPD_BLACK);
+}
+
+/* The hatching and dotted lines of the outlook graph as the renderer drew them
+ * through drawPixel() (fillPatternPixels() and drawDottedHLinePixels() in
+ * renderer.h).
+ */
+static void drawGraphPixels()
+{
+  const int16_t w = (GRAPH_X1 - GRAPH_X0) / GRAPH_BARS;
+  for (int i = 0; i < GRAPH_BARS; ++i)
+  {
+    const uint8_t *pattern = (GRAPH_Y1 - 1) % 2 ? hatchOdd : hatchEven;
+    const int16_t x0 = GRAPH_X0 + i * w;
+    for (int16_t py = barTops[i] + 1; py < GRAPH_Y1; ++py)
+    {
+      const uint8_t bits = pattern[py & 7];
+      for (int16_t px = x0; bits != 0 && px < x0 + w; ++px)
+      {
+        if (bits & (0x80 >> (px & 7)))
+        {
+          panel.drawPixel(px, py, GxEPD_BLACK);
+        }
+      }
+    }
+  }
+  for (int i = 0; i < GRAPH_TICKS; ++i)
+  {
+    const int16_t y = GRAPH_Y0 + i * (GRAPH_Y1 - GRAPH_Y0) / GRAPH_TICKS;
+    for (int16_t x = GRAPH_X0; x <= GRAPH_X1 + 1; x += 3)
+    {
+      panel.drawPixel(x, y + (y % 2), GxEPD_BLACK);
+    }
+  }
+}
+
+/* The same into the frame, a byte at a time.
+ */
+static void drawGraphBytes()
+{
+  const int16_t w = (GRAPH_X1 - GRAPH_X0) / GRAPH_BARS;
+  for (int i = 0; i < GRAPH_BARS; ++i)
+  {
+    mono.fillPattern(GRAPH_X0 + i * w, barTops[i] + 1, w,
+                     GRAPH_Y1 - 1 - barTops[i],
+                     (GRAPH_Y1 - 1) % 2 ? hatchOdd : hatchEven, GxEPD_BLACK);
+  }
+  for (int i = 0; i < GRAPH_TICKS; ++i)
+  {
+    const int16_t y = GRAPH_Y0 + i * (GRAPH_Y1 - GRAPH_Y0) / GRAPH_TICKS;
+    mono.drawDottedHLine(GRAPH_X0, GRAPH_X1 + 1, y + (y % 2), 3, GxEPD_BLACK);
+  }
+}
+
+/* The temperature curve of the outlook graph as the renderer drew it, 3 lines
+ * per segment for a width of 2.
+ */
+static void drawCurveLines()
+{
+  for (int i = 1; i <= GRAPH_BARS; ++i)
+  {
+    const int x0 = curveX[i - 1], y0 = curveY[i - 1];
+    const int x1 = curveX[i],     y1 = curveY[i];
+    panel.drawLine(x0,     y0,     x1,     y1,     GxEPD_BLACK);
+    panel.drawLine(x0 - 1, y0,     x1 - 1, y1,     GxEPD_BLACK);
+    panel.drawLine(x0,     y0 + 1, x1,     y1 + 1, GxEPD_BLACK);
+  }
+}
+
+/* The same curve as one span per column.
+ */
+static void drawCurveSpans()
+{
+  const uint16_t cols = thickPolylineSpans(curveX, curveY, GRAPH_BARS + 1, 2,
+                                           curveLo, curveHi);
+  for (uint16_t i = 0; i < cols; ++i)
+  {
+    if (curveLo[i] <= curveHi[i])
+    {
+      mono.drawFastVLine(curveX[0] - 1 + i, curveLo[i],
+                         curveHi[i] - curveLo[i] + 1, GxEPD_BLACK);
+    }
+  }
+}
+
+static void test_primitives()
+{
+  makeOps();
+  const uint32_t runs = BENCH_RUNS(4);
+  const uint32_t before = benchTime(runs, [] { drawOps(panel); });
+  const uint32_t after = benchTime(runs, [] { drawOps(mono); });
+  benchReport("lines and rectangles", runs, before, after);
+  TEST_ASSERT_EQUAL_MEMORY(panel.buffer, frame, sizeof(frame));
+  TEST_ASSERT_LESS_THAN(before, after);
+}
+
+static void test_glyphs()
+{
+  static const char *const text[] = {
+    "Partly cloudy throughout the day.",
+    "Wind 14 km/h from the north west,",
+    "gusting to 32 km/h in the evening.",
+    "Sunrise 7:12  Sunset 18:45  UV 3",
+    "Humidity 64%  Pressure 1016 hPa"
+  };
+  static const char *const temperature[] = {"-12"};
+  const uint32_t runs = BENCH_RUNS(10);
+  uint32_t before = benchTime(runs, [] {
+    printPixels(&FreeSans_12pt8b, text, 5, 10, 30);
+  });
+  uint32_t after = benchTime(runs, [] {
+    printGlyphs(&FreeSans_12pt8b, text, 5, 10, 30);
+  });
+  benchReport("12pt text", runs, before, after);
+  TEST_ASSERT_EQUAL_MEMORY(panel.buffer, frame, sizeof(frame));
+  TEST_ASSERT_LESS_THAN(before, after);
+
+  before = benchTime(runs, [] {
+    printPixels(&FreeSans_48pt8b_temperature, temperature, 1, 420, 300);
+  });
+  after = benchTime(runs, [] {
+    printGlyphs(&FreeSans_48pt8b_temperature, temperature, 1, 420, 300);
+  });
+  benchReport("48pt temperature", runs, before, after);
+  TEST_ASSERT_EQUAL_MEMORY(panel.buffer, frame, sizeof(frame));
+  TEST_ASSERT_LESS_THAN(before, after);
+}
+
+static void test_icons()
+{
+  const uint32_t runs = BENCH_RUNS(10);
+  const uint32_t before = benchTime(runs, [] { drawIcons(panel); });
+  const uint32_t after = benchTime(runs, [] { drawIcons(mono); });
+  benchReport("icons", runs, before, after);
+  TEST_ASSERT_EQUAL_MEMORY(panel.buffer, frame, sizeof(frame));
+  TEST_ASSERT_LESS_THAN(before, after);
+}
+
+static void test_graph()
+{
+  for (int i = 0; i < GRAPH_BARS; ++i)
+  {
+    barTops[i] = rndIn(GRAPH_Y0, GRAPH_Y1 - 1);
+  }
+  const uint32_t runs = BENCH_RUNS(10);
+  const uint32_t before = benchTime(runs, drawGraphPixels);
+  const uint32_t after = benchTime(runs, drawGraphBytes);
+  benchReport("graph hatching and dotted lines", runs, before, after);
+  TEST_ASSERT_EQUAL_MEMORY(panel.buffer, frame, sizeof(frame));
+  TEST_ASSERT_LESS_THAN(before, after);
+}
+
+static void test_temperature_curve()
+{
+  for (int i = 0; i <= GRAPH_BARS; ++i)
+  {
+    curveX[i] = GRAPH_X0 + i * (GRAPH_X1 - GRAPH_X0) / GRAPH_BARS;
+    curveY[i] = rndIn(GRAPH_Y0, GRAPH_Y1 - 2);
+  }
+  const uint32_t runs = BENCH_RUNS(10);
+  const uint32_t before = benchTime(runs, drawCurveLines);
+  const uint32_t after = benchTime(runs, drawCurveSpans);
+  benchReport("temperature curve", runs, before, after);
+  TEST_ASSERT_EQUAL_MEMORY(panel.buffer, frame, sizeof(frame));
+  TEST_ASSERT_LESS_THAN(before, after);
+}
+
+static int runBenchmarks()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_primitives);
+  RUN_TEST(test_glyphs);
+  RUN_TEST(test_icons);
+  RUN_TEST(test_graph);
+  RUN_TEST(test_temperature_curve);
+  return UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup()
+{
+  // time for the serial monitor to connect
+  delay(2000);
+  runBenchmarks();
+}
+
+void loop()
+{
+}
+#else
+int main()
+{
+  return runBenchmarks();
+}
+#endif
@@ -0,0 +1,156 @@
+/* Benchmarks of measuring text.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+#include <unity.h>
+#include <Adafruit_GFX.h>
+#include "bench.h"
+#include "text_metrics.h"
+#include "fonts/FreeSans/FreeSans_6pt8b.h"
+#include "fonts/FreeSans/FreeSans_12pt8b.h"
+#include "fonts/FreeSans/FreeSans_26pt8b.h"
+#include "fonts/FreeSans/FreeSans_48pt8b_temperature.h"
+
+/* A display that only measures text, getTextBounds() never draws.
+ */
+class MeasureGfx : public Adafruit_GFX
+{
+public:
+  MeasureGfx() : Adafruit_GFX(800, 480)
+  {
+    setTextWrap(false);
+  }
+
+  void drawPixel(int16_t, int16_t, uint16_t) override {}
+};
+
+static const GFXfont *const fonts[] = {&FreeSans_6pt8b, &FreeSans_12pt8b,
+                                       &FreeSans_26pt8b,
+                                       &FreeSans_48pt8b_temperature};
+// texts like those the renderer measures: labels, values and descriptions
+static const char *const texts[] = {
+  "Sunrise", "Sunset", "Wind", "Humidity", "UV Index", "Pressure",
+  "Air Quality", "Visibility", "Indoor Temperature", "Indoor Humidity",
+  "21", "-12", "1016 hPa", "14 km/h", "64%", "6:42", "18:45", "Mon", "12 AM",
+  ">10 km", "Moderate", "Light rain throughout the day.",
+  "Wednesday, October 14", "Your City, Country", "Last Refresh 12:34 PM",
+  "Partly cloudy in the morning, clearing in the afternoon", ""
+};
+#define NUM_FONTS (sizeof(fonts) / sizeof(fonts[0]))
+#define NUM_TEXTS (sizeof(texts) / sizeof(texts[0]))
+
+static MeasureGfx gfx;
+static uint32_t sink;
+
+void setUp()
+{
+  sink = 0;
+}
+
+void tearDown()
+{
+}
+
+/* Widths of all texts in all fonts with getTextBounds(), as the renderer
+ * measured them.
+ */
+static void measureBounds()
+{
+  for (size_t f = 0; f < NUM_FONTS; ++f)
+  {
+    gfx.setFont(fonts[f]);
+    for (size_t t = 0; t < NUM_TEXTS; ++t)
+    {
+      int16_t x1, y1;
+      uint16_t w, h;
+      gfx.getTextBounds(texts[t], 0, 0, &x1, &y1, &w, &h);
+      sink += w;
+    }
+  }
+}
+
+/* The same widths with fontTextWidth().
+ */
+static void measureWidths()
+{
+  for (size_t f = 0; f < NUM_FONTS; ++f)
+  {
+    for (size_t t = 0; t < NUM_TEXTS; ++t)
+    {
+      sink += fontTextWidth(fonts[f], texts[t], strlen(texts[t]));
+    }
+  }
+}
+
+static void test_same_bounds()
+{
+  for (size_t f = 0; f < NUM_FONTS; ++f)
+  {
+    gfx.setFont(fonts[f]);
+    for (size_t t = 0; t < NUM_TEXTS; ++t)
+    {
+      int16_t x1, y1;
+      uint16_t w, h;
+      gfx.getTextBounds(texts[t], 0, 0, &x1, &y1, &w, &h);
+      const text_bounds_t b = fontTextBounds(fonts[f], texts[t],
+                                             strlen(texts[t]));
+      TEST_ASSERT_EQUAL(w, fontTextWidth(fonts[f], texts[t], strlen(texts[t])));
+      TEST_ASSERT_EQUAL(x1, b.x);
+      TEST_ASSERT_EQUAL(y1, b.y);
+      TEST_ASSERT_EQUAL(w, b.w);
+      TEST_ASSERT_EQUAL(h, b.h);
+    }
+  }
+}
+
+static void test_width()
+{
+  const uint32_t runs = BENCH_RUNS(10);
+  const uint32_t before = benchTime(runs, measureBounds);
+  const uint32_t boundsSum = sink;
+  sink = 0;
+  const uint32_t after = benchTime(runs, measureWidths);
+  benchReport("text widths", runs, before, after);
+  TEST_ASSERT_EQUAL(boundsSum, sink);
+  TEST_ASSERT_LESS_THAN(before, after);
+}
+
+static int runBenchmarks()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_same_bounds);
+  RUN_TEST(test_width);
+  return UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup()
+{
+  // time for the serial monitor to connect
+  delay(2000);
+  runBenchmarks();
+}
+
+void loop()
+{
+}
+#else
+int main()
+{
+  return runBenchmarks();
+}
+#endif
@@ -0,0 +1,278 @@
+/* Unit tests for the 1bpp blitting routines.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+#include <unity.h>
+#include "blit.h"
+#include "rnd.h"
+
+// plane of W x H pixels, W a multiple of 8
+#define W 40
+#define H 16
+
+static uint8_t plane[W / 8 * H];
+static uint8_t ref[W / 8 * H];
+
+void setUp()
+{
+  rndSeed(1);
+}
+
+void tearDown()
+{
+}
+
+/* Fills both planes with the same random pixels, so that both setting and
+ * clearing pixels show.
+ */
+static void fillPlanes()
+{
+  for (size_t i = 0; i < sizeof(plane); ++i)
+  {
+    plane[i] = ref[i] = rnd();
+  }
+}
+
+/* Sets pixel (x, y) of the reference plane to value, if it is in the plane.
+ */
+static void setPixel(int16_t x, int16_t y, bool value)
+{
+  if (x < 0 || x >= W || y < 0 || y >= H)
+  {
+    return;
+  }
+  uint8_t &b = ref[y * (W / 8) + x / 8];
+  b = value ? (b | (0x80 >> (x & 7))) : (b & ~(0x80 >> (x & 7)));
+}
+
+// glyphs of 3, 8, 11 and 17 pixels wide, so rows start at any bit offset of
+// the bitmap
+static uint8_t fontBitmap[64];
+static GFXglyph fontGlyphs[] = {
+  { 0,  3,  5,  4,  0, -5}, // 'A'
+  { 2,  8,  7,  9,  1, -7}, // 'B'
+  { 9, 11,  9, 12, -1, -8}, // 'C'
+  {22, 17, 12, 18,  2, -10} // 'D'
+};
+static const GFXfont font = {fontBitmap, fontGlyphs, 'A', 'D', 16};
+
+/* Draws glyph c of font with the cursor at (x, y) pixel by pixel into the
+ * reference plane, as Adafruit_GFX::drawChar() does with a transparent
+ * background.
+ */
+static void glyphPixels(uint8_t c, int16_t x, int16_t y, bool value)
+{
+  const GFXglyph &g = font.glyph[c - font.first];
+  uint32_t bit = g.bitmapOffset * 8;
+  for (int16_t r = 0; r < g.height; ++r)
+  {
+    for (int16_t col = 0; col < g.width; ++col, ++bit)
+    {
+      if (font.bitmap[bit >> 3] & (0x80 >> (bit & 7)))
+      {
+        setPixel(x + g.xOffset + col, y + g.yOffset + r, value);
+      }
+    }
+  }
+}
+
+static void test_glyph_matches_pixels()
+{
+  for (size_t i = 0; i < sizeof(fontBitmap); ++i)
+  {
+    fontBitmap[i] = rnd();
+  }
+  // every x offset within a byte, and glyphs clipped on every side
+  const int16_t ys[] = {-6, 0, 4, 10, 15, 20};
+  for (uint8_t c = 'A'; c <= 'D'; ++c)
+  {
+    for (int16_t x = -20; x <= W + 2; ++x)
+    {
+      for (int16_t y : ys)
+      {
+        for (int value = 0; value <= 1; ++value)
+        {
+          fillPlanes();
+          const uint8_t advance = blitGlyph(plane, W, H, &font, c, x, y,
+                                            value);
+          glyphPixels(c, x, y, value);
+          TEST_ASSERT_EQUAL(fontGlyphs[c - 'A'].xAdvance, advance);
+          TEST_ASSERT_EQUAL_MEMORY(ref, plane, sizeof(plane));
+        }
+      }
+    }
+  }
+}
+
+static void test_glyph_not_in_font()
+{
+  fillPlanes();
+  TEST_ASSERT_EQUAL(0, blitGlyph(plane, W, H, &font, ' ', 8, 8, true));
+  TEST_ASSERT_EQUAL(0, blitGlyph(plane, W, H, &font, 'E', 8, 8, true));
+  TEST_ASSERT_EQUAL_MEMORY(ref, plane, sizeof(plane));
+}
+
+/* Draws the 0 pixels of a bw x bh bitmap (rows padded to whole bytes) at
+ * (x, y) pixel by pixel into the reference plane, as drawInvertedBitmap() of
+ * GxEPD2 does.
+ */
+static void invertedBitmapPixels(const uint8_t *bitmap, int16_t x, int16_t y,
+                                 int16_t bw, int16_t bh, bool value)
+{
+  const int16_t stride = (bw + 7) / 8;
+  for (int16_t r = 0; r < bh; ++r)
+  {
+    for (int16_t col = 0; col < bw; ++col)
+    {
+      if (!(bitmap[r * stride + col / 8] & (0x80 >> (col & 7))))
+      {
+        setPixel(x + col, y + r, value);
+      }
+    }
+  }
+}
+
+static void test_inverted_bitmap_matches_pixels()
+{
+  uint8_t bitmap[3 * 12];
+  for (size_t i = 0; i < sizeof(bitmap); ++i)
+  {
+    bitmap[i] = rnd();
+  }
+  // byte aligned and unaligned, widths that end inside and on a byte, and
+  // bitmaps clipped on every side
+  const int16_t widths[] = {5, 8, 16, 21, 24};
+  const int16_t ys[] = {-13, -4, 0, 3, 10, 16};
+  for (int16_t bw : widths)
+  {
+    for (int16_t x = -26; x <= W + 2; ++x)
+    {
+      for (int16_t y : ys)
+      {
+        for (int value = 0; value <= 1; ++value)
+        {
+          fillPlanes();
+          blitInvertedBitmap(plane, W, H, bitmap, x, y, bw, 12, value);
+          invertedBitmapPixels(bitmap, x, y, bw, 12, value);
+          TEST_ASSERT_EQUAL_MEMORY(ref, plane, sizeof(plane));
+        }
+      }
+    }
+  }
+}
+
+static void test_pattern_matches_pixels()
+{
+  uint8_t pattern[8];
+  for (uint8_t &row : pattern)
+  {
+    row = rnd();
+  }
+  pattern[3] = 0; // rows without pixels are skipped
+  const int16_t sizes[] = {0, 1, 5, 8, 13, 30};
+  for (int16_t x = -10; x <= W + 1; x += 3)
+  {
+    for (int16_t y = -4; y <= H; y += 5)
+    {
+      for (int16_t pw : sizes)
+      {
+        for (int value = 0; value <= 1; ++value)
+        {
+          const int16_t ph = pw / 2 + 1;
+          fillPlanes();
+          fillPattern(plane, W, H, x, y, pw, ph, pattern, value);
+          // as fillPatternPixels() in renderer.h
+          for (int16_t py = y; py < y + ph; ++py)
+          {
+            for (int16_t px = x; px < x + pw; ++px)
+            {
+              if (pattern[py & 7] & (0x80 >> (px & 7)))
+              {
+                setPixel(px, py, value);
+              }
+            }
+          }
+          TEST_ASSERT_EQUAL_MEMORY(ref, plane, sizeof(plane));
+        }
+      }
+    }
+  }
+}
+
+static void test_vline_matches_pixels()
+{
+  const int16_t xs[] = {-1, 0, 7, 8, 21, W - 1, W};
+  for (int16_t x : xs)
+  {
+    for (int16_t y = -5; y <= H; y += 3)
+    {
+      for (int16_t len = 0; len <= H + 5; len += 4)
+      {
+        for (int value = 0; value <= 1; ++value)
+        {
+          fillPlanes();
+          fillVLine(plane, W, H, x, y, len, value);
+          for (int16_t py = y; py < y + len; ++py)
+          {
+            setPixel(x, py, value);
+          }
+          TEST_ASSERT_EQUAL_MEMORY(ref, plane, sizeof(plane));
+        }
+      }
+    }
+  }
+}
+
+static void test_dotted_line_matches_pixels()
+{
+  const int16_t ys[] = {-1, 0, 7, H - 1, H};
+  for (uint8_t step = 1; step <= 8; ++step)
+  {
+    for (int16_t x0 = -12; x0 <= W; x0 += 1)
+    {
+      for (int16_t x1 = x0 - 1; x1 <= W + 12; x1 += 5)
+      {
+        for (int16_t y : ys)
+        {
+          for (int value = 0; value <= 1; ++value)
+          {
+            fillPlanes();
+            drawDottedHLine(plane, W, H, x0, x1, y, step, value);
+            // as drawDottedHLinePixels() in renderer.h
+            for (int16_t x = x0; x <= x1; x += step)
+            {
+              setPixel(x, y, value);
+            }
+            TEST_ASSERT_EQUAL_MEMORY(ref, plane, sizeof(plane));
+          }
+        }
+      }
+    }
+  }
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_glyph_matches_pixels);
+  RUN_TEST(test_glyph_not_in_font);
+  RUN_TEST(test_inverted_bitmap_matches_pixels);
+  RUN_TEST(test_pattern_matches_pixels);
+  RUN_TEST(test_vline_matches_pixels);
+  RUN_TEST(test_dotted_line_matches_pixels);
+  return UNITY_END();
+}
@@ -0,0 +1,158 @@
+/* Unit tests for the energy budget.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include <unity.h>
+#include "energy_model.h"
+
+static const energy_currents_t currents = {
+  40.f,               // active
+  {120.f, 30.f},      // WiFi, display
+  0.01f               // sleep
+};
+
+// 24mAh per day, 0.24mAh of it for deep sleep, 16 hours outside of bed time
+static const energy_policy_t policy = {
+  24.f, 0.01f, 16 * 60, 5, 120, 5
+};
+
+static energy_budget_t b;
+
+void setUp()
+{
+  b = {};
+}
+
+void tearDown()
+{
+}
+
+static void test_wake_charge()
+{
+  // 10s awake: 4s WiFi, 3s display, 3s CPU only
+  const energy_trace_t t = {10000, {4000, 3000}};
+  const float expected = (4.f * 120.f + 3.f * 30.f + 3.f * 40.f) / 3600.f;
+  TEST_ASSERT_FLOAT_WITHIN(1e-6f, expected, energyWakeCharge(t, currents));
+}
+
+static void test_wake_charge_phases_longer_than_awake()
+{
+  // phases measured across a clock hiccup are never charged twice
+  const energy_trace_t t = {1000, {2000, 0}};
+  TEST_ASSERT_FLOAT_WITHIN(1e-6f, 2.f * 120.f / 3600.f,
+                           energyWakeCharge(t, currents));
+}
+
+static void test_fallback_until_known()
+{
+  TEST_ASSERT_EQUAL(30, energySleepInterval(b, policy, 30));
+  TEST_ASSERT_EQUAL(5, energySleepInterval(b, policy, 1));
+  TEST_ASSERT_EQUAL(120, energySleepInterval(b, policy, 600));
+  // rounded up to the step
+  TEST_ASSERT_EQUAL(35, energySleepInterval(b, policy, 31));
+}
+
+static void test_first_update_sets_wake_charge()
+{
+  energyBudgetUpdate(b, policy, 0.2f, 0.f, 1800);
+  TEST_ASSERT_EQUAL_FLOAT(0.2f, b.wake_mah);
+  // credited 0.5mAh for half an hour, spent 0.2mAh
+  TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.3f, b.balance_mah);
+}
+
+static void test_single_slow_wake_is_smoothed()
+{
+  energyBudgetUpdate(b, policy, 0.2f, 0.f, 1800);
+  energyBudgetUpdate(b, policy, 1.0f, 0.f, 1800);
+  TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.4f, b.wake_mah);
+}
+
+static void test_interval_meets_target()
+{
+  b.wake_mah = 0.2f;
+  // (24 - 0.24) / 0.2 = 118.8 wakes over 960 minutes, 8.08 minutes apart
+  TEST_ASSERT_EQUAL(10, energySleepInterval(b, policy, 30));
+  b.wake_mah = 0.5f;
+  // 47.52 wakes, 20.2 minutes apart
+  TEST_ASSERT_EQUAL(25, energySleepInterval(b, policy, 30));
+}
+
+static void test_overspending_lengthens_interval()
+{
+  b.wake_mah = 0.2f;
+  const int base = energySleepInterval(b, policy, 30);
+  b.balance_mah = -24.f;
+  TEST_ASSERT_GREATER_THAN(base, energySleepInterval(b, policy, 30));
+  b.balance_mah = 24.f;
+  TEST_ASSERT_LESS_OR_EQUAL(base, energySleepInterval(b, policy, 30));
+}
+
+static void test_nothing_available_sleeps_longest()
+{
+  b.wake_mah = 0.2f;
+  energy_policy_t p = policy;
+  p.sleep_ma = 1.f;
+  TEST_ASSERT_EQUAL(120, energySleepInterval(b, p, 30));
+}
+
+static void test_balance_is_capped()
+{
+  for (int i = 0; i < 100; ++i)
+  {
+    energyBudgetBalance(b, policy, 5.f, 60);
+  }
+  TEST_ASSERT_EQUAL_FLOAT(-24.f, b.balance_mah);
+  for (int i = 0; i < 100; ++i)
+  {
+    energyBudgetBalance(b, policy, 0.f, 86400);
+  }
+  TEST_ASSERT_EQUAL_FLOAT(24.f, b.balance_mah);
+}
+
+static void test_balance_does_not_change_wake_charge()
+{
+  b.wake_mah = 0.2f;
+  energyBudgetBalance(b, policy, 3.f, 60);
+  TEST_ASSERT_EQUAL_FLOAT(0.2f, b.wake_mah);
+}
+
+static void test_corrupt_budget_recovers()
+{
+  b.wake_mah = NAN;
+  b.balance_mah = INFINITY;
+  TEST_ASSERT_EQUAL(30, energySleepInterval(b, policy, 30));
+  energyBudgetUpdate(b, policy, 0.2f, 0.f, 1800);
+  TEST_ASSERT_EQUAL_FLOAT(0.2f, b.wake_mah);
+  TEST_ASSERT_TRUE(std::isfinite(b.balance_mah));
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_wake_charge);
+  RUN_TEST(test_wake_charge_phases_longer_than_awake);
+  RUN_TEST(test_fallback_until_known);
+  RUN_TEST(test_first_update_sets_wake_charge);
+  RUN_TEST(test_single_slow_wake_is_smoothed);
+  RUN_TEST(test_interval_meets_target);
+  RUN_TEST(test_overspending_lengthens_interval);
+  RUN_TEST(test_nothing_available_sleeps_longest);
+  RUN_TEST(test_balance_is_capped);
+  RUN_TEST(test_balance_does_not_change_wake_charge);
+  RUN_TEST(test_corrupt_budget_recovers);
+  return UNITY_END();
+}
@@ -0,0 +1,108 @@
+/* Unit tests for the single precision math helpers.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include <unity.h>
+#include "float_math.h"
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+static void test_power_of_ten()
+{
+  float expected = 1.f;
+  for (int e = 0; e <= 9; ++e)
+  {
+    TEST_ASSERT_EQUAL_FLOAT(expected, powerOfTen(e));
+    expected *= 10.f;
+  }
+  // clamped to the table
+  TEST_ASSERT_EQUAL_FLOAT(1.f, powerOfTen(-1));
+  TEST_ASSERT_EQUAL_FLOAT(1e9f, powerOfTen(10));
+}
+
+static void test_round_decimals()
+{
+  TEST_ASSERT_EQUAL_FLOAT(29.9f, roundDecimals(29.92f, 1));
+  TEST_ASSERT_EQUAL_FLOAT(-3.5f, roundDecimals(-3.46f, 1));
+  TEST_ASSERT_EQUAL_FLOAT(1013.f, roundDecimals(1012.5f, 0));
+  TEST_ASSERT_EQUAL_FLOAT(-1013.f, roundDecimals(-1012.5f, 0));
+  TEST_ASSERT_EQUAL_FLOAT(0.13f, roundDecimals(0.125f, 2));
+  TEST_ASSERT_EQUAL_FLOAT(7.f, roundDecimals(7.f, 3));
+}
+
+static void test_round_decimals_matches_double()
+{
+  // hundredths of the sensor and API ranges, to 0 and 1 decimals as they are
+  // displayed, the same as the expression it replaced: the product is rounded
+  // in float, only the division was in double
+  for (int i = -100000; i <= 100000; ++i)
+  {
+    const float value = i / 100.f;
+    for (int decimals = 0; decimals <= 1; ++decimals)
+    {
+      const double scale = std::pow(10.0, decimals);
+      const float expected = static_cast<float>(
+                 std::round(value * static_cast<float>(scale)) / scale);
+      TEST_ASSERT_EQUAL_FLOAT(expected, roundDecimals(value, decimals));
+    }
+  }
+}
+
+static void test_ceil_div()
+{
+  for (int d = 1; d <= 100; ++d)
+  {
+    for (int n = 1; n <= 1000; ++n)
+    {
+      TEST_ASSERT_EQUAL(static_cast<int>(std::ceil(n / (double) d)),
+                        ceilDiv(n, d));
+    }
+  }
+  TEST_ASSERT_EQUAL(0, ceilDiv(0, 7));
+}
+
+static void test_round_div()
+{
+  for (int d = 1; d <= 100; ++d)
+  {
+    for (int n = 0; n <= 1000; ++n)
+    {
+      TEST_ASSERT_EQUAL(static_cast<int>(std::floor(n / (double) d + 0.5)),
+                        roundDiv(n, d));
+    }
+  }
+  // halves round up
+  TEST_ASSERT_EQUAL(3, roundDiv(5, 2));
+  TEST_ASSERT_EQUAL(1, roundDiv(1, 2));
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_power_of_ten);
+  RUN_TEST(test_round_decimals);
+  RUN_TEST(test_round_decimals_matches_double);
+  RUN_TEST(test_ceil_div);
+  RUN_TEST(test_round_div);
+  return UNITY_END();
+}
@@ -0,0 +1,365 @@
+/* Unit tests for the frame backends.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+#include <utility>
+#include <unity.h>
+#include "frame_backend.h"
+#include "rnd.h"
+
+// panel of W x H pixels, W a multiple of 8
+#define W 32
+#define H 24
+// random draw calls on each frame
+#define NUM_OPS 400
+
+static const uint16_t colors[] = {GxEPD_BLACK, GxEPD_WHITE, GxEPD_RED,
+                                  GxEPD_YELLOW, GxEPD_GREEN, GxEPD_BLUE,
+                                  GxEPD_ORANGE};
+
+// colors of the panel pixels, as drawn by the reference primitives
+static uint16_t ref[H][W];
+static uint8_t buffer[W * H];
+static uint8_t expected[W * H];
+static uint8_t fontBitmap[64];
+static GFXglyph fontGlyphs[] = {
+  { 0,  3,  5,  4,  0, -5}, // 'A'
+  { 2, 11,  9, 12, -1, -8}, // 'B'
+  {15, 17, 12, 18,  2, -10} // 'C'
+};
+static const GFXfont font = {fontBitmap, fontGlyphs, 'A', 'C', 16};
+static uint8_t bitmap[3 * 12];
+
+void setUp()
+{
+  rndSeed(1);
+}
+
+void tearDown()
+{
+}
+
+/* The reference primitives draw pixel by pixel, rotated and clipped as
+ * Adafruit_GFX and GxEPD2 drawPixel() do.
+ */
+template<uint8_t R>
+static void refPixel(int16_t x, int16_t y, uint16_t color)
+{
+  const int16_t width  = (R & 1) ? H : W;
+  const int16_t height = (R & 1) ? W : H;
+  if (x < 0 || y < 0 || x >= width || y >= height)
+  {
+    return;
+  }
+  switch (R)
+  {
+  case 1: std::swap(x, y); x = W - x - 1;     break;
+  case 2: x = W - x - 1;   y = H - y - 1;     break;
+  case 3: std::swap(x, y); y = H - y - 1;     break;
+  default:                                    break;
+  }
+  ref[y][x] = color;
+}
+
+// Adafruit_GFX::writeLine()
+template<uint8_t R>
+static void refLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                    uint16_t color)
+{
+  const bool steep = std::abs(y1 - y0) > std::abs(x1 - x0);
+  if (steep)
+  {
+    std::swap(x0, y0);
+    std::swap(x1, y1);
+  }
+  if (x0 > x1)
+  {
+    std::swap(x0, x1);
+    std::swap(y0, y1);
+  }
+  const int16_t dx = x1 - x0;
+  const int16_t dy = std::abs(y1 - y0);
+  const int16_t ystep = (y0 < y1) ? 1 : -1;
+  int16_t err = dx / 2;
+  for (; x0 <= x1; ++x0)
+  {
+    if (steep)
+    {
+      refPixel<R>(y0, x0, color);
+    }
+    else
+    {
+      refPixel<R>(x0, y0, color);
+    }
+    err -= dy;
+    if (err < 0)
+    {
+      y0 += ystep;
+      err += dx;
+    }
+  }
+}
+
+template<uint8_t R>
+static void refRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+  for (int16_t r = y; r < y + h; ++r)
+  {
+    for (int16_t c = x; c < x + w; ++c)
+    {
+      refPixel<R>(c, r, color);
+    }
+  }
+}
+
+/* Makes one random draw call on frame and the same on the reference.
+ */
+template<uint8_t R, class Frame>
+static void randomOp(Frame &frame)
+{
+  const int16_t width  = Frame::width;
+  const int16_t height = Frame::height;
+  const uint16_t color = colors[rnd() % (sizeof(colors) / sizeof(colors[0]))];
+  const int16_t x = rndIn(-20, width + 2);
+  const int16_t y = rndIn(-14, height + 2);
+  const int16_t w = rndIn(0, width + 4);
+  const int16_t h = rndIn(0, height + 4);
+  switch (rnd() % 9)
+  {
+  case 0:
+    frame.drawPixel(x, y, color);
+    refPixel<R>(x, y, color);
+    break;
+  case 1:
+    frame.drawFastHLine(x, y, w, color);
+    refRect<R>(x, y, w, 1, color);
+    break;
+  case 2:
+    frame.drawFastVLine(x, y, h, color);
+    refRect<R>(x, y, 1, h, color);
+    break;
+  case 3:
+    frame.fillRect(x, y, w, h, color);
+    refRect<R>(x, y, w, h, color);
+    break;
+  case 4:
+  {
+    // vertical and horizontal lines too
+    const int16_t x1 = (rnd() % 4 == 0) ? x : rndIn(-10, width + 10);
+    const int16_t y1 = (rnd() % 4 == 0) ? y : rndIn(-10, height + 10);
+    frame.drawLine(x, y, x1, y1, color);
+    refLine<R>(x, y, x1, y1, color);
+    break;
+  }
+  case 5:
+  {
+    const int16_t bw = rndIn(1, 24);
+    frame.drawInvertedBitmap(x, y, bitmap, bw, 12, color);
+    const int16_t stride = (bw + 7) / 8;
+    for (int16_t r = 0; r < 12; ++r)
+    {
+      for (int16_t c = 0; c < bw; ++c)
+      {
+        if (!(bitmap[r * stride + c / 8] & (0x80 >> (c & 7))))
+        {
+          refPixel<R>(x + c, y + r, color);
+        }
+      }
+    }
+    break;
+  }
+  case 6:
+  {
+    const uint8_t c = 'A' + rnd() % 4; // 'D' is not in the font
+    const uint8_t advance = frame.drawGlyph(&font, c, x, y, color);
+    if (c > font.last)
+    {
+      TEST_ASSERT_EQUAL(0, advance);
+      break;
+    }
+    const GFXglyph &g = font.glyph[c - font.first];
+    TEST_ASSERT_EQUAL(g.xAdvance, advance);
+    uint32_t bit = g.bitmapOffset * 8;
+    for (int16_t r = 0; r < g.height; ++r)
+    {
+      for (int16_t col = 0; col < g.width; ++col, ++bit)
+      {
+        if (font.bitmap[bit >> 3] & (0x80 >> (bit & 7)))
+        {
+          refPixel<R>(x + g.xOffset + col, y + g.yOffset + r, color);
+        }
+      }
+    }
+    break;
+  }
+  case 7:
+  {
+    uint8_t pattern[8];
+    for (uint8_t &row : pattern)
+    {
+      row = rnd();
+    }
+    frame.fillPattern(x, y, w, h, pattern, color);
+    for (int16_t py = y; py < y + h; ++py)
+    {
+      for (int16_t px = x; px < x + w; ++px)
+      {
+        if (pattern[py & 7] & (0x80 >> (px & 7)))
+        {
+          refPixel<R>(px, py, color);
+        }
+      }
+    }
+    break;
+  }
+  default:
+  {
+    const uint8_t step = rndIn(1, 8);
+    frame.drawDottedHLine(x, x + w, y, step, color);
+    for (int16_t px = x; px <= x + w; px += step)
+    {
+      refPixel<R>(px, y, color);
+    }
+    break;
+  }
+  }
+}
+
+/* Encodes the reference as a MonoFrame, a Color3Frame or a Color7Frame, as
+ * GxEPD2_BW, GxEPD2_3C and GxEPD2_7C store the colors.
+ */
+static void encodeMono()
+{
+  memset(expected, 0, sizeof(expected));
+  for (int16_t y = 0; y < H; ++y)
+  {
+    for (int16_t x = 0; x < W; ++x)
+    {
+      if (ref[y][x] == GxEPD_WHITE)
+      {
+        expected[y * (W / 8) + x / 8] |= 0x80 >> (x & 7);
+      }
+    }
+  }
+}
+
+static void encodeColor3()
+{
+  memset(expected, 0, sizeof(expected));
+  uint8_t *color = expected + (W / 8) * H;
+  for (int16_t y = 0; y < H; ++y)
+  {
+    for (int16_t x = 0; x < W; ++x)
+    {
+      const uint8_t mask = 0x80 >> (x & 7);
+      if (ref[y][x] != GxEPD_BLACK)
+      {
+        expected[y * (W / 8) + x / 8] |= mask;
+      }
+      if (ref[y][x] != GxEPD_RED && ref[y][x] != GxEPD_YELLOW)
+      {
+        color[y * (W / 8) + x / 8] |= mask;
+      }
+    }
+  }
+}
+
+static void encodeColor7()
+{
+  memset(expected, 0, sizeof(expected));
+  for (int16_t y = 0; y < H; ++y)
+  {
+    for (int16_t x = 0; x < W; ++x)
+    {
+      uint8_t c = 0x01;
+      switch (ref[y][x])
+      {
+      case GxEPD_BLACK:  c = 0x00; break;
+      case GxEPD_GREEN:  c = 0x02; break;
+      case GxEPD_BLUE:   c = 0x03; break;
+      case GxEPD_RED:    c = 0x04; break;
+      case GxEPD_YELLOW: c = 0x05; break;
+      case GxEPD_ORANGE: c = 0x06; break;
+      default:                     break;
+      }
+      expected[(y * W + x) / 2] |= (x & 1) ? c : (c << 4);
+    }
+  }
+}
+
+/* Draws NUM_OPS random calls on a frame of type F at rotation R and on the
+ * reference, and compares them after each call.
+ */
+template<template<int16_t, int16_t, uint8_t> class F, uint8_t R>
+static void checkFrame(void (*encode)())
+{
+  using Frame = F<W, H, R>;
+  for (size_t i = 0; i < sizeof(fontBitmap); ++i)
+  {
+    fontBitmap[i] = rnd();
+  }
+  for (size_t i = 0; i < sizeof(bitmap); ++i)
+  {
+    bitmap[i] = rnd();
+  }
+  TEST_ASSERT_LESS_OR_EQUAL(sizeof(buffer), Frame::size);
+  Frame frame(buffer);
+  const uint16_t background = colors[rnd() % 2];
+  frame.fillScreen(background);
+  refRect<R>(0, 0, Frame::width, Frame::height, background);
+  encode();
+  TEST_ASSERT_EQUAL_MEMORY(expected, buffer, Frame::size);
+  for (int i = 0; i < NUM_OPS; ++i)
+  {
+    randomOp<R>(frame);
+    encode();
+    TEST_ASSERT_EQUAL_MEMORY(expected, buffer, Frame::size);
+  }
+}
+
+static void test_mono_frame()
+{
+  checkFrame<MonoFrame, 0>(encodeMono);
+  checkFrame<MonoFrame, 1>(encodeMono);
+  checkFrame<MonoFrame, 2>(encodeMono);
+  checkFrame<MonoFrame, 3>(encodeMono);
+}
+
+static void test_color3_frame()
+{
+  checkFrame<Color3Frame, 0>(encodeColor3);
+  checkFrame<Color3Frame, 1>(encodeColor3);
+  checkFrame<Color3Frame, 2>(encodeColor3);
+  checkFrame<Color3Frame, 3>(encodeColor3);
+}
+
+static void test_color7_frame()
+{
+  checkFrame<Color7Frame, 0>(encodeColor7);
+  checkFrame<Color7Frame, 1>(encodeColor7);
+  checkFrame<Color7Frame, 2>(encodeColor7);
+  checkFrame<Color7Frame, 3>(encodeColor7);
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_mono_frame);
+  RUN_TEST(test_color3_frame);
+  RUN_TEST(test_color7_frame);
+  return UNITY_END();
+}
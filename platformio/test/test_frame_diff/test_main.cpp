@@ -0,0 +1,261 @@
+/* Unit tests for frame differencing.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+#include <unity.h>
+#include "frame_diff.h"
+#include "rnd.h"
+
+#define WIDTH   800
+#define HEIGHT  480
+#define TILES_X (WIDTH / FRAME_TILE_SIZE)
+#define TILES_Y (HEIGHT / FRAME_TILE_SIZE)
+
+static uint8_t frame[WIDTH / 8 * HEIGHT];
+static uint32_t prev[TILES_X * TILES_Y];
+static uint32_t cur[TILES_X * TILES_Y];
+static frame_diff_t d;
+
+void setUp()
+{
+  memset(frame, 0xFF, sizeof(frame));
+  for (int i = 0; i < TILES_X * TILES_Y; ++i)
+  {
+    prev[i] = cur[i] = 1000 + i;
+  }
+  d = {};
+}
+
+void tearDown()
+{
+}
+
+static void change(int tx, int ty)
+{
+  ++cur[ty * TILES_X + tx];
+}
+
+/* Returns true if tile (tx, ty) is inside rectangle r.
+ */
+static bool covers(const frame_rect_t &r, int tx, int ty)
+{
+  const int x = tx * FRAME_TILE_SIZE;
+  const int y = ty * FRAME_TILE_SIZE;
+  return x >= r.x && x < r.x + r.w && y >= r.y && y < r.y + r.h;
+}
+
+static void assertRect(const frame_rect_t &r, int x, int y, int w, int h)
+{
+  TEST_ASSERT_EQUAL(x, r.x);
+  TEST_ASSERT_EQUAL(y, r.y);
+  TEST_ASSERT_EQUAL(w, r.w);
+  TEST_ASSERT_EQUAL(h, r.h);
+}
+
+static void test_hash_changes_only_touched_tile()
+{
+  uint32_t a[TILES_X * TILES_Y];
+  uint32_t b[TILES_X * TILES_Y];
+  frameHashTiles(frame, WIDTH, HEIGHT, a);
+  // one pixel in tile (3, 2)
+  const int x = 3 * FRAME_TILE_SIZE + 5;
+  const int y = 2 * FRAME_TILE_SIZE + 31;
+  frame[y * (WIDTH / 8) + x / 8] &= ~(0x80 >> (x % 8));
+  frameHashTiles(frame, WIDTH, HEIGHT, b);
+  for (int i = 0; i < TILES_X * TILES_Y; ++i)
+  {
+    TEST_ASSERT_NOT_EQUAL(0, a[i]);
+    if (i == 2 * TILES_X + 3)
+    {
+      TEST_ASSERT_NOT_EQUAL(a[i], b[i]);
+    }
+    else
+    {
+      TEST_ASSERT_EQUAL_UINT32(a[i], b[i]);
+    }
+  }
+}
+
+static void test_no_change()
+{
+  frameDiffTiles(prev, cur, TILES_X, TILES_Y, d);
+  TEST_ASSERT_EQUAL(0, d.changed_tiles);
+  TEST_ASSERT_EQUAL(TILES_X * TILES_Y, d.total_tiles);
+  TEST_ASSERT_EQUAL(0, d.num_rects);
+}
+
+static void test_runs_merge_down()
+{
+  // status bar text: tiles 12 to 14 of the last two rows
+  for (int ty = TILES_Y - 2; ty < TILES_Y; ++ty)
+  {
+    for (int tx = 12; tx <= 14; ++tx)
+    {
+      change(tx, ty);
+    }
+  }
+  frameDiffTiles(prev, cur, TILES_X, TILES_Y, d);
+  TEST_ASSERT_EQUAL(6, d.changed_tiles);
+  TEST_ASSERT_EQUAL(1, d.num_rects);
+  assertRect(d.rects[0], 384, 416, 96, 64);
+}
+
+static void test_different_columns_do_not_merge()
+{
+  // an L: two tiles on row 1, one of them continues on row 2
+  change(4, 1);
+  change(5, 1);
+  change(4, 2);
+  frameDiffTiles(prev, cur, TILES_X, TILES_Y, d);
+  TEST_ASSERT_EQUAL(3, d.changed_tiles);
+  TEST_ASSERT_EQUAL(2, d.num_rects);
+  assertRect(d.rects[0], 128, 32, 64, 32);
+  assertRect(d.rects[1], 128, 64, 32, 32);
+}
+
+static void test_runs_on_one_row()
+{
+  change(0, 0);
+  change(2, 0);
+  change(TILES_X - 1, 0);
+  frameDiffTiles(prev, cur, TILES_X, TILES_Y, d);
+  TEST_ASSERT_EQUAL(3, d.num_rects);
+  assertRect(d.rects[2], WIDTH - 32, 0, 32, 32);
+}
+
+static void test_overflow_uses_bounding_box()
+{
+  // a checkerboard needs a rectangle per tile
+  for (int ty = 3; ty < 7; ++ty)
+  {
+    for (int tx = 2 + ty % 2; tx < 10; tx += 2)
+    {
+      change(tx, ty);
+    }
+  }
+  frameDiffTiles(prev, cur, TILES_X, TILES_Y, d);
+  TEST_ASSERT_EQUAL(16, d.changed_tiles);
+  TEST_ASSERT_EQUAL(1, d.num_rects);
+  assertRect(d.rects[0], 64, 96, 256, 128);
+}
+
+static void test_rects_cover_exactly_the_changed_tiles()
+{
+  rndSeed(12345);
+  for (int round = 0; round < 500; ++round)
+  {
+    setUp();
+    // a few random blocks of tiles
+    const int blocks = 1 + round % 4;
+    for (int i = 0; i < blocks; ++i)
+    {
+      const uint32_t r = rnd();
+      const int x0 = r % TILES_X;
+      const int y0 = (r >> 8) % TILES_Y;
+      const int w = 1 + (r >> 16) % 4;
+      const int h = 1 + (r >> 20) % 4;
+      for (int ty = y0; ty < y0 + h && ty < TILES_Y; ++ty)
+      {
+        for (int tx = x0; tx < x0 + w && tx < TILES_X; ++tx)
+        {
+          cur[ty * TILES_X + tx] = prev[ty * TILES_X + tx] + 1;
+        }
+      }
+    }
+    frameDiffTiles(prev, cur, TILES_X, TILES_Y, d);
+    TEST_ASSERT_TRUE(d.num_rects >= 1 && d.num_rects <= FRAME_MAX_RECTS);
+
+    int covered = 0;
+    for (int ty = 0; ty < TILES_Y; ++ty)
+    {
+      for (int tx = 0; tx < TILES_X; ++tx)
+      {
+        int n = 0;
+        for (int i = 0; i < d.num_rects; ++i)
+        {
+          n += covers(d.rects[i], tx, ty);
+        }
+        const bool changed = prev[ty * TILES_X + tx] != cur[ty * TILES_X + tx];
+        if (changed)
+        {
+          TEST_ASSERT_EQUAL(1, n);
+        }
+        covered += n;
+      }
+    }
+    // several rectangles are disjoint and cover nothing else, a single one
+    // may be the bounding box
+    if (d.num_rects > 1)
+    {
+      TEST_ASSERT_EQUAL(d.changed_tiles, covered);
+    }
+  }
+}
+
+static void test_policy()
+{
+  const frame_policy_t p = {0.5f, 3};
+  change(1, 1);
+  frameDiffTiles(prev, cur, TILES_X, TILES_Y, d);
+  TEST_ASSERT_EQUAL(FRAME_REFRESH_PARTIAL, frameRefreshPolicy(d, true, 0, p));
+  TEST_ASSERT_EQUAL(FRAME_REFRESH_PARTIAL, frameRefreshPolicy(d, true, 2, p));
+  // ghosting budget used up
+  TEST_ASSERT_EQUAL(FRAME_REFRESH_FULL, frameRefreshPolicy(d, true, 3, p));
+  // the panel content is unknown
+  TEST_ASSERT_EQUAL(FRAME_REFRESH_FULL, frameRefreshPolicy(d, false, 0, p));
+
+  setUp();
+  frameDiffTiles(prev, cur, TILES_X, TILES_Y, d);
+  TEST_ASSERT_EQUAL(FRAME_REFRESH_NONE, frameRefreshPolicy(d, true, 3, p));
+  TEST_ASSERT_EQUAL(FRAME_REFRESH_FULL, frameRefreshPolicy(d, false, 0, p));
+}
+
+static void test_policy_area()
+{
+  const frame_policy_t p = {0.5f, 3};
+  // the left half of the display, and one more column of tiles
+  for (int ty = 0; ty < TILES_Y; ++ty)
+  {
+    for (int tx = 0; tx < TILES_X / 2; ++tx)
+    {
+      change(tx, ty);
+    }
+  }
+  frameDiffTiles(prev, cur, TILES_X, TILES_Y, d);
+  TEST_ASSERT_EQUAL(FRAME_REFRESH_PARTIAL, frameRefreshPolicy(d, true, 0, p));
+  for (int ty = 0; ty < TILES_Y; ++ty)
+  {
+    change(TILES_X / 2, ty);
+  }
+  frameDiffTiles(prev, cur, TILES_X, TILES_Y, d);
+  TEST_ASSERT_EQUAL(FRAME_REFRESH_FULL, frameRefreshPolicy(d, true, 0, p));
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_hash_changes_only_touched_tile);
+  RUN_TEST(test_no_change);
+  RUN_TEST(test_runs_merge_down);
+  RUN_TEST(test_different_columns_do_not_merge);
+  RUN_TEST(test_runs_on_one_row);
+  RUN_TEST(test_overflow_uses_bounding_box);
+  RUN_TEST(test_rects_cover_exactly_the_changed_tiles);
+  RUN_TEST(test_policy);
+  RUN_TEST(test_policy_area);
+  return UNITY_END();
+}
@@ -0,0 +1,179 @@
+/* Unit tests for PackBits compression.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+#include <unity.h>
+#include "packbits.h"
+#include "rnd.h"
+
+#define MAX_N 600
+
+static uint8_t src[MAX_N];
+static uint8_t packed[PACKBITS_MAX_SIZE(MAX_N)];
+static uint8_t out[MAX_N];
+
+void setUp()
+{
+  rndSeed(1);
+}
+
+void tearDown()
+{
+}
+
+/* Encodes and decodes the first n bytes of src, returns the encoded size.
+ */
+static size_t roundTrip(size_t n)
+{
+  memset(packed, 0xA5, sizeof(packed));
+  const size_t size = packBitsEncode(src, n, packed);
+  TEST_ASSERT_LESS_OR_EQUAL(PACKBITS_MAX_SIZE(n), size);
+  memset(out, 0x5A, sizeof(out));
+  TEST_ASSERT_EQUAL(size, packBitsDecode(packed, size, out, n));
+  TEST_ASSERT_EQUAL_MEMORY(src, out, n);
+  return size;
+}
+
+static void test_white_row()
+{
+  // a white row of the 800px panel
+  memset(src, 0xFF, 100);
+  TEST_ASSERT_EQUAL(2, roundTrip(100));
+}
+
+static void test_run_lengths()
+{
+  // runs are at most 128 bytes long
+  const size_t lengths[] = {1, 2, 3, 127, 128, 129, 130, 256, 257, 600};
+  for (size_t n : lengths)
+  {
+    memset(src, 0x00, n);
+    roundTrip(n);
+  }
+  memset(src, 0x00, 128);
+  TEST_ASSERT_EQUAL(2, roundTrip(128));
+  memset(src, 0x00, 129);
+  TEST_ASSERT_EQUAL(4, roundTrip(129));
+}
+
+static void test_short_runs_stay_literal()
+{
+  const uint8_t row[] = {1, 1, 2, 3, 3, 4, 4, 4, 5};
+  memcpy(src, row, sizeof(row));
+  // 5 literals, a run of 3, 1 literal
+  TEST_ASSERT_EQUAL(6 + 2 + 2, roundTrip(sizeof(row)));
+}
+
+static void test_incompressible_worst_case()
+{
+  for (size_t i = 0; i < MAX_N; ++i)
+  {
+    src[i] = static_cast<uint8_t>(i * 7 + (i >> 3));
+  }
+  const size_t lengths[] = {1, 127, 128, 129, 255, 256, 257, 600};
+  for (size_t n : lengths)
+  {
+    TEST_ASSERT_EQUAL(PACKBITS_MAX_SIZE(n), roundTrip(n));
+  }
+}
+
+static void test_random_round_trips()
+{
+  for (int round = 0; round < 2000; ++round)
+  {
+    // text and icons: runs of white and black broken up by noise
+    const size_t n = 1 + rnd() % MAX_N;
+    size_t i = 0;
+    while (i < n)
+    {
+      const uint32_t r = rnd();
+      size_t len = 1 + r % (r & 0x100 ? 200 : 4);
+      const uint8_t v = r & 0x200 ? (r & 0x400 ? 0xFF : 0x00)
+                                  : static_cast<uint8_t>(r >> 12);
+      for (; len > 0 && i < n; --len)
+      {
+        src[i++] = v;
+      }
+    }
+    roundTrip(n);
+  }
+}
+
+static void test_rows_decode_in_sequence()
+{
+  // rows are stored back to back, each decode consumes exactly its own row
+  const size_t stride = 100;
+  uint8_t frame[stride * 3];
+  memset(frame, 0xFF, sizeof(frame));
+  for (size_t i = 0; i < stride; i += 3)
+  {
+    frame[stride + i] = static_cast<uint8_t>(i);
+  }
+  size_t size = 0;
+  for (int y = 0; y < 3; ++y)
+  {
+    size += packBitsEncode(frame + y * stride, stride, packed + size);
+  }
+  size_t in = 0;
+  for (int y = 0; y < 3; ++y)
+  {
+    const size_t used = packBitsDecode(packed + in, size - in, out, stride);
+    TEST_ASSERT_GREATER_THAN(0, used);
+    TEST_ASSERT_EQUAL_MEMORY(frame + y * stride, out, stride);
+    in += used;
+  }
+  TEST_ASSERT_EQUAL(size, in);
+}
+
+static void test_decode_rejects_bad_input()
+{
+  memset(src, 0x00, 10);
+  src[4] = 9;
+  const size_t size = packBitsEncode(src, 10, packed);
+  // truncated
+  for (size_t n = 0; n < size; ++n)
+  {
+    TEST_ASSERT_EQUAL(0, packBitsDecode(packed, n, out, 10));
+  }
+  // decodes to more than asked for
+  TEST_ASSERT_EQUAL(0, packBitsDecode(packed, size, out, 9));
+  // a run with its value missing
+  const uint8_t run[] = {0xFD};
+  TEST_ASSERT_EQUAL(0, packBitsDecode(run, sizeof(run), out, 4));
+}
+
+static void test_decode_skips_no_op()
+{
+  const uint8_t data[] = {128, 0xFE, 7, 128, 0x00, 9};
+  TEST_ASSERT_EQUAL(sizeof(data), packBitsDecode(data, sizeof(data), out, 4));
+  const uint8_t expected[] = {7, 7, 7, 9};
+  TEST_ASSERT_EQUAL_MEMORY(expected, out, 4);
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_white_row);
+  RUN_TEST(test_run_lengths);
+  RUN_TEST(test_short_runs_stay_literal);
+  RUN_TEST(test_incompressible_worst_case);
+  RUN_TEST(test_random_round_trips);
+  RUN_TEST(test_rows_decode_in_sequence);
+  RUN_TEST(test_decode_rejects_bad_input);
+  RUN_TEST(test_decode_skips_no_op);
+  return UNITY_END();
+}
@@ -0,0 +1,238 @@
+/* Unit tests for the polyline stroke.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+#include <unity.h>
+#include "bench.h"
+#include "polyline.h"
+#include "rnd.h"
+
+// pixel grid the reference strokes are drawn into, with room for the stroke
+// around the points
+#define GRID 64
+#define MARGIN 8
+#define MAX_POINTS 24
+#define MAX_WIDTH 4
+
+static bool grid[GRID][GRID];
+static bool spans[GRID][GRID];
+static int xs[MAX_POINTS];
+static int ys[MAX_POINTS];
+static int16_t lo[GRID];
+static int16_t hi[GRID];
+// pixels written by drawLine()
+static uint32_t plotted;
+
+void setUp()
+{
+  rndSeed(1);
+  memset(grid, 0, sizeof(grid));
+  memset(spans, 0, sizeof(spans));
+}
+
+void tearDown()
+{
+}
+
+/* Sets the pixels of the line from (x0, y0) to (x1, y1) in grid, as
+ * Adafruit_GFX::writeLine() draws it.
+ */
+static void drawLine(int x0, int y0, int x1, int y1)
+{
+  const bool steep = std::abs(y1 - y0) > std::abs(x1 - x0);
+  if (steep)
+  {
+    std::swap(x0, y0);
+    std::swap(x1, y1);
+  }
+  if (x0 > x1)
+  {
+    std::swap(x0, x1);
+    std::swap(y0, y1);
+  }
+  const int dx = x1 - x0;
+  const int dy = std::abs(y1 - y0);
+  const int ystep = (y0 < y1) ? 1 : -1;
+  int err = dx / 2;
+  for (; x0 <= x1; ++x0)
+  {
+    ++plotted;
+    if (steep)
+    {
+      grid[x0][y0] = true;
+    }
+    else
+    {
+      grid[y0][x0] = true;
+    }
+    err -= dy;
+    if (err < 0)
+    {
+      y0 += ystep;
+      err += dx;
+    }
+  }
+}
+
+/* Draws the stroke of the polyline into grid as the graph used to draw it:
+ * every line once more for each extra pixel of width, shifted left and shifted
+ * down. For width 2 these are the 3 lines at (0, 0), (0, 1) and (-1, 0).
+ */
+static void drawStroke(uint16_t n, uint8_t width)
+{
+  for (uint16_t i = 0; i < n; ++i)
+  {
+    const uint16_t j = (i > 0) ? i - 1 : 0;
+    for (int k = 0; k < width; ++k)
+    {
+      drawLine(xs[j] - k, ys[j], xs[i] - k, ys[i]);
+      drawLine(xs[j], ys[j] + k, xs[i], ys[i] + k);
+    }
+  }
+}
+
+/* Fills spans from the result of thickPolylineSpans(), and checks that the
+ * columns are as documented.
+ */
+static void fillSpans(uint16_t n, uint8_t width)
+{
+  const uint16_t cols = thickPolylineSpans(xs, ys, n, width, lo, hi);
+  TEST_ASSERT_EQUAL(POLYLINE_COLUMNS(xs[0], xs[n - 1], width), cols);
+  for (uint16_t i = 0; i < cols; ++i)
+  {
+    for (int y = lo[i]; y <= hi[i]; ++y)
+    {
+      spans[y][xs[0] - (width - 1) + i] = true;
+    }
+  }
+}
+
+/* Makes a random polyline of n points going left to right.
+ */
+static void randomPolyline(uint16_t n)
+{
+  xs[0] = MARGIN + rnd() % 4;
+  ys[0] = MARGIN + rnd() % (GRID - 2 * MARGIN);
+  for (uint16_t i = 1; i < n; ++i)
+  {
+    xs[i] = xs[i - 1] + rnd() % 3;
+    ys[i] = MARGIN + rnd() % (GRID - 2 * MARGIN);
+  }
+}
+
+static void test_single_point()
+{
+  xs[0] = 10;
+  ys[0] = 20;
+  TEST_ASSERT_EQUAL(2, thickPolylineSpans(xs, ys, 1, 2, lo, hi));
+  // (9, 20), (10, 20) and (10, 21)
+  TEST_ASSERT_EQUAL(20, lo[0]);
+  TEST_ASSERT_EQUAL(20, hi[0]);
+  TEST_ASSERT_EQUAL(20, lo[1]);
+  TEST_ASSERT_EQUAL(21, hi[1]);
+  TEST_ASSERT_EQUAL(0, thickPolylineSpans(xs, ys, 0, 2, lo, hi));
+  TEST_ASSERT_EQUAL(0, thickPolylineSpans(xs, ys, 1, 0, lo, hi));
+}
+
+static void test_horizontal_line()
+{
+  xs[0] = 10;
+  xs[1] = 14;
+  ys[0] = ys[1] = 30;
+  TEST_ASSERT_EQUAL(6, thickPolylineSpans(xs, ys, 2, 2, lo, hi));
+  // the left column is only the line shifted left
+  TEST_ASSERT_EQUAL(30, lo[0]);
+  TEST_ASSERT_EQUAL(30, hi[0]);
+  for (int i = 1; i < 6; ++i)
+  {
+    TEST_ASSERT_EQUAL(30, lo[i]);
+    TEST_ASSERT_EQUAL(31, hi[i]);
+  }
+}
+
+static void test_spans_match_lines()
+{
+  for (uint8_t width = 1; width <= MAX_WIDTH; ++width)
+  {
+    for (int t = 0; t < 2000; ++t)
+    {
+      const uint16_t n = 1 + rnd() % MAX_POINTS;
+      randomPolyline(n);
+      memset(grid, 0, sizeof(grid));
+      memset(spans, 0, sizeof(spans));
+      drawStroke(n, width);
+      fillSpans(n, width);
+      TEST_ASSERT_EQUAL_MEMORY(grid, spans, sizeof(grid));
+    }
+  }
+}
+
+/* Fills spans from the result of thickPolylineSpans() for a width 2 stroke,
+ * returning the number of pixels written.
+ */
+static uint32_t fillTemperatureSpans(uint16_t n)
+{
+  uint32_t written = 0;
+  const uint16_t cols = thickPolylineSpans(xs, ys, n, 2, lo, hi);
+  for (uint16_t i = 0; i < cols; ++i)
+  {
+    for (int y = lo[i]; y <= hi[i]; ++y)
+    {
+      spans[y][xs[0] - 1 + i] = true;
+      ++written;
+    }
+  }
+  return written;
+}
+
+/* The stroke of the temperature curve (width 2) as 3 lines per segment against
+ * its spans: the lines write pixels more than once, the spans each once. The
+ * times are those of this build, see test_bench_frame for optimized ones.
+ */
+static void test_spans_cost()
+{
+  const uint32_t runs = 2000;
+  randomPolyline(MAX_POINTS);
+  plotted = 0;
+  drawStroke(MAX_POINTS, 2);
+  const uint32_t drawn = plotted;
+  const uint32_t written = fillTemperatureSpans(MAX_POINTS);
+  TEST_ASSERT_EQUAL_MEMORY(grid, spans, sizeof(grid));
+  TEST_ASSERT_LESS_THAN(drawn, written);
+
+  const uint32_t before = benchTime(runs, [] { drawStroke(MAX_POINTS, 2); });
+  const uint32_t after = benchTime(runs, [] {
+    fillTemperatureSpans(MAX_POINTS);
+  });
+  benchReport("temperature curve", runs, before, after);
+  char msg[64];
+  snprintf(msg, sizeof(msg), "%u pixels written by the lines, %u by the spans",
+           static_cast<unsigned>(drawn), static_cast<unsigned>(written));
+  TEST_MESSAGE(msg);
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_single_point);
+  RUN_TEST(test_horizontal_line);
+  RUN_TEST(test_spans_match_lines);
+  RUN_TEST(test_spans_cost);
+  return UNITY_END();
+}
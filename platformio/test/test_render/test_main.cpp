@@ -0,0 +1,364 @@
+/* Heap allocations of a full frame render.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include <unity.h>
+#include "api_response.h"
+#include "battery_utils.h"
+#include "config.h"
+#include "icons/196x196/wifi_x_196x196.h"
+#include "renderer.h"
+#include "render_model.h"
+#if FRAME_DIFF_ACTIVE
+  #include <LittleFS.h>
+#endif
+
+HardwareSerial Serial;
+EspClass ESP;
+SPIClass SPI;
+#if FRAME_DIFF_ACTIVE
+LittleFSFS LittleFS;
+#endif
+
+unsigned long millis()
+{
+  return 0;
+}
+
+unsigned long micros()
+{
+  return 0;
+}
+
+void beginEnergyPhase(energy_phase_t phase)
+{
+}
+
+void endEnergyPhase(energy_phase_t phase)
+{
+}
+
+// malloc(), calloc() and realloc() are replaced with ones that count the
+// calls made while counting is set, operator new and std::string come through
+// them too. glibc only, where the originals can still be called.
+static bool counting = false;
+static unsigned long allocations = 0;
+// while set, allocations of a full 1bpp frame or more fail
+static bool noFrameMemory = false;
+
+#ifdef __GLIBC__
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t n, size_t size);
+extern "C" void *__libc_realloc(void *ptr, size_t size);
+
+extern "C" void *malloc(size_t size)
+{
+  allocations += counting;
+  if (noFrameMemory && size >= (DISP_WIDTH / 8) * DISP_HEIGHT)
+  {
+    return nullptr;
+  }
+  return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t n, size_t size)
+{
+  allocations += counting;
+  return __libc_calloc(n, size);
+}
+
+extern "C" void *realloc(void *ptr, size_t size)
+{
+  allocations += counting;
+  return __libc_realloc(ptr, size);
+}
+#endif
+
+static om_current_t current;
+static om_hourly_t hourly[OM_NUM_HOURLY];
+static om_daily_t daily[OM_NUM_DAILY];
+static om_resp_air_quality_t airQuality;
+static render_model_t model;
+
+void setUp()
+{
+#ifndef __GLIBC__
+  TEST_IGNORE_MESSAGE("allocations are only counted with glibc");
+#endif
+  counting = false;
+  allocations = 0;
+}
+
+void tearDown()
+{
+  counting = false;
+  noFrameMemory = false;
+  psramPresent = true;
+}
+
+/* Fills in the forecast of data set n, each set with other temperatures,
+ * weather, units of text and precipitation.
+ */
+static void fillForecast(int n)
+{
+  const int64_t t0 = 1790000000 + n * 7 * 3600;
+  const int currentCodes[] = {0, 3, 61, 95};
+  const int hourlyCodes[] = {0, 2, 61, 3, 95, 71};
+  const int dailyCodes[] = {0, 2, 61, 3, 95, 71, 45};
+
+  current.temp = -3.4f + n * 7.37f;
+  current.feels_like = current.temp - 2.55f;
+  current.humidity = 40 + n * 13;
+  current.pressure = 995 + n * 11;
+  current.wind_speed = 3.3f + n * 9.1f;
+  current.wind_deg = (n * 97) % 360;
+  current.wind_gust = 12.5f;
+  current.uvi = 0.4f + n * 2.6f;
+  current.visibility = (n == 2) ? 30000 : 1234 + n * 4321;
+  current.weather_code = currentCodes[n];
+  current.is_day = n & 1;
+  for (int i = 0; i < OM_NUM_HOURLY; ++i)
+  {
+    om_hourly_t &h = hourly[i];
+    h.dt = t0 + i * 3600;
+    h.temp = current.temp + 6.f * std::sin(i * 0.26f + n);
+    h.humidity = 50;
+    h.pop = std::fmod(i * 13.f + n * 31.f, 100.f);
+    h.precipitation = (i % 5) * 0.37f * n;
+    h.weather_code = hourlyCodes[(i + n) % 6];
+    h.is_day = (i / 12) & 1;
+  }
+  for (int i = 0; i < OM_NUM_DAILY; ++i)
+  {
+    om_daily_t &d = daily[i];
+    d.dt = t0 + i * 86400;
+    d.temp_min = current.temp - 5.15f + i;
+    d.temp_max = current.temp + 4.45f - i * 0.5f;
+    d.sunrise = t0 - 3 * 3600 + i * 86400;
+    d.sunset = t0 + 8 * 3600 + i * 86400;
+    d.pop = i * 17.f;
+    d.precipitation = i * 1.3f * n;
+    d.weather_code = dailyCodes[(i + n) % 7];
+    d.uvi = 3;
+  }
+  current.sunrise = daily[0].sunrise;
+  current.sunset = daily[0].sunset;
+  airQuality.aqi = 12 + n * 47;
+}
+
+static void test_hook_counts()
+{
+  counting = true;
+  void *volatile ptr = malloc(64);
+  counting = false;
+  free(ptr);
+  TEST_ASSERT_EQUAL(1, allocations);
+}
+
+/* Renders the frame of each data set as main.cpp does, counting the
+ * allocations of the draw calls. Setting up and showing the frame may allocate
+ * its buffers. Every frame is drawn twice in a row, the second time from the
+ * widgets and the background cached by the first, if the configuration caches
+ * them.
+ */
+static void drawFrames()
+{
+  for (int i = 0; i < 8; ++i)
+  {
+    const int n = i / 2;
+    fillForecast(n);
+    const time_t now = hourly[0].dt;
+    tm timeInfo;
+    localtime_r(&now, &timeInfo);
+    const String dateStr = "Friday, October 16";
+    const String statusStr = (n == 0) ? "Connection lost" : "";
+    const String refreshStr = "10:42 AM";
+    buildRenderModel(model, current, hourly, daily, airQuality);
+
+    allocations = 0;
+    int pages = 0;
+    beginFrame();
+#if FRAME_CAPTURE_ACTIVE
+    TEST_ASSERT_EQUAL(!noFrameMemory, display.capture != nullptr);
+#endif
+#if PSRAM_FRAME_ACTIVE
+    TEST_ASSERT_EQUAL(psramFound(), display.frame != nullptr);
+#endif
+#if DISPLAY_LIST_ACTIVE
+    TEST_ASSERT_EQUAL(display.frame == nullptr, display.list != nullptr);
+#endif
+    do
+    {
+      ++pages;
+      counting = true;
+      drawBackground(model);
+      drawCurrentConditions(model, current, airQuality, 21.37f + n, 44.6f);
+      if (onPage(LAYOUT_OUTLOOK_GRAPH))
+      {
+        drawOutlookGraph(model, hourly, timeInfo);
+      }
+      if (onPage(LAYOUT_FORECAST))
+      {
+        drawForecast(model, daily, timeInfo);
+      }
+      if (onPage(LAYOUT_LOCATION_DATE))
+      {
+        drawLocationDate(CITY_STRING, dateStr);
+      }
+      if (onPage(LAYOUT_STATUS_BAR))
+      {
+        drawStatusBar(statusStr, refreshStr, -60 - n * 9, 3900 - n * 150,
+                      12.5f * n);
+      }
+      counting = false;
+    } while (nextFrame());
+    powerOffDisplay();
+    TEST_ASSERT_EQUAL(0, allocations);
+#if FRAME_CAPTURE_ACTIVE
+    TEST_ASSERT_EQUAL(noFrameMemory ? DISP_HEIGHT / display.pageHeight() : 1,
+                      pages);
+#endif
+  }
+}
+
+static void test_frame_draws_without_allocating()
+{
+  drawFrames();
+}
+
+/* Error screens are drawn as a frame too, so that they take one pass when the
+ * configuration draws the frame at once.
+ */
+static void test_error_draws_in_one_pass()
+{
+  int pages = 0;
+  beginFrame();
+  do
+  {
+    ++pages;
+    drawError(wifi_x_196x196, "WiFi Connection Failed");
+  } while (nextFrame());
+  powerOffDisplay();
+  TEST_ASSERT_EQUAL(1, pages);
+}
+
+#if FRAME_CAPTURE_ACTIVE
+/* Without memory for a frame of its own, the frame is drawn into the pages of
+ * the display buffer instead.
+ */
+static void test_frame_draws_without_frame_memory()
+{
+  noFrameMemory = true;
+  drawFrames();
+}
+#endif
+
+#if WIDGET_CACHE_ACTIVE
+/* Draws the forecast of data set 1 into a captured frame with every third row
+ * of its rectangle black beforehand if stripes is set, and copies the
+ * rectangle of the frame into bits.
+ */
+static void drawForecastFrame(bool stripes, uint8_t *bits)
+{
+  const layout_rect_t &r = LAYOUT[LAYOUT_FORECAST];
+  const time_t now = hourly[0].dt;
+  tm timeInfo;
+  localtime_r(&now, &timeInfo);
+  beginFrame();
+  TEST_ASSERT_NOT_NULL(display.capture);
+  for (int y = 0; stripes && y < r.h; y += 3)
+  {
+    display.drawFastHLine(r.x, r.y + y, r.w, GxEPD_BLACK);
+  }
+  drawForecast(model, daily, timeInfo);
+  for (int y = 0; y < r.h; ++y)
+  {
+    memcpy(bits + y * (r.w / 8),
+           display.capture + (r.y + y) * (DISP_WIDTH / 8) + r.x / 8, r.w / 8);
+  }
+  while (nextFrame())
+  {
+  }
+  powerOffDisplay();
+}
+
+/* A widget drawn over black pixels is cached in full, a hit replays all of it
+ * and a miss keeps the pixels underneath.
+ */
+static void test_widget_cached_over_black_pixels()
+{
+  const layout_rect_t &r = LAYOUT[LAYOUT_FORECAST];
+  const size_t size = (r.w / 8) * r.h;
+  uint8_t *widget = static_cast<uint8_t *>(malloc(size));
+  uint8_t *bits = static_cast<uint8_t *>(malloc(size));
+  fillForecast(1);
+  buildRenderModel(model, current, hourly, daily, airQuality);
+
+  LittleFS.remove("/widget_forecast.bin");
+  drawForecastFrame(false, widget);
+
+  LittleFS.remove("/widget_forecast.bin");
+  drawForecastFrame(true, bits);
+  int covered = 0;
+  for (int y = 0; y < r.h; ++y)
+  {
+    for (int b = 0; b < r.w / 8; ++b)
+    {
+      const size_t i = y * (r.w / 8) + b;
+      const uint8_t under = (y % 3 == 0) ? 0x00 : 0xFF;
+      TEST_ASSERT_EQUAL_HEX8(widget[i] & under, bits[i]);
+      covered += (y % 3 == 0) && widget[i] != 0xFF;
+    }
+  }
+  // some of the widget was drawn over the stripes
+  TEST_ASSERT_GREATER_THAN(0, covered);
+
+  TEST_ASSERT_TRUE(LittleFS.exists("/widget_forecast.bin"));
+  drawForecastFrame(false, bits);
+  TEST_ASSERT_EQUAL_MEMORY(widget, bits, size);
+  free(widget);
+  free(bits);
+}
+#endif
+
+#if PSRAM_FRAME_ACTIVE
+/* Without PSRAM the frame is drawn into a display list or in pages instead.
+ */
+static void test_frame_draws_without_psram()
+{
+  psramPresent = false;
+  drawFrames();
+}
+#endif
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_hook_counts);
+  RUN_TEST(test_frame_draws_without_allocating);
+  RUN_TEST(test_error_draws_in_one_pass);
+#if FRAME_CAPTURE_ACTIVE
+  RUN_TEST(test_frame_draws_without_frame_memory);
+#endif
+#if WIDGET_CACHE_ACTIVE
+  RUN_TEST(test_widget_cached_over_black_pixels);
+#endif
+#if PSRAM_FRAME_ACTIVE
+  RUN_TEST(test_frame_draws_without_psram);
+#endif
+  return UNITY_END();
+}
@@ -0,0 +1,179 @@
+/* Unit tests for the text formatting.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <unity.h>
+#include "rnd.h"
+#include "text_format.h"
+
+static char buf[48];
+static char expected[48];
+
+void setUp()
+{
+  rndSeed(1);
+  buf[0] = '\0';
+}
+
+void tearDown()
+{
+}
+
+/* Checks appendFixed() against printf(), which rounds the float exactly with
+ * ties to even too.
+ */
+static void checkFixed(float value, uint8_t decimals)
+{
+  buf[0] = '\0';
+  const size_t len = appendFixed(buf, sizeof(buf), value, decimals);
+  snprintf(expected, sizeof(expected), "%.*f", decimals,
+           static_cast<double>(value));
+  // no sign when it rounds to zero
+  const char *e = expected;
+  if (e[0] == '-' && strspn(e + 1, "0.") == strlen(e + 1))
+  {
+    ++e;
+  }
+  TEST_ASSERT_EQUAL_STRING(e, buf);
+  TEST_ASSERT_EQUAL(strlen(e), len);
+}
+
+static void test_append_str()
+{
+  TEST_ASSERT_EQUAL(5, appendStr(buf, sizeof(buf), "Wind "));
+  TEST_ASSERT_EQUAL(11, appendStr(buf, sizeof(buf), "12 mph"));
+  TEST_ASSERT_EQUAL_STRING("Wind 12 mph", buf);
+  TEST_ASSERT_EQUAL(11, appendStr(buf, sizeof(buf), ""));
+}
+
+static void test_append_truncates()
+{
+  char small[6] = "";
+  TEST_ASSERT_EQUAL(3, appendStr(small, sizeof(small), "abc"));
+  TEST_ASSERT_EQUAL(5, appendStr(small, sizeof(small), "defgh"));
+  TEST_ASSERT_EQUAL_STRING("abcde", small);
+  TEST_ASSERT_EQUAL(5, appendInt(small, sizeof(small), 7));
+  TEST_ASSERT_EQUAL(5, appendFixed(small, sizeof(small), 1.5f, 1));
+  TEST_ASSERT_EQUAL_STRING("abcde", small);
+  small[0] = '\0';
+  TEST_ASSERT_EQUAL(5, appendInt(small, sizeof(small), -123456));
+  TEST_ASSERT_EQUAL_STRING("-1234", small);
+}
+
+static void test_append_int()
+{
+  const long values[] = {0, 1, -1, 9, 10, -10, 99, 100, 1013, -40, 65535,
+                         LONG_MAX, LONG_MIN};
+  for (long v : values)
+  {
+    buf[0] = '\0';
+    snprintf(expected, sizeof(expected), "%ld", v);
+    TEST_ASSERT_EQUAL(strlen(expected), appendInt(buf, sizeof(buf), v));
+    TEST_ASSERT_EQUAL_STRING(expected, buf);
+  }
+}
+
+static void test_fixed_values()
+{
+  buf[0] = '\0';
+  appendFixed(buf, sizeof(buf), 29.92f, 2);
+  TEST_ASSERT_EQUAL_STRING("29.92", buf);
+  buf[0] = '\0';
+  appendFixed(buf, sizeof(buf), -3.46f, 1);
+  TEST_ASSERT_EQUAL_STRING("-3.5", buf);
+  buf[0] = '\0';
+  appendFixed(buf, sizeof(buf), 7.f, 0);
+  TEST_ASSERT_EQUAL_STRING("7", buf);
+  // -0.04 rounds to zero and has no sign
+  buf[0] = '\0';
+  appendFixed(buf, sizeof(buf), -0.04f, 1);
+  TEST_ASSERT_EQUAL_STRING("0.0", buf);
+  buf[0] = '\0';
+  appendFixed(buf, sizeof(buf), -0.f, 0);
+  TEST_ASSERT_EQUAL_STRING("0", buf);
+}
+
+static void test_fixed_ties_to_even()
+{
+  // exact in binary, so these are ties
+  checkFixed(0.5f, 0);
+  checkFixed(1.5f, 0);
+  checkFixed(2.5f, 0);
+  checkFixed(-2.5f, 0);
+  checkFixed(0.125f, 2);
+  checkFixed(0.375f, 2);
+  checkFixed(1023.5f, 0);
+  buf[0] = '\0';
+  appendFixed(buf, sizeof(buf), 2.5f, 0);
+  TEST_ASSERT_EQUAL_STRING("2", buf);
+}
+
+static void test_fixed_special()
+{
+  appendFixed(buf, sizeof(buf), NAN, 1);
+  TEST_ASSERT_EQUAL_STRING("nan", buf);
+  buf[0] = '\0';
+  appendFixed(buf, sizeof(buf), INFINITY, 1);
+  TEST_ASSERT_EQUAL_STRING("inf", buf);
+  buf[0] = '\0';
+  appendFixed(buf, sizeof(buf), -INFINITY, 1);
+  TEST_ASSERT_EQUAL_STRING("-inf", buf);
+  // subnormal
+  checkFixed(1e-40f, 6);
+  checkFixed(-1e-40f, 0);
+}
+
+static void test_fixed_matches_printf()
+{
+  for (int i = 0; i < 200000; ++i)
+  {
+    // random magnitudes up to 2^31, and random bits of the mantissa
+    const int exponent = rnd() % 60 - 28;
+    const float mantissa = (rnd() & 0xFFFFFF) / static_cast<float>(1 << 24);
+    float value = std::ldexp(1.f + mantissa, exponent);
+    if (rnd() & 1)
+    {
+      value = -value;
+    }
+    checkFixed(value, rnd() % 7);
+  }
+  // hundredths as the sensors and the API give them
+  for (int i = -100000; i <= 100000; i += 7)
+  {
+    const float value = i / 100.f;
+    for (uint8_t decimals = 0; decimals <= 2; ++decimals)
+    {
+      checkFixed(value, decimals);
+    }
+  }
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_append_str);
+  RUN_TEST(test_append_truncates);
+  RUN_TEST(test_append_int);
+  RUN_TEST(test_fixed_values);
+  RUN_TEST(test_fixed_ties_to_even);
+  RUN_TEST(test_fixed_special);
+  RUN_TEST(test_fixed_matches_printf);
+  return UNITY_END();
+}
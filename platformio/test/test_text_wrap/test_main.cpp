@@ -0,0 +1,369 @@
+/* Unit tests for line wrapping.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <unity.h>
+#include <Adafruit_GFX.h>
+#include "rnd.h"
+#include "text_metrics.h"
+#include "text_wrap.h"
+#include "fonts/FreeSans/FreeSans_6pt8b.h"
+#include "fonts/FreeSans/FreeSans_9pt8b.h"
+#include "fonts/FreeSans/FreeSans_12pt8b.h"
+#include "fonts/FreeSans/FreeSans_16pt8b.h"
+#include "fonts/Lato_Regular/Lato_Regular_12pt8b.h"
+
+// lines drawn of the generated texts
+#define MAX_LINES 4
+// generated texts of each font
+#define NUM_TEXTS 4000
+
+// Monospaced font: printable chars are 5px wide with 1px of bearing on either
+// side, the space is empty and 4px wide.
+static GFXglyph glyphs[95];
+static GFXfont font = {nullptr, glyphs, 32, 126, 12};
+
+/* A display that only measures text, as getStringWidth() did with the
+ * renderer's display.
+ */
+class MeasureGfx : public Adafruit_GFX
+{
+public:
+  MeasureGfx() : Adafruit_GFX(800, 480)
+  {
+    setTextWrap(false);
+  }
+
+  void drawPixel(int16_t, int16_t, uint16_t) override {}
+};
+
+static MeasureGfx gfx;
+
+void setUp()
+{
+  rndSeed(1);
+  for (GFXglyph &g : glyphs)
+  {
+    g = {0, 5, 8, 7, 1, -8};
+  }
+  glyphs[0] = {0, 0, 0, 4, 0, 0};
+}
+
+void tearDown()
+{
+}
+
+static uint16_t widthOf(const char *text)
+{
+  return fontTextWidth(&font, text, strlen(text));
+}
+
+/* Wraps text and checks the line and where the next one starts.
+ */
+static void assertWrap(const char *text, uint16_t maxWidth, bool lastLine,
+                       size_t len, bool ellipsis, size_t next)
+{
+  text_line_t line;
+  TEST_ASSERT_EQUAL(next, wrapLine(&font, text, strlen(text), maxWidth,
+                                   lastLine, line));
+  TEST_ASSERT_EQUAL(len, line.len);
+  TEST_ASSERT_EQUAL(ellipsis, line.ellipsis);
+  char shown[64] = {};
+  memcpy(shown, text, len);
+  if (ellipsis)
+  {
+    strcat(shown, "...");
+  }
+  TEST_ASSERT_EQUAL(widthOf(shown), line.w);
+}
+
+static void test_metrics()
+{
+  // 5 glyphs, 7px apart, without the bearing of the first and last
+  TEST_ASSERT_EQUAL(33, widthOf("Light"));
+  TEST_ASSERT_EQUAL(0, widthOf(""));
+  // the empty space still counts up to where it starts
+  TEST_ASSERT_EQUAL(34, widthOf("Light "));
+}
+
+static void test_all_of_it_fits()
+{
+  assertWrap("Light rain", 200, false, 10, false, 10);
+  assertWrap("Light rain", widthOf("Light rain"), true, 10, false, 10);
+}
+
+static void test_break_at_last_space_that_fits()
+{
+  const char *text = "Light rain showers";
+  assertWrap(text, widthOf("Light rain"), false, 10, false, 11);
+  assertWrap(text, widthOf("Light rain s"), false, 10, false, 11);
+  assertWrap(text, widthOf("Light rain") - 1, false, 5, false, 6);
+}
+
+static void test_break_after_dash()
+{
+  const char *text = "Thunder-storms likely";
+  assertWrap(text, widthOf("Thunder-"), false, 8, false, 8);
+  assertWrap(text, widthOf("Thunder-storms"), false, 14, false, 15);
+}
+
+static void test_last_line_ellipsis()
+{
+  const char *text = "Light rain showers";
+  assertWrap(text, widthOf("Light rain..."), true, 10, true, 11);
+  // "Light rain..." is too wide, the ellipsis is kept
+  assertWrap(text, widthOf("Light rain"), true, 5, true, 6);
+}
+
+static void test_last_line_does_not_break_at_dash()
+{
+  // no break fits, so the line breaks at the first space
+  assertWrap("Thunder-storms likely", widthOf("Thunder-"), true,
+             14, false, 15);
+}
+
+static void test_nothing_fits()
+{
+  // broken at the first space, wider than max_width
+  assertWrap("Supercalifragilistic word", 20, false, 20, false, 21);
+  assertWrap("Over-whelming", 10, false, 4, false, 5);
+  // no break at all, all of it
+  assertWrap("Supercalifragilistic", 20, false, 20, false, 20);
+}
+
+static void test_wraps_a_paragraph()
+{
+  // successive lines of an alert, as the renderer draws them
+  const char *text = "Wind advisory in effect until Tuesday evening at 6 PM";
+  const uint16_t maxWidth = widthOf("Wind advisory in");
+  const char *expected[] = {"Wind advisory in", "effect until", "Tuesday..."};
+  size_t start = 0;
+  for (int i = 0; i < 3; ++i)
+  {
+    text_line_t line;
+    const size_t next = wrapLine(&font, text + start, strlen(text + start),
+                                 maxWidth, i == 2, line);
+    char shown[64] = {};
+    memcpy(shown, text + start, line.len);
+    if (line.ellipsis)
+    {
+      strcat(shown, "...");
+    }
+    TEST_ASSERT_EQUAL_STRING(expected[i], shown);
+    TEST_ASSERT_LESS_OR_EQUAL(maxWidth, line.w);
+    start += next;
+  }
+}
+
+static uint16_t gfxWidth(const std::string &text)
+{
+  int16_t x1, y1;
+  uint16_t w, h;
+  gfx.getTextBounds(text.c_str(), 0, 0, &x1, &y1, &w, &h);
+  return w;
+}
+
+// String::lastIndexOf()
+static int lastIndexOf(const std::string &text, char c)
+{
+  const size_t i = text.rfind(c);
+  return (i == std::string::npos) ? -1 : static_cast<int>(i);
+}
+
+/* The lines drawMultiLnString() drew before wrapLine(), its loop ported from
+ * String to std::string as it was: the remaining text and every candidate
+ * line are copied and measured again. Returns the number of lines, their text
+ * and the width drawString() aligned them with.
+ */
+static uint16_t oldLines(const std::string &text, uint16_t max_width,
+                         uint16_t max_lines, std::string *lines,
+                         uint16_t *widths)
+{
+  uint16_t current_line = 0;
+  std::string textRemaining = text;
+  // print until we reach max_lines or no more text remains
+  while (current_line < max_lines && !textRemaining.empty())
+  {
+    uint16_t w = gfxWidth(textRemaining);
+
+    int endIndex = textRemaining.length();
+    // check if remaining text is to wide, if it is then print what we can
+    std::string subStr = textRemaining;
+    int splitAt = 0;
+    int keepLastChar = 0;
+    while (w > max_width && splitAt != -1)
+    {
+      if (keepLastChar)
+      {
+        subStr.erase(subStr.length() - 1);
+      }
+
+      // find the last place in the string that we can break it.
+      if (current_line < max_lines - 1)
+      {
+        splitAt = std::max(lastIndexOf(subStr, ' '), lastIndexOf(subStr, '-'));
+      }
+      else
+      {
+        // this is the last line, only break at spaces so we can add ellipsis
+        splitAt = lastIndexOf(subStr, ' ');
+      }
+
+      if (splitAt != -1)
+      {
+        endIndex = splitAt;
+        subStr = subStr.substr(0, endIndex + 1);
+
+        char lastChar = subStr[endIndex];
+        if (lastChar == ' ')
+        {
+          keepLastChar = 0;
+          subStr.erase(endIndex);
+          --endIndex;
+        }
+        else if (lastChar == '-')
+        {
+          keepLastChar = 1;
+        }
+
+        if (current_line < max_lines - 1)
+        {
+          w = gfxWidth(subStr);
+        }
+        else
+        {
+          w = gfxWidth(subStr + "...");
+          if (w <= max_width)
+          {
+            subStr = subStr + "...";
+          }
+        }
+      } // end if (splitAt != -1)
+    } // end inner while
+
+    lines[current_line] = subStr;
+    widths[current_line] = gfxWidth(subStr);
+
+    // String::substring() is empty from past the end
+    const size_t from = endIndex + 2 - keepLastChar;
+    textRemaining = (from < textRemaining.length())
+                    ? textRemaining.substr(from) : std::string();
+
+    ++current_line;
+  } // end outer while
+  return current_line;
+}
+
+/* The lines drawMultiLnString() draws with wrapLine(), and their widths.
+ */
+static uint16_t newLines(const GFXfont *f, const std::string &text,
+                         uint16_t max_width, uint16_t max_lines,
+                         std::string *lines, uint16_t *widths)
+{
+  const char *textRemaining = text.c_str();
+  size_t lenRemaining = text.length();
+  uint16_t current_line = 0;
+  for (; current_line < max_lines && lenRemaining > 0; ++current_line)
+  {
+    text_line_t line;
+    const size_t next = wrapLine(f, textRemaining, lenRemaining, max_width,
+                                 current_line == max_lines - 1, line);
+    lines[current_line].assign(textRemaining, line.len);
+    if (line.ellipsis)
+    {
+      lines[current_line] += "...";
+    }
+    widths[current_line] = line.w;
+    textRemaining += next;
+    lenRemaining -= next;
+  }
+  return current_line;
+}
+
+/* Makes a text of weather words, numbers, dashes, double spaces and words too
+ * long for a line.
+ */
+static std::string randomText()
+{
+  static const char *const words[] = {
+    "Light", "rain", "showers", "Thunderstorms", "likely", "in", "the",
+    "afternoon", "Wind", "advisory", "until", "6", "PM", "-12", "km/h",
+    "Partly", "cloudy", "a", "Supercalifragilistic", "north-west",
+    "Over-whelming", "heat", "Fog.", "-", "--", "hPa", "UV"
+  };
+  static const char *const separators[] = {" ", " ", " ", " ", "  ", "-",
+                                           " - "};
+  std::string text;
+  const int n = 1 + rnd() % 16;
+  for (int i = 0; i < n; ++i)
+  {
+    if (i > 0)
+    {
+      text += separators[rnd() % (sizeof(separators) / sizeof(separators[0]))];
+    }
+    text += words[rnd() % (sizeof(words) / sizeof(words[0]))];
+  }
+  if (rnd() % 8 == 0)
+  {
+    text += ' ';
+  }
+  return text;
+}
+
+static void test_same_lines_as_before()
+{
+  static const GFXfont *const fonts[] = {&FreeSans_6pt8b, &FreeSans_9pt8b,
+                                         &FreeSans_12pt8b, &FreeSans_16pt8b,
+                                         &Lato_Regular_12pt8b};
+  std::string before[MAX_LINES], after[MAX_LINES];
+  uint16_t beforeW[MAX_LINES], afterW[MAX_LINES];
+  for (const GFXfont *f : fonts)
+  {
+    gfx.setFont(f);
+    for (int t = 0; t < NUM_TEXTS; ++t)
+    {
+      const std::string text = randomText();
+      const uint16_t maxWidth = 20 + rnd() % 380;
+      const uint16_t maxLines = 1 + rnd() % MAX_LINES;
+      const uint16_t n = oldLines(text, maxWidth, maxLines, before, beforeW);
+      TEST_ASSERT_EQUAL(n, newLines(f, text, maxWidth, maxLines, after,
+                                    afterW));
+      for (uint16_t i = 0; i < n; ++i)
+      {
+        TEST_ASSERT_EQUAL_STRING(before[i].c_str(), after[i].c_str());
+        TEST_ASSERT_EQUAL(beforeW[i], afterW[i]);
+      }
+    }
+  }
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_metrics);
+  RUN_TEST(test_all_of_it_fits);
+  RUN_TEST(test_break_at_last_space_that_fits);
+  RUN_TEST(test_break_after_dash);
+  RUN_TEST(test_last_line_ellipsis);
+  RUN_TEST(test_last_line_does_not_break_at_dash);
+  RUN_TEST(test_nothing_fits);
+  RUN_TEST(test_wraps_a_paragraph);
+  RUN_TEST(test_same_lines_as_before);
+  return UNITY_END();
+}
@@ -0,0 +1,226 @@
+/* Unit tests for the unit policies.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+#include <unity.h>
+#include "battery_utils.h"
+#include "units.h"
+
+// what the renderer, built along in this environment, takes from the Arduino
+// core and from main
+HardwareSerial Serial;
+EspClass ESP;
+SPIClass SPI;
+
+unsigned long millis()
+{
+  return 0;
+}
+
+unsigned long micros()
+{
+  return 0;
+}
+
+void beginEnergyPhase(energy_phase_t phase)
+{
+}
+
+void endEnergyPhase(energy_phase_t phase)
+{
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+/* Checks what Unit makes of value: the converted value, the decimals it is
+ * shown with and how appendUnits() shows it.
+ */
+template<class Unit, class T>
+static void assertValue(const T &value, float converted, int decimals,
+                        const char *shown)
+{
+  TEST_ASSERT_FLOAT_WITHIN(std::fabs(converted) * 1e-4f + 1e-4f, converted,
+                           Unit::convert(value));
+  TEST_ASSERT_EQUAL(decimals, Unit::decimals);
+  char buf[32] = {};
+  appendUnits<Unit>(buf, sizeof(buf), Unit::convert(value));
+  TEST_ASSERT_EQUAL_STRING(shown, buf);
+}
+
+/* Checks the label of Unit, as appendUnitLabel() appends it.
+ */
+template<class Unit>
+static void assertLabel(const char *label, const char *appended)
+{
+  TEST_ASSERT_EQUAL_STRING(label, Unit::label());
+  char buf[32] = {};
+  appendUnitLabel<Unit>(buf, sizeof(buf));
+  TEST_ASSERT_EQUAL_STRING(appended, buf);
+}
+
+static void test_temperature()
+{
+  assertValue<TempKelvin>(21.46f, 294.61f, 1, "294.6");
+  assertValue<TempCelsius>(21.46f, 21.46f, 1, "21.5");
+  assertValue<TempFahrenheit>(21.46f, 70.628f, 0, "71");
+  TEST_ASSERT_EQUAL_STRING("K", TempKelvin::label());
+  TEST_ASSERT_EQUAL_STRING("\260C", TempCelsius::label());
+  TEST_ASSERT_EQUAL_STRING("\260F", TempFahrenheit::label());
+  TEST_ASSERT_EQUAL_STRING("", TempKelvin::symbol());
+  TEST_ASSERT_EQUAL_STRING("\260", TempCelsius::symbol());
+  TEST_ASSERT_EQUAL_STRING("\260", TempFahrenheit::symbol());
+}
+
+static void test_speed()
+{
+  assertValue<SpeedMetersPerSecond>(36.f, 10.f, 0, "10");
+  assertValue<SpeedFeetPerSecond>(36.f, 32.807f, 0, "33");
+  assertValue<SpeedKilometersPerHour>(36.f, 36.f, 0, "36");
+  assertValue<SpeedMilesPerHour>(36.f, 22.37f, 0, "22");
+  assertValue<SpeedKnots>(36.f, 19.44f, 0, "19");
+  assertValue<SpeedBeaufort>(36.f, 5.f, 0, "5");
+  assertValue<SpeedBeaufort>(0.5f, 0.f, 0, "0");
+  assertValue<SpeedBeaufort>(150.f, 12.f, 0, "12");
+  assertLabel<SpeedMetersPerSecond>("m/s", " m/s");
+  assertLabel<SpeedFeetPerSecond>("ft/s", " ft/s");
+  assertLabel<SpeedKilometersPerHour>("km/h", " km/h");
+  assertLabel<SpeedMilesPerHour>("mph", " mph");
+  assertLabel<SpeedKnots>("kt", " kt");
+  assertLabel<SpeedBeaufort>("", " ");
+}
+
+static void test_pressure()
+{
+  assertValue<PresHectopascals>(1013.25f, 1013.25f, 0, "1013");
+  assertValue<PresPascals>(1013.25f, 101325.f, 0, "101325");
+  assertValue<PresMillimetersOfMercury>(1013.25f, 760.06f, 0, "760");
+  assertValue<PresInchesOfMercury>(1013.25f, 29.921f, 1, "29.9");
+  assertValue<PresMillibars>(1013.25f, 1013.25f, 0, "1013");
+  assertValue<PresAtmospheres>(1013.25f, 1.0f, 3, "1.000");
+  assertValue<PresGramsPerSquareCentimeter>(1013.25f, 1033.5f, 0, "1034");
+  assertValue<PresPoundsPerSquareInch>(1013.25f, 14.692f, 2, "14.69");
+  assertLabel<PresHectopascals>("hPa", " hPa");
+  assertLabel<PresPascals>("Pa", " Pa");
+  assertLabel<PresMillimetersOfMercury>("mmHg", " mmHg");
+  assertLabel<PresInchesOfMercury>("inHg", " inHg");
+  assertLabel<PresMillibars>("mbar", " mbar");
+  assertLabel<PresAtmospheres>("atm", " atm");
+  assertLabel<PresGramsPerSquareCentimeter>("g/cm\262", " g/cm\262");
+  assertLabel<PresPoundsPerSquareInch>("lb/in\262", " lb/in\262");
+}
+
+static void test_distance()
+{
+  TEST_ASSERT_EQUAL_FLOAT(8.f, DistKilometers::convert(8000.f));
+  TEST_ASSERT_EQUAL_FLOAT(4.9712f, DistMiles::convert(8000.f));
+  // Open-Meteo's cap, in each unit
+  TEST_ASSERT_EQUAL_FLOAT(10.f, DistKilometers::cap);
+  TEST_ASSERT_EQUAL_FLOAT(6.f, DistMiles::cap);
+  assertLabel<DistKilometers>("km", " km");
+  assertLabel<DistMiles>("mi", " mi");
+}
+
+static void test_hourly_precipitation()
+{
+  om_hourly_t hour = {};
+  hour.pop = 40.f;
+  hour.precipitation = 3.2f;
+  assertValue<HourlyPrecipPop>(hour, 40.f, 0, "40");
+  assertValue<HourlyPrecipMillimeters>(hour, 3.2f, 2, "3.20");
+  assertValue<HourlyPrecipCentimeters>(hour, 0.32f, 3, "0.320");
+  assertValue<HourlyPrecipInches>(hour, 0.126f, 3, "0.126");
+  assertLabel<HourlyPrecipPop>("%", "%");
+  assertLabel<HourlyPrecipMillimeters>("mm", " mm");
+  assertLabel<HourlyPrecipCentimeters>("cm", " cm");
+  assertLabel<HourlyPrecipInches>("in", " in");
+}
+
+static void test_precipitation_axis()
+{
+  // any chance of rain shows the whole 0 to 100 % axis
+  TEST_ASSERT_EQUAL_FLOAT(100.f, HourlyPrecipPop::axisMax(5.f));
+  TEST_ASSERT_EQUAL_FLOAT(0.f, HourlyPrecipPop::axisMax(0.f));
+  TEST_ASSERT_EQUAL(0, HourlyPrecipPop::tickDecimals(100.f));
+  TEST_ASSERT_EQUAL(23, HourlyPrecipPop::labelWidth(100.f));
+
+  // whole mm, 1 decimal below 10 mm
+  TEST_ASSERT_EQUAL_FLOAT(4.f, HourlyPrecipMillimeters::axisMax(3.2f));
+  TEST_ASSERT_EQUAL_FLOAT(0.f, HourlyPrecipMillimeters::axisMax(0.f));
+  TEST_ASSERT_EQUAL(1, HourlyPrecipMillimeters::tickDecimals(4.f));
+  TEST_ASSERT_EQUAL(0, HourlyPrecipMillimeters::tickDecimals(12.f));
+  TEST_ASSERT_EQUAL(24, HourlyPrecipMillimeters::labelWidth(4.f));
+
+  // tenths of a cm, 2 decimals below 1 cm and 1 below 10 cm
+  TEST_ASSERT_EQUAL_FLOAT(0.4f, HourlyPrecipCentimeters::axisMax(0.32f));
+  TEST_ASSERT_EQUAL_FLOAT(1.3f, HourlyPrecipCentimeters::axisMax(1.21f));
+  TEST_ASSERT_EQUAL(2, HourlyPrecipCentimeters::tickDecimals(0.4f));
+  TEST_ASSERT_EQUAL(1, HourlyPrecipCentimeters::tickDecimals(1.3f));
+  TEST_ASSERT_EQUAL(0, HourlyPrecipCentimeters::tickDecimals(12.f));
+  TEST_ASSERT_EQUAL(31, HourlyPrecipCentimeters::labelWidth(0.4f));
+  TEST_ASSERT_EQUAL(25, HourlyPrecipCentimeters::labelWidth(0.f));
+  TEST_ASSERT_EQUAL(25, HourlyPrecipCentimeters::labelWidth(1.3f));
+
+  // tenths of an inch, like cm
+  TEST_ASSERT_EQUAL_FLOAT(0.2f, HourlyPrecipInches::axisMax(0.126f));
+  TEST_ASSERT_EQUAL(2, HourlyPrecipInches::tickDecimals(0.2f));
+  TEST_ASSERT_EQUAL(1, HourlyPrecipInches::tickDecimals(2.f));
+  TEST_ASSERT_EQUAL(0, HourlyPrecipInches::tickDecimals(10.f));
+  TEST_ASSERT_EQUAL(25, HourlyPrecipInches::labelWidth(0.2f));
+}
+
+static void test_daily_precipitation()
+{
+  om_daily_t day = {};
+  day.pop = 70.f;
+  day.precipitation = 12.7f;
+  assertValue<DailyPrecipPop>(day, 70.f, 0, "70");
+  assertValue<DailyPrecipMillimeters>(day, 12.7f, 0, "13");
+  assertValue<DailyPrecipCentimeters>(day, 1.27f, 1, "1.3");
+  assertValue<DailyPrecipInches>(day, 0.5f, 1, "0.5");
+  assertLabel<DailyPrecipPop>("%", "%");
+  assertLabel<DailyPrecipMillimeters>("mm", " mm");
+  assertLabel<DailyPrecipCentimeters>("cm", " cm");
+  assertLabel<DailyPrecipInches>("in", " in");
+}
+
+static void test_round_units()
+{
+  TEST_ASSERT_EQUAL_FLOAT(29.9f, roundUnits<PresInchesOfMercury>(29.94f));
+  TEST_ASSERT_EQUAL_FLOAT(14.69f, roundUnits<PresPoundsPerSquareInch>(14.694f));
+  TEST_ASSERT_EQUAL_FLOAT(71.f, roundUnits<TempFahrenheit>(70.628f));
+  TEST_ASSERT_EQUAL_FLOAT(-2.f, roundUnits<SpeedKnots>(-1.5f));
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_temperature);
+  RUN_TEST(test_speed);
+  RUN_TEST(test_pressure);
+  RUN_TEST(test_distance);
+  RUN_TEST(test_hourly_precipitation);
+  RUN_TEST(test_precipitation_axis);
+  RUN_TEST(test_daily_precipitation);
+  RUN_TEST(test_round_units);
+  return UNITY_END();
+}
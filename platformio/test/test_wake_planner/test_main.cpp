@@ -0,0 +1,203 @@
+/* Unit tests for the wake planner.
+ * Copyright (C) 2026  Anthony Fenzl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <unity.h>
+#include "wake_planner.h"
+
+#define T0     1773446400   // 2026-03-14T00:00Z
+#define MINUTE 60
+#define HOUR   3600
+#define DAY    86400
+
+// Recorded forecast, UTC: overcast night, sunrise at 05:18, rain from 17:00 to
+// 20:00 and sunset at 17:05, then a clear second day.
+// dt, temp, humidity, pop, precipitation, weather_code, is_day
+static const om_hourly_t HOURLY[OM_NUM_HOURLY] = {
+  {T0 +  0 * HOUR,  2.9f, 88,  0.0f, 0.0f,  3, 0},
+  {T0 +  1 * HOUR,  2.7f, 89,  0.0f, 0.0f,  3, 0},
+  {T0 +  2 * HOUR,  2.4f, 90,  0.0f, 0.0f,  3, 0},
+  {T0 +  3 * HOUR,  2.2f, 91,  0.0f, 0.0f,  3, 0},
+  {T0 +  4 * HOUR,  2.0f, 92,  0.0f, 0.0f,  3, 0},
+  {T0 +  5 * HOUR,  1.8f, 93,  0.0f, 0.0f,  3, 0},
+  {T0 +  6 * HOUR,  1.9f, 93,  0.0f, 0.0f,  3, 1},
+  {T0 +  7 * HOUR,  2.6f, 90,  0.0f, 0.0f,  3, 1},
+  {T0 +  8 * HOUR,  3.8f, 85,  3.0f, 0.0f,  3, 1},
+  {T0 +  9 * HOUR,  5.1f, 79,  5.0f, 0.0f,  2, 1},
+  {T0 + 10 * HOUR,  6.3f, 73,  5.0f, 0.0f,  2, 1},
+  {T0 + 11 * HOUR,  7.4f, 68,  8.0f, 0.0f,  2, 1},
+  {T0 + 12 * HOUR,  8.2f, 64, 10.0f, 0.0f,  2, 1},
+  {T0 + 13 * HOUR,  8.8f, 62, 15.0f, 0.0f,  2, 1},
+  {T0 + 14 * HOUR,  8.7f, 63, 25.0f, 0.0f,  2, 1},
+  {T0 + 15 * HOUR,  8.4f, 66, 40.0f, 0.0f,  2, 1},
+  {T0 + 16 * HOUR,  8.0f, 70, 45.0f, 0.0f,  2, 1},
+  {T0 + 17 * HOUR,  7.4f, 78, 70.0f, 0.3f, 61, 1},
+  {T0 + 18 * HOUR,  6.5f, 86, 85.0f, 1.2f, 63, 0},
+  {T0 + 19 * HOUR,  5.9f, 90, 60.0f, 0.6f, 61, 0},
+  {T0 + 20 * HOUR,  5.3f, 91, 30.0f, 0.1f, 51, 0},
+  {T0 + 21 * HOUR,  4.8f, 92, 15.0f, 0.0f,  3, 0},
+  {T0 + 22 * HOUR,  4.4f, 92,  5.0f, 0.0f,  3, 0},
+  {T0 + 23 * HOUR,  3.9f, 93,  3.0f, 0.0f,  3, 0},
+  {T0 + 24 * HOUR,  3.5f, 93,  0.0f, 0.0f,  3, 0},
+  {T0 + 25 * HOUR,  3.2f, 94,  0.0f, 0.0f,  3, 0},
+  {T0 + 26 * HOUR,  3.0f, 94,  0.0f, 0.0f,  3, 0},
+  {T0 + 27 * HOUR,  2.8f, 95,  0.0f, 0.0f,  3, 0},
+  {T0 + 28 * HOUR,  2.7f, 95,  0.0f, 0.0f,  3, 0},
+  {T0 + 29 * HOUR,  2.6f, 95,  0.0f, 0.0f,  3, 0},
+  {T0 + 30 * HOUR,  2.8f, 94,  0.0f, 0.0f,  3, 1},
+  {T0 + 31 * HOUR,  3.4f, 91,  0.0f, 0.0f,  3, 1},
+  {T0 + 32 * HOUR,  4.6f, 85,  0.0f, 0.0f,  2, 1},
+  {T0 + 33 * HOUR,  6.0f, 78,  0.0f, 0.0f,  2, 1},
+  {T0 + 34 * HOUR,  7.3f, 71,  0.0f, 0.0f,  2, 1},
+  {T0 + 35 * HOUR,  8.5f, 65,  0.0f, 0.0f,  2, 1},
+  {T0 + 36 * HOUR,  9.4f, 61,  0.0f, 0.0f,  1, 1},
+  {T0 + 37 * HOUR, 10.1f, 58,  0.0f, 0.0f,  1, 1},
+  {T0 + 38 * HOUR, 10.4f, 57,  0.0f, 0.0f,  1, 1},
+  {T0 + 39 * HOUR, 10.2f, 58,  0.0f, 0.0f,  1, 1},
+  {T0 + 40 * HOUR,  9.7f, 61,  0.0f, 0.0f,  1, 1},
+  {T0 + 41 * HOUR,  8.9f, 66,  0.0f, 0.0f,  1, 1},
+  {T0 + 42 * HOUR,  7.8f, 72,  0.0f, 0.0f,  0, 0},
+  {T0 + 43 * HOUR,  6.9f, 77,  0.0f, 0.0f,  0, 0},
+  {T0 + 44 * HOUR,  6.2f, 81,  0.0f, 0.0f,  0, 0},
+  {T0 + 45 * HOUR,  5.7f, 83,  0.0f, 0.0f,  0, 0},
+  {T0 + 46 * HOUR,  5.3f, 85,  0.0f, 0.0f,  0, 0},
+  {T0 + 47 * HOUR,  5.0f, 86,  0.0f, 0.0f,  0, 0},
+};
+
+static om_daily_t daily[OM_NUM_DAILY];
+
+void setUp()
+{
+  for (int i = 0; i < OM_NUM_DAILY; ++i)
+  {
+    daily[i] = {};
+    daily[i].dt      = T0 + i * DAY + 12 * HOUR;
+    daily[i].sunrise = T0 + i * DAY + 5 * HOUR + (18 - 2 * i) * MINUTE;
+    daily[i].sunset  = T0 + i * DAY + 17 * HOUR + (5 + 2 * i) * MINUTE;
+  }
+}
+
+void tearDown()
+{
+}
+
+/* Plans from 10 minutes past hour.
+ */
+static wake_plan_t planFrom(int hour, int64_t minSeconds, int64_t maxSeconds)
+{
+  return planNextWake(HOURLY, daily, T0 + hour * HOUR + 10 * MINUTE,
+                      minSeconds, maxSeconds);
+}
+
+static void test_sunrise_before_day_icon()
+{
+  const wake_plan_t plan = planFrom(0, 5 * MINUTE, 12 * HOUR);
+  TEST_ASSERT_EQUAL(WAKE_EVENT_SUN, plan.event);
+  TEST_ASSERT_EQUAL_INT64(daily[0].sunrise, plan.dt);
+}
+
+static void test_icon_change()
+{
+  const wake_plan_t plan = planFrom(7, 5 * MINUTE, 12 * HOUR);
+  TEST_ASSERT_EQUAL(WAKE_EVENT_ICON, plan.event);
+  TEST_ASSERT_EQUAL_INT64(T0 + 9 * HOUR, plan.dt);
+}
+
+static void test_precip_onset_before_sunset()
+{
+  // the icon changes at the same hour, the rain takes precedence
+  const wake_plan_t plan = planFrom(12, 5 * MINUTE, 12 * HOUR);
+  TEST_ASSERT_EQUAL(WAKE_EVENT_PRECIP, plan.event);
+  TEST_ASSERT_EQUAL_INT64(T0 + 17 * HOUR, plan.dt);
+}
+
+static void test_temperature_drift()
+{
+  // 4.8°C now, 3.2°C at 01:00
+  const wake_plan_t plan = planFrom(21, 5 * MINUTE, 12 * HOUR);
+  TEST_ASSERT_EQUAL(WAKE_EVENT_TEMP, plan.event);
+  TEST_ASSERT_EQUAL_INT64(T0 + 25 * HOUR, plan.dt);
+}
+
+static void test_temperature_offset_from_current()
+{
+  // the current conditions may read 11.0°C at 12:10, 2.8°C above the hourly
+  // series. That stays within 0.6°C of the 8.2°C of 12:00 until the rain.
+  const wake_plan_t plan = planFrom(12, 5 * MINUTE, 12 * HOUR);
+  TEST_ASSERT_EQUAL(WAKE_EVENT_PRECIP, plan.event);
+  TEST_ASSERT_EQUAL_INT64(T0 + 17 * HOUR, plan.dt);
+}
+
+static void test_routine_wake_on_last_hour_in_range()
+{
+  wake_plan_t plan = planFrom(0, 5 * MINUTE, 3 * HOUR);
+  TEST_ASSERT_EQUAL(WAKE_EVENT_HOUR, plan.event);
+  TEST_ASSERT_EQUAL_INT64(T0 + 3 * HOUR, plan.dt);
+
+  plan = planFrom(0, 5 * MINUTE, 2 * HOUR + 30 * MINUTE);
+  TEST_ASSERT_EQUAL(WAKE_EVENT_HOUR, plan.event);
+  TEST_ASSERT_EQUAL_INT64(T0 + 2 * HOUR, plan.dt);
+}
+
+static void test_no_sooner_than_min()
+{
+  // the rain at 17:00 is shown by any wake, the sunset at 17:05 is next
+  const int64_t now = T0 + 16 * HOUR + 58 * MINUTE;
+  const wake_plan_t plan = planNextWake(HOURLY, daily, now, 5 * MINUTE,
+                                        12 * HOUR);
+  TEST_ASSERT_EQUAL(WAKE_EVENT_SUN, plan.event);
+  TEST_ASSERT_EQUAL_INT64(daily[0].sunset, plan.dt);
+}
+
+static void test_temperature_drift_before_min()
+{
+  // the drift at 01:00 is before the next wake at 02:10, the first hour after
+  // it is still 2.0°C from the 4.8°C shown at 21:10
+  const wake_plan_t plan = planFrom(21, 5 * HOUR, 12 * HOUR);
+  TEST_ASSERT_EQUAL(WAKE_EVENT_TEMP, plan.event);
+  TEST_ASSERT_EQUAL_INT64(T0 + 27 * HOUR, plan.dt);
+}
+
+static void test_no_later_than_max()
+{
+  // rain at 17:00 is beyond an hour from 12:10
+  const wake_plan_t plan = planFrom(12, 5 * MINUTE, HOUR);
+  TEST_ASSERT_EQUAL(WAKE_EVENT_HOUR, plan.event);
+  TEST_ASSERT_EQUAL_INT64(T0 + 13 * HOUR, plan.dt);
+}
+
+static void test_nothing_past_the_forecast()
+{
+  const wake_plan_t plan = planFrom(47, 5 * MINUTE, 3 * HOUR);
+  TEST_ASSERT_EQUAL(WAKE_EVENT_NONE, plan.event);
+  TEST_ASSERT_EQUAL_INT64(T0 + 47 * HOUR + 10 * MINUTE + 3 * HOUR, plan.dt);
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_sunrise_before_day_icon);
+  RUN_TEST(test_icon_change);
+  RUN_TEST(test_precip_onset_before_sunset);
+  RUN_TEST(test_temperature_drift);
+  RUN_TEST(test_temperature_offset_from_current);
+  RUN_TEST(test_routine_wake_on_last_hour_in_range);
+  RUN_TEST(test_no_sooner_than_min);
+  RUN_TEST(test_temperature_drift_before_min);
+  RUN_TEST(test_no_later_than_max);
+  RUN_TEST(test_nothing_past_the_forecast);
+  return UNITY_END();
+}